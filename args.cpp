@@ -9,19 +9,42 @@
 
 
 #include <iostream>
+#include <algorithm>
 #include <cstdlib>
 #include <cstddef>
 #include <cerrno>
+#include <thread>
+#include <string>
 #include <getopt.h>
 
 #include "args.h"
 
 
+// The long options without a short equivalent
+#define VERIFY_OPTION 256
+#define STATS_OPTION 257
+#define THUMBNAIL_OPTION 258
+#define PREVIEW_OPTION 259
+
+// The region of the update is given by its position and its size
+#define REGION_VALUE_COUNT 4
+
+
 void ArgParser::print_usage() {
     std::cout << "KKO - Project - Image data compression using Huffman encoding" << std::endl;
     std::cout << std::endl;
     std::cout << "Usage:" << std::endl;
-    std::cout << "  ./huff_codec [-c|-d] [-m] [-a] -i <ifile> -o <ofile> [-w <width_value>] [-h]" << std::endl;
+    std::cout << "  ./huff_codec [-c|-d] [-m] [-a|-s] [-k] [-L <level>] [-M] [-p] [--stats=json] -i <ifile> -o <ofile> [-w <width_value>] [-b <sample_bits>]" << std::endl;
+    std::cout << "               [-n <channel_count>] [-P] [-t <transform>] [--thumbnail=<scale>] [-F <frame_height>] [-e <max_error>] [-j <thread_count>] [-h]" << std::endl;
+    std::cout << "  ./huff_codec [-c|-d] [-m] [-a|-s] [-k] [-L <level>] -B <listfile> [-j <thread_count>] [-w <width_value>] [-b <sample_bits>]" << std::endl;
+    std::cout << "               [-n <channel_count>] [-P] [-t <transform>] [--thumbnail=<scale>] [-F <frame_height>] [-e <max_error>]" << std::endl;
+    std::cout << "  ./huff_codec --preview -i <ifile> -o <ofile>" << std::endl;
+    std::cout << "  ./huff_codec --verify -i <ifile> [-j <thread_count>]" << std::endl;
+    std::cout << "  ./huff_codec --verify -B <listfile> [-j <thread_count>]" << std::endl;
+    std::cout << "  ./huff_codec train [-m] [-a] [-T <table_count>] -o <dictfile> [-w <width_value>] [-b <sample_bits>] [-n <channel_count>]" << std::endl;
+    std::cout << "               [-P] [-t <transform>] <file>..." << std::endl;
+    std::cout << "  ./huff_codec update [-L <level>] -i <ifile> [-o <ofile>] -r <x>,<y>,<width>,<height> <regionfile>" << std::endl;
+    std::cout << "  (all the modes accept -D <dictfile>)" << std::endl;
     std::cout << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "  -c                  compress the input file (the default application mode)" << std::endl;
@@ -29,11 +52,75 @@ void ArgParser::print_usage() {
     std::cout << "  -m                  activate the model and the RLE for preprocessing the input data" << std::endl;
     std::cout << "  -a                  activate the adaptive image scanning mode (by default the sequential scanning" << std::endl;
     std::cout << "                      in the horizontal direction is used without dividing into blocks)" << std::endl;
+    std::cout << "                      (parameters -m and -a apply only to the compression, the decompression reads the mode" << std::endl;
+    std::cout << "                      from the header of the compressed data)" << std::endl;
+    std::cout << "  -s                  split the sequentially scanned data into the chunks of 1 MiB sharing one code table, so that" << std::endl;
+    std::cout << "                      the chunks are decompressed by more threads at the same time (parameter -j, at the cost of" << std::endl;
+    std::cout << "                      a few bytes per chunk, the model and the RLE restart in each chunk)" << std::endl;
+    std::cout << "  -k, --checksum      store the CRC32C checksums of the blocks (with the adaptive image scanning) and of the whole" << std::endl;
+    std::cout << "                      data to the compressed data, the decompression checks them" << std::endl;
+    std::cout << "  -L <level>          the effort level of the compression (" << MIN_EFFORT_LEVEL << " to " << MAX_EFFORT_LEVEL << ", by default " << DEFAULT_EFFORT_LEVEL << ") -- the low levels" << std::endl;
+    std::cout << "                      compress each block in a single pass, the higher levels try more scan directions, the" << std::endl;
+    std::cout << "                      blocks without the model or the RLE (with -m) and the reuse of the code tables of the" << std::endl;
+    std::cout << "                      preceding blocks (with -a, without -k); the decompression is equally fast for all levels" << std::endl;
+    std::cout << "  --verify            check the integrity of the compressed input file -- decompress it without writing any output" << std::endl;
+    std::cout << "                      and check its checksums (the parameter -o is not used), the chunks and the blocks with the" << std::endl;
+    std::cout << "                      checksums are checked by the number of threads given by the parameter -j" << std::endl;
+    std::cout << "  --thumbnail=<scale> store the thumbnail of the image compressed before its blocks (with -a) -- each pixel of the" << std::endl;
+    std::cout << "                      thumbnail is the mean of one block ('32', 1/32 scale) or of one 8x8 cell ('8', 1/8 scale)" << std::endl;
+    std::cout << "  --preview           decompress only the thumbnail stored in the compressed input file (without decoding the image)" << std::endl;
+    std::cout << "                      to the output file and print its width and scale" << std::endl;
+    std::cout << "  --stats=json        print the statistics of the compression or decompression to the standard output as JSON --" << std::endl;
+    std::cout << "                      the sizes, the total time, the time spent in the individual stages of the codec (the model" << std::endl;
+    std::cout << "                      of the 8-bit samples is fused with the RLE and timed as 'model_rle' instead of 'model' and" << std::endl;
+    std::cout << "                      'rle'), the scan direction and the table and payload sizes of the blocks (in the pipelined mode," << std::endl;
+    std::cout << "                      also the chunk and queue statistics; not used in the batch mode and the verification)" << std::endl;
+    std::cout << "  -M                  decompress straight to the memory-mapped output file instead of writing it at the end" << std::endl;
+    std::cout << "  -p                  activate the pipelined mode -- the data are processed in independent chunks (strips of whole" << std::endl;
+    std::cout << "                      image rows with the adaptive image scanning) while the input is read and the output is written" << std::endl;
+    std::cout << "                      by background threads (the pipelined compression output can be decompressed in both modes)" << std::endl;
+    std::cout << "  -F <frame_height>   compress the input file as a sequence of same-sized frames (e.g. of a fixed camera) stored one" << std::endl;
+    std::cout << "                      after another, each of which has frame_height rows (with -a, without -k and -p) -- each block" << std::endl;
+    std::cout << "                      is compressed either by itself or as its difference from the co-located block of the previous" << std::endl;
+    std::cout << "                      frame and the code tables are reused across the frames" << std::endl;
+    std::cout << "  -e <max_error>      activate the near-lossless compression -- each decompressed sample differs from the original one" << std::endl;
+    std::cout << "                      by at most max_error (0 for the lossless compression by default, up to " << MAX_SAMPLE_ERROR << "), the samples are" << std::endl;
+    std::cout << "                      quantized to the bins of 2 * max_error + 1 values before the model, so the compressed data" << std::endl;
+    std::cout << "                      are much smaller (the near-lossless data cannot be updated)" << std::endl;
     std::cout << "  -i <ifile>          the name of the input file (data to compress or decompress depending on the application mode)" << std::endl;
     std::cout << "  -o <ofile>          the name of the output file (the resulting compressed or decompressed data)" << std::endl;
+    std::cout << "  -B <listfile>       activate the batch mode -- compress or decompress all the files listed in the listfile, each line" << std::endl;
+    std::cout << "                      of which contains the name of an input file and the name of its output file (parameters -i" << std::endl;
+    std::cout << "                      and -o are not used), and print the aggregate throughput summary to the standard output" << std::endl;
+    std::cout << "                      (with --verify, each line contains only the name of a compressed file to be checked)" << std::endl;
+    std::cout << "  -j <thread_count>   the number of worker threads of the batch mode, of the verification and of the decompression" << std::endl;
+    std::cout << "                      of the chunks sharing one code table (thread_count >= 1), by default the number of hardware threads" << std::endl;
     std::cout << "  -w <width_value>    specify the image width (the width_value is expected to be grater than 0 -- width_value >= 1)," << std::endl;
     std::cout << "                      must be specified in case of the compression application mode with the adaptive image scanning" << std::endl;
     std::cout << "                      (parameters -ca)" << std::endl;
+    std::cout << "  -b <sample_bits>    specify the width of the stored image samples -- '" << MAX_BYTE_SAMPLE_BITS << "' (1 byte, by default) or '" << MAX_SAMPLE_BITS << "' (2 bytes" << std::endl;
+    std::cout << "                      in little endian, also for the samples of fewer bits, e.g. of 12-bit sensors), the image width" << std::endl;
+    std::cout << "                      is given in samples (used only by the compression, the decompression reads it from the header)" << std::endl;
+    std::cout << "  -n <channel_count>  specify the number of channels of the image (1 by default, up to " << MAX_CHANNEL_COUNT << ", e.g. 3 for RGB or 4 for RGBA)," << std::endl;
+    std::cout << "                      the channels are compressed separately by their own threads and the image width is given" << std::endl;
+    std::cout << "                      in pixels (used only by the compression, the decompression reads it from the header)" << std::endl;
+    std::cout << "  -P                  the channels are stored one after another (planar layout) instead of pixel by pixel (interleaved" << std::endl;
+    std::cout << "                      layout, the default), not supported by the pipelined mode" << std::endl;
+    std::cout << "  -t <transform>      the reversible color transform of the first three channels (R, G, B) applied before the" << std::endl;
+    std::cout << "                      compression -- 'none' (the default), 'green' (subtract green: R - G, G, B - G) or 'ycocg'" << std::endl;
+    std::cout << "                      (YCoCg-R), requires at least 3 channels" << std::endl;
+    std::cout << "  train               train the dictionary of the Huffman code tables on the listed files compressed in the mode given" << std::endl;
+    std::cout << "                      by the parameters -m, -a, -w, -b, -n, -P and -t and write it to the output file (parameter -o)" << std::endl;
+    std::cout << "  -T <table_count>    the maximum number of the trained code tables (1 to " << MAX_DICTIONARY_TABLE_COUNT << ", by default " << DEFAULT_DICTIONARY_TABLE_COUNT << ")" << std::endl;
+    std::cout << "  -D <dictfile>       use the dictionary of the code tables created by the train command -- the compression may" << std::endl;
+    std::cout << "                      encode the blocks by its tables instead of storing their own tables and the compressed data" << std::endl;
+    std::cout << "                      can be decompressed (or checked) only with the same dictionary" << std::endl;
+    std::cout << "  update              replace the region of the image compressed with the parameters -a and -k (with one channel" << std::endl;
+    std::cout << "                      and without -p) by the samples of the region file (row by row) -- only the blocks" << std::endl;
+    std::cout << "                      intersecting the region are re-encoded, the result is written to the output file" << std::endl;
+    std::cout << "                      (parameter -o) or back to the input file" << std::endl;
+    std::cout << "  -r <x>,<y>,<width>,<height>" << std::endl;
+    std::cout << "                      the position and the size of the updated region in samples (x, width) and rows (y, height)" << std::endl;
     std::cout << "  -h                  print the help to the standard output and exit" << std::endl;
 }
 
@@ -41,8 +128,27 @@ void ArgParser::print_usage() {
 bool ArgParser::parse_args(int argc, char *argv[]) {
     int opt;
     char *width_value_arg = NULL;
+    char *thread_count_arg = NULL;
+    char *effort_level_arg = NULL;
+    char *sample_bits_arg = NULL;
+    char *channel_count_arg = NULL;
+    char *color_transform_arg = NULL;
+    char *table_count_arg = NULL;
+    char *region_arg = NULL;
+    char *thumbnail_arg = NULL;
+    char *frame_height_arg = NULL;
+    char *max_error_arg = NULL;
+
+    const struct option long_options[] = {
+        {"checksum", no_argument, NULL, 'k'},
+        {"verify", no_argument, NULL, VERIFY_OPTION},
+        {"stats", required_argument, NULL, STATS_OPTION},
+        {"thumbnail", required_argument, NULL, THUMBNAIL_OPTION},
+        {"preview", no_argument, NULL, PREVIEW_OPTION},
+        {NULL, 0, NULL, 0}
+    };
 
-    while ((opt = getopt(argc, argv, "cdmai:o:w:h")) != -1) {
+    while ((opt = getopt_long(argc, argv, "cdmaksMpPi:o:B:j:w:L:b:n:t:D:T:r:F:e:h", long_options, NULL)) != -1) {
         switch (opt) {
             case 'c':
                 compress = true;
@@ -56,32 +162,320 @@ bool ArgParser::parse_args(int argc, char *argv[]) {
             case 'a':
                 adapt_scan = true;
                 break;
+            case 'k':
+                use_checksum = true;
+                break;
+            case 's':
+                use_static_chunks = true;
+                break;
+            case VERIFY_OPTION:
+                verify = true;
+                compress = false;
+                break;
+            case STATS_OPTION:
+                if (std::string(optarg) != "json") {
+                    std::cerr << "Invalid format of the statistics: '" << optarg << "' -- only 'json' is supported" << std::endl;
+                    return false;
+                }
+
+                print_stats = true;
+                break;
+            case THUMBNAIL_OPTION:
+                thumbnail_arg = optarg;
+                break;
+            case PREVIEW_OPTION:
+                preview = true;
+                compress = false;
+                break;
+            case 'M':
+                map_output = true;
+                break;
+            case 'p':
+                pipelined = true;
+                break;
             case 'i':
                 input_file = optarg;
                 break;
             case 'o':
                 output_file = optarg;
                 break;
+            case 'B':
+                batch_file = optarg;
+                break;
+            case 'j':
+                thread_count_arg = optarg;
+                break;
             case 'w':
                 width_value_arg = optarg;
                 break;
+            case 'L':
+                effort_level_arg = optarg;
+                break;
+            case 'b':
+                sample_bits_arg = optarg;
+                break;
+            case 'n':
+                channel_count_arg = optarg;
+                break;
+            case 'P':
+                is_planar = true;
+                break;
+            case 't':
+                color_transform_arg = optarg;
+                break;
+            case 'D':
+                dictionary_file = optarg;
+                break;
+            case 'T':
+                table_count_arg = optarg;
+                break;
+            case 'r':
+                region_arg = optarg;
+                break;
+            case 'F':
+                frame_height_arg = optarg;
+                break;
+            case 'e':
+                max_error_arg = optarg;
+                break;
             case 'h':
                 help = true;
                 return true;
         }
     }
 
-    if (input_file == NULL) {
-        std::cerr << "Missing input file" << std::endl;
+    // The operands (moved after the options) are the train command followed by the training files
+    if (optind < argc && std::string(argv[optind]) == "train") {
+        train = true;
+        training_files.assign(argv + optind + 1, argv + argc);
+
+        if (training_files.empty()) {
+            std::cerr << "Missing files to train the dictionary on" << std::endl;
+            return false;
+        }
+
+        if (output_file == NULL) {
+            std::cerr << "Missing output file for the dictionary" << std::endl;
+            return false;
+        }
+    }
+    else if (optind < argc && std::string(argv[optind]) == "update") {
+        update = true;
+
+        if (argc - optind != 2) {
+            std::cerr << "Exactly one region file is expected by the update" << std::endl;
+            return false;
+        }
+
+        region_file = argv[optind + 1];
+
+        if (input_file == NULL) {
+            std::cerr << "Missing input file" << std::endl;
+            return false;
+        }
+
+        if (region_arg == NULL) {
+            std::cerr << "Missing region parameter -r" << std::endl;
+            return false;
+        }
+
+        // The output file defaults to the updated input file
+        if (output_file == NULL) {
+            output_file = input_file;
+        }
+
+        std::uint64_t *region_values[REGION_VALUE_COUNT] = {&region_x, &region_y, &region_width, &region_height};
+        char *region_value_end = region_arg;
+        errno = 0;
+
+        for (std::uint8_t i = 0; i < REGION_VALUE_COUNT; i++) {
+            const char *region_value = i == 0 ? region_arg : region_value_end + 1;
+            *region_values[i] = std::strtoull(region_value, &region_value_end, 0);
+
+            if (region_value_end == region_value || *region_value_end != (i + 1 < REGION_VALUE_COUNT ? ',' : '\0') || errno == ERANGE) {
+                std::cerr << "Invalid value of the region parameter -r: '" << region_arg << "' -- four numbers <x>,<y>,<width>,<height> are expected" << std::endl;
+                return false;
+            }
+        }
+    }
+    else if (batch_file == NULL) {
+        if (input_file == NULL) {
+            std::cerr << "Missing input file" << std::endl;
+            return false;
+        }
+
+        if (output_file == NULL && !verify) {
+            std::cerr << "Missing output file" << std::endl;
+            return false;
+        }
+    }
+
+    if (thread_count_arg == NULL) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    else {
+        char *thread_count_end;
+        errno = 0;
+        const auto value = std::strtoul(thread_count_arg, &thread_count_end, 0);
+
+        if (*thread_count_end != '\0' || value < 1 || errno == ERANGE || value > UINT16_MAX) {
+            std::cerr << "Invalid value of the thread count parameter -j: '" << thread_count_arg << "' -- a number from 1 to " << UINT16_MAX << " is expected" << std::endl;
+            return false;
+        }
+
+        thread_count = value;
+    }
+
+    if (effort_level_arg != NULL) {
+        char *effort_level_end;
+        errno = 0;
+        const auto value = std::strtoul(effort_level_arg, &effort_level_end, 0);
+
+        if (*effort_level_end != '\0' || value < MIN_EFFORT_LEVEL || value > MAX_EFFORT_LEVEL || errno == ERANGE) {
+            std::cerr << "Invalid value of the effort level parameter -L: '" << effort_level_arg << "' -- a number from " << MIN_EFFORT_LEVEL << " to "
+                << MAX_EFFORT_LEVEL << " is expected" << std::endl;
+            return false;
+        }
+
+        effort_level = value;
+    }
+
+    // The samples are stored either in one byte or in two bytes, the narrower samples are stored in the wider ones
+    if (sample_bits_arg != NULL) {
+        const std::string sample_width = sample_bits_arg;
+
+        if (sample_width == std::to_string(MAX_BYTE_SAMPLE_BITS)) {
+            sample_bits = MAX_BYTE_SAMPLE_BITS;
+        }
+        else if (sample_width == std::to_string(MAX_SAMPLE_BITS)) {
+            sample_bits = MAX_SAMPLE_BITS;
+        }
+        else {
+            std::cerr << "Invalid value of the sample width parameter -b: '" << sample_bits_arg << "' -- '" << MAX_BYTE_SAMPLE_BITS << "' or '" << MAX_SAMPLE_BITS 
+                << "' is expected" << std::endl;
+            return false;
+        }
+    }
+
+    if (channel_count_arg != NULL) {
+        char *channel_count_end;
+        errno = 0;
+        const auto value = std::strtoul(channel_count_arg, &channel_count_end, 0);
+
+        if (*channel_count_end != '\0' || value < 1 || value > MAX_CHANNEL_COUNT || errno == ERANGE) {
+            std::cerr << "Invalid value of the channel count parameter -n: '" << channel_count_arg << "' -- a number from 1 to " << MAX_CHANNEL_COUNT 
+                << " is expected" << std::endl;
+            return false;
+        }
+
+        channel_count = value;
+    }
+
+    if (max_error_arg != NULL) {
+        char *max_error_end;
+        errno = 0;
+        const auto value = std::strtoul(max_error_arg, &max_error_end, 0);
+
+        if (*max_error_end != '\0' || value > MAX_SAMPLE_ERROR || errno == ERANGE) {
+            std::cerr << "Invalid value of the maximum error parameter -e: '" << max_error_arg << "' -- a number from 0 to " << MAX_SAMPLE_ERROR 
+                << " is expected" << std::endl;
+            return false;
+        }
+
+        max_error = value;
+    }
+
+    if (table_count_arg != NULL) {
+        char *table_count_end;
+        errno = 0;
+        const auto value = std::strtoul(table_count_arg, &table_count_end, 0);
+
+        if (*table_count_end != '\0' || value < 1 || value > MAX_DICTIONARY_TABLE_COUNT || errno == ERANGE) {
+            std::cerr << "Invalid value of the table count parameter -T: '" << table_count_arg << "' -- a number from 1 to " << MAX_DICTIONARY_TABLE_COUNT 
+                << " is expected" << std::endl;
+            return false;
+        }
+
+        table_count = value;
+    }
+
+    if (color_transform_arg != NULL) {
+        const std::string transform_name = color_transform_arg;
+
+        if (transform_name == "none") {
+            color_transform = COLOR_TRANSFORM_NONE;
+        }
+        else if (transform_name == "green") {
+            color_transform = COLOR_TRANSFORM_SUBTRACT_GREEN;
+        }
+        else if (transform_name == "ycocg") {
+            color_transform = COLOR_TRANSFORM_YCOCG_R;
+        }
+        else {
+            std::cerr << "Invalid color transform parameter -t: '" << color_transform_arg << "' -- 'none', 'green' or 'ycocg' is expected" << std::endl;
+            return false;
+        }
+
+        if (color_transform != COLOR_TRANSFORM_NONE && channel_count < COLOR_TRANSFORM_CHANNEL_COUNT) {
+            std::cerr << "The color transform (parameter -t) requires at least " << COLOR_TRANSFORM_CHANNEL_COUNT << " channels (parameter -n)" << std::endl;
+            return false;
+        }
+    }
+
+    if (thumbnail_arg != NULL) {
+        const std::string thumbnail_scale = thumbnail_arg;
+
+        if (thumbnail_scale == std::to_string(THUMBNAIL_BLOCK_CELL_SIDE)) {
+            thumbnail_cell_side = THUMBNAIL_BLOCK_CELL_SIDE;
+        }
+        else if (thumbnail_scale == std::to_string(THUMBNAIL_MOSAIC_CELL_SIDE)) {
+            thumbnail_cell_side = THUMBNAIL_MOSAIC_CELL_SIDE;
+        }
+        else {
+            std::cerr << "Invalid scale of the thumbnail: '" << thumbnail_arg << "' -- '" << THUMBNAIL_BLOCK_CELL_SIDE << "' or '" << THUMBNAIL_MOSAIC_CELL_SIDE 
+                << "' is expected" << std::endl;
+            return false;
+        }
+
+        if (!adapt_scan) {
+            std::cerr << "The thumbnail (parameter --thumbnail) requires the adaptive image scanning (parameter -a)" << std::endl;
+            return false;
+        }
+    }
+
+    if (frame_height_arg != NULL) {
+        char *frame_height_end;
+        errno = 0;
+        frame_height = std::strtoull(frame_height_arg, &frame_height_end, 0);
+
+        if (*frame_height_end != '\0' || frame_height < 1 || errno == ERANGE) {
+            std::cerr << "Invalid value of the frame height parameter -F: '" << frame_height_arg << "' -- a number greater than 0 is expected" << std::endl;
+            return false;
+        }
+
+        if (!adapt_scan || use_checksum || pipelined) {
+            std::cerr << "The sequence of frames (parameter -F) requires the adaptive image scanning (parameter -a) without the checksums (parameter -k)" 
+                << " and without the pipelined mode (parameter -p)" << std::endl;
+            return false;
+        }
+    }
+
+    if (use_static_chunks && adapt_scan) {
+        std::cerr << "The static chunks (parameter -s) cannot be combined with the adaptive image scanning (parameter -a)" << std::endl;
+        return false;
+    }
+
+    if (preview && (verify || batch_file != NULL)) {
+        std::cerr << "The preview (parameter --preview) cannot be combined with the verification or the batch mode" << std::endl;
         return false;
     }
 
-    if (output_file == NULL) {
-        std::cerr << "Missing output file" << std::endl;
+    if (compress && pipelined && is_planar && channel_count > 1) {
+        std::cerr << "The planar layout of the channels (parameter -P) is not supported by the pipelined mode (parameter -p)" << std::endl;
         return false;
     }
 
-    if (compress) {
+    if (compress || train) {
         if (width_value_arg == NULL) {
             if (adapt_scan) {
                 std::cerr << "For the compression with the adaptive image scanning (paramaters -ca), the image width (parameter -w) must be set" << std::endl;
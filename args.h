@@ -12,8 +12,14 @@
 #define ARGS_H
 
 
+#include <vector>
 #include <cstdint>
 
+#include "compress.h"
+#include "channels.h"
+#include "thumbnail.h"
+#include "dictionary.h"
+
 
 /**
  * @class Parser of the command line arguments
@@ -21,11 +27,38 @@
 class ArgParser {
     public:
         bool compress = true;           // Compression or decompression
+        bool train = false;             // Training of the dictionary of the code tables on the training files
+        bool update = false;            // Update of a region of the compressed image by the region file
         bool use_model = false;         // Model and RLE
         bool adapt_scan = false;        // Adaptive scanning
+        bool use_static_chunks = false; // Sequentially scanned data split into the chunks sharing one code table
+        bool use_checksum = false;      // CRC32C checksums of the blocks and of the whole data
+        bool verify = false;            // Integrity check of the compressed data without writing the output
+        bool preview = false;           // Decompression of the stored thumbnail only
+        bool print_stats = false;       // Statistics of the compression or decompression printed as JSON
+        bool map_output = false;        // Decompression straight to the memory-mapped output file
+        bool pipelined = false;         // Chunked processing with overlapped reading and writing
         char *input_file = NULL;
         char *output_file = NULL;
+        char *batch_file = NULL;        // List of input and output files processed in the batch mode
+        char *dictionary_file = NULL;   // Dictionary of the code tables shared by the compressed files
+        std::vector<char *> training_files;     // Files the dictionary is trained on
+        char *region_file = NULL;       // New samples of the updated region of the image
+        std::uint64_t region_x = 0;     // The position and the size of the updated region
+        std::uint64_t region_y = 0;
+        std::uint64_t region_width = 0;
+        std::uint64_t region_height = 0;
+        unsigned table_count = DEFAULT_DICTIONARY_TABLE_COUNT;  // The maximum number of the trained code tables
+        unsigned thread_count = 1;      // The number of worker threads in the batch mode, the verification and the decompression
+        unsigned effort_level = DEFAULT_EFFORT_LEVEL;  // The effort level of the encoder search
+        unsigned sample_bits = MAX_BYTE_SAMPLE_BITS;   // The width of the stored image samples (MAX_BYTE_SAMPLE_BITS or MAX_SAMPLE_BITS bits)
+        unsigned channel_count = 1;     // The number of channels of the image
+        bool is_planar = false;         // Planar (instead of interleaved) layout of the channels
+        unsigned color_transform = COLOR_TRANSFORM_NONE;   // The color transform of the channels
+        unsigned thumbnail_cell_side = 0;   // The side of the cells summarized by the stored thumbnail (0 if no thumbnail is stored)
         std::uint64_t width_value = 0;  // Image width  
+        std::uint64_t frame_height = 0; // The height of the frames of the image sequence (0 if the image is a single frame)
+        unsigned max_error = 0;         // The maximum absolute error of the decompressed samples (0 for the lossless compression)
         bool help = false;
 
         /**
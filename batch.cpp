@@ -0,0 +1,177 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Batch compression and decompression of many files by a pool of worker threads module
+ */
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "batch.h"
+#include "io.h"
+#include "huffcodec.h"
+
+
+/**
+ * @brief Load the pairs of input and output file names from the list file.
+ *
+ * @param list_filename The name of the list file
+ * @param has_output Indicates whether the output file names are expected (otherwise the lines contain only the input file names)
+ * @param jobs The resulting pairs of input and output file names
+ *
+ * @return True if the list file is successfully loaded, false otherwise.
+ */
+bool load_batch_list(const std::string &list_filename, const bool has_output, std::vector<std::pair<std::string, std::string>> &jobs) {
+    std::ifstream list_file(list_filename);
+
+    if (!list_file) {
+        std::cerr << "Cannot open the batch list file '" << list_filename << "'" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    std::uint64_t line_number = 0;
+
+    while (std::getline(list_file, line)) {
+        line_number++;
+        std::istringstream line_stream(line);
+        std::string input_filename, output_filename, rest;
+
+        if (!(line_stream >> input_filename)) {
+            // Skip empty lines
+            continue;
+        }
+
+        if ((has_output && !(line_stream >> output_filename)) || line_stream >> rest) {
+            std::cerr << "Invalid line " << line_number << " of the batch list file '" << list_filename << "' -- " 
+                << (has_output ? "an input and an output file name are expected" : "an input file name is expected") << std::endl;
+            return false;
+        }
+
+        jobs.emplace_back(input_filename, output_filename);
+    }
+
+    return true;
+}
+
+
+bool process_batch(
+    const std::string &list_filename,
+    const unsigned thread_count,
+    const bool compress,
+    const bool verify,
+    const unsigned mode,
+    const std::uint64_t width_value,
+    const std::uint64_t frame_height,
+    std::span<const std::uint8_t> dictionary_data,
+    BatchStats &stats
+) {
+    std::vector<std::pair<std::string, std::string>> jobs;
+
+    if (!load_batch_list(list_filename, !verify, jobs)) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<std::uint64_t> next_job = 0;
+    std::atomic<std::uint64_t> failed_file_count = 0;
+    std::atomic<std::uint64_t> input_size = 0;
+    std::atomic<std::uint64_t> output_size = 0;
+
+    // The contexts are prepared before the workers start, so that no file is left unprocessed (and uncounted) by a worker without its context
+    std::vector<std::unique_ptr<hc_context, decltype(&hc_context_destroy)>> contexts;
+    stats.file_count = jobs.size();
+
+    for (unsigned i = 0; i < thread_count; i++) {
+        contexts.emplace_back(hc_context_create(), hc_context_destroy);
+
+        if (!contexts.back()) {
+            std::cerr << "Cannot create the compression context" << std::endl;
+            stats.failed_file_count = jobs.size();
+            return false;
+        }
+
+        if (!dictionary_data.empty() && hc_context_load_dictionary(contexts.back().get(), dictionary_data.data(), dictionary_data.size()) != HC_OK) {
+            std::cerr << hc_context_error(contexts.back().get()) << std::endl;
+            stats.failed_file_count = jobs.size();
+            return false;
+        }
+    }
+
+    auto worker = [&](hc_context *context) {
+        // The context and the input buffer are kept for all the files processed by the worker so that their memory is allocated only once
+        std::vector<std::uint8_t> input_data;
+
+        for (std::uint64_t i = next_job++; i < jobs.size(); i = next_job++) {
+            const auto &[input_filename, output_filename] = jobs[i];
+            bool is_successful = read_bin_file(input_filename, input_data);
+            std::size_t output_data_size = 0;
+
+            if (is_successful) {
+                hc_status status;
+
+                if (compress) {
+                    status = hc_compress_frames(
+                        context, input_data.data(), input_data.size(), NULL, 0, &output_data_size, mode, width_value, frame_height
+                    );
+                }
+                else if (verify) {
+                    // The files are checked in parallel already, so each of them is checked by a single thread
+                    status = hc_verify(context, input_data.data(), input_data.size(), 1);
+                }
+                else {
+                    // The files are decompressed in parallel already, so each of them is decompressed by a single thread
+                    status = hc_decompress(context, input_data.data(), input_data.size(), NULL, 0, &output_data_size, 1);
+                }
+
+                if (status != HC_OK) {
+                    std::cerr << hc_context_error(context) << std::endl;
+                    is_successful = false;
+                }
+            }
+
+            if (is_successful && !verify) {
+                is_successful = write_bin_file(output_filename, std::span<const std::uint8_t>(hc_context_output(context, NULL), output_data_size));
+            }
+
+            if (is_successful) {
+                input_size += input_data.size();
+                output_size += output_data_size;
+            }
+            else {
+                std::cerr << "Cannot process the file '" << input_filename << "'" << std::endl;
+                failed_file_count++;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (unsigned i = 1; i < thread_count; i++) {
+        workers.emplace_back(worker, contexts[i].get());
+    }
+
+    // The current thread is one of the workers as well
+    worker(contexts[0].get());
+
+    for (auto &thread: workers) {
+        thread.join();
+    }
+
+    stats.failed_file_count = failed_file_count;
+    stats.input_size = input_size;
+    stats.output_size = output_size;
+    stats.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats.failed_file_count == 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Batch compression and decompression of many files by a pool of worker threads interface
+ */
+
+
+#ifndef BATCH_H
+#define BATCH_H
+
+
+#include <string>
+#include <span>
+#include <cstdint>
+
+
+/**
+ * @brief Aggregate statistics of the batch processing.
+ */
+struct BatchStats {
+    std::uint64_t file_count = 0;           // The number of files in the batch
+    std::uint64_t failed_file_count = 0;    // The number of files that could not be processed
+    std::uint64_t input_size = 0;           // The total size of the successfully processed input files
+    std::uint64_t output_size = 0;          // The total size of the resulting output files
+    double time = 0;                        // The wall-clock time (in seconds) of the whole batch
+};
+
+/**
+ * @brief Compress or decompress all the files listed in the list file using a pool of worker threads.
+ *
+ * @note Each non-empty line of the list file contains the name of the input file and the name of the output file separated by whitespace
+ * (only the name of the input file in case of the verification). The workers take the files one by one and reuse their input buffers
+ * and (de)compression contexts for all of them.
+ *
+ * @param list_filename The name of the list file
+ * @param thread_count The number of worker threads
+ * @param compress Compression or decompression
+ * @param verify Integrity check of the compressed files without writing any output (instead of the decompression)
+ * @param mode The mode flags of the compression or the decompression of each file (see huffcodec.h)
+ * @param width_value The width of data (2D image) in samples, used only for the compression with the adaptive scanning
+ * (the width is given in pixels for more channels)
+ * @param frame_height The height of the frames of the sequences of frames compressed by the compression (0 if the files are single images)
+ * @param dictionary_data The content of the dictionary file of the code tables loaded by the contexts of the workers (empty if there is none)
+ * @param stats The resulting statistics of the batch
+ *
+ * @return True if all the listed files are successfully processed, false otherwise.
+ */
+bool process_batch(
+    const std::string &list_filename,
+    const unsigned thread_count,
+    const bool compress,
+    const bool verify,
+    const unsigned mode,
+    const std::uint64_t width_value,
+    const std::uint64_t frame_height,
+    std::span<const std::uint8_t> dictionary_data,
+    BatchStats &stats
+);
+
+
+#endif
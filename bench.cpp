@@ -0,0 +1,428 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Microbenchmarks of the individual codec kernels
+ */
+
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <getopt.h>
+
+#include "io.h"
+#include "model.h"
+#include "rle.h"
+#include "huffman.h"
+#include "rans.h"
+#include "compress.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER
+#endif
+
+
+#define DEFAULT_REPETITION_COUNT 15
+#define SYNTHETIC_DATA_SIZE (1 << 20)
+#define SYNTHETIC_DATA_WIDTH 1024
+
+#define BLOCK_SIZE (BLOCK_SIDE_SIZE * BLOCK_SIDE_SIZE)
+
+
+/**
+ * @brief Benchmark input.
+ */
+struct BenchInput {
+    std::string name;                   // The name of the input (file name or the kind of the synthetic data)
+    std::vector<std::uint8_t> data;     // The data
+};
+
+
+/**
+ * @brief Prevent the compiler from optimizing away the computation of the value.
+ *
+ * @param value The value to be kept
+ */
+template<typename T>
+inline void keep_value(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+
+/**
+ * @brief Read the time stamp counter of the processor.
+ *
+ * @return The number of cycles (0 if the counter is not available).
+ */
+inline std::uint64_t read_cycle_counter() {
+#ifdef HAS_CYCLE_COUNTER
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+/**
+ * @brief Run the kernel repeatedly and print its median and best time per call and per byte, its throughput and its cycles per byte.
+ *
+ * @param kernel_name The name of the kernel
+ * @param input_name The name of the input
+ * @param byte_count The number of bytes processed by one call of the kernel
+ * @param repetition_count The number of the measured calls of the kernel
+ * @param kernel The kernel
+ */
+template<typename Kernel>
+void run_kernel(
+    const std::string &kernel_name,
+    const std::string &input_name,
+    const std::uint64_t byte_count,
+    const unsigned repetition_count,
+    Kernel kernel
+) {
+    std::vector<double> times(repetition_count);
+    std::vector<std::uint64_t> cycles(repetition_count);
+
+    // Warm up the caches and the branch predictors
+    kernel();
+
+    for (unsigned i = 0; i < repetition_count; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::uint64_t start_cycles = read_cycle_counter();
+        kernel();
+        cycles[i] = read_cycle_counter() - start_cycles;
+        times[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::sort(times.begin(), times.end());
+    std::sort(cycles.begin(), cycles.end());
+    const double median_time = times[repetition_count / 2];
+    const double bytes = std::max(byte_count, static_cast<std::uint64_t>(1));
+
+    std::cout << std::left << std::setw(26) << kernel_name << std::setw(16) << input_name << std::right
+        << std::setw(10) << byte_count
+        << std::fixed << std::setprecision(0) << std::setw(14) << median_time
+        << std::setprecision(3) << std::setw(10) << median_time / bytes
+        << std::setw(10) << times.front() / bytes
+        << std::setprecision(1) << std::setw(10) << bytes / median_time * 1e3
+        << std::setprecision(2) << std::setw(10) << cycles[repetition_count / 2] / bytes << std::endl;
+}
+
+
+/**
+ * @brief Generate the synthetic inputs covering the extreme and the typical cases.
+ *
+ * @return The synthetic inputs.
+ */
+std::vector<BenchInput> generate_synthetic_inputs() {
+    std::vector<BenchInput> inputs;
+    std::mt19937 generator(0);
+
+    inputs.push_back({"random", std::vector<std::uint8_t>(SYNTHETIC_DATA_SIZE)});
+
+    for (auto &val: inputs.back().data) {
+        val = generator();
+    }
+
+    inputs.push_back({"constant", std::vector<std::uint8_t>(SYNTHETIC_DATA_SIZE, 128)});
+    inputs.push_back({"gradient", std::vector<std::uint8_t>(SYNTHETIC_DATA_SIZE)});
+
+    // Smooth image with a little noise
+    for (std::uint64_t i = 0; i < SYNTHETIC_DATA_SIZE; i++) {
+        inputs.back().data[i] = (i % SYNTHETIC_DATA_WIDTH + i / SYNTHETIC_DATA_WIDTH) / 8 + generator() % 3;
+    }
+
+    inputs.push_back({"runs", std::vector<std::uint8_t>(SYNTHETIC_DATA_SIZE)});
+
+    // Long runs of a few values
+    for (std::uint64_t i = 0; i < SYNTHETIC_DATA_SIZE;) {
+        const std::uint64_t run_length = std::min(static_cast<std::uint64_t>(generator() % 512 + 1), SYNTHETIC_DATA_SIZE - i);
+        std::fill_n(inputs.back().data.begin() + i, run_length, generator() % 4 * 64);
+        i += run_length;
+    }
+
+    return inputs;
+}
+
+
+/**
+ * @brief Run all the kernel benchmarks on the input.
+ *
+ * @param input The input
+ * @param repetition_count The number of the measured calls of each kernel
+ */
+void bench_input(const BenchInput &input, const unsigned repetition_count) {
+    const std::vector<std::uint8_t> &data = input.data;
+    const std::uint64_t size = data.size();
+    const auto freqs = get_freqs(data);
+
+    run_kernel("get_freqs", input.name, size, repetition_count, [&]() {
+        keep_value(get_freqs(data));
+    });
+
+    // The code lengths are computed for the used symbols only (with the end-of-block symbol)
+    std::vector<std::uint64_t> used_symbol_freqs;
+
+    for (const auto &freq: freqs) {
+        if (freq > 0) {
+            used_symbol_freqs.push_back(freq);
+        }
+    }
+
+    used_symbol_freqs.push_back(1);
+
+    run_kernel("compute_code_bitlens", input.name, used_symbol_freqs.size(), repetition_count, [&]() {
+        keep_value(HuffmanEncoder::compute_code_bitlens(used_symbol_freqs));
+    });
+
+    HuffmanEncoder encoder;
+    std::vector<std::uint8_t> encoded_data;
+    encoded_data.reserve(size * 2 + 1024);
+
+    run_kernel("encode_symbol", input.name, size, repetition_count, [&]() {
+        encoded_data.clear();
+        encoder.initialize_encoding(freqs, encoded_data);
+
+        for (const auto &val: data) {
+            encoder.encode_symbol(val, encoded_data);
+        }
+
+        encoder.finalize_encoding(encoded_data);
+        keep_value(encoded_data);
+    });
+
+    run_kernel("encode_data", input.name, size, repetition_count, [&]() {
+        encoded_data.clear();
+        encoder.initialize_encoding(freqs, encoded_data);
+        encoder.encode_data(data, encoded_data);
+        encoder.finalize_encoding(encoded_data);
+        keep_value(encoded_data);
+    });
+
+    HuffmanDecoder decoder;
+    std::vector<std::uint8_t> decoded_data;
+    decoded_data.reserve(size);
+
+    run_kernel("decode_symbol", input.name, size, repetition_count, [&]() {
+        decoder.set_source(encoded_data);
+        decoder.initialize_decoding();
+        std::uint16_t symbol;
+        decoded_data.clear();
+
+        while (decoder.decode_symbol(symbol) && symbol != END_OF_BLOCK) {
+            decoded_data.push_back(symbol);
+        }
+
+        keep_value(decoded_data);
+    });
+
+    if (decoded_data != data) {
+        std::cerr << "decode_symbol: the decoded data differ from the input '" << input.name << "'" << std::endl;
+    }
+
+    run_kernel("decode_data_by_end_symbol", input.name, size, repetition_count, [&]() {
+        decoder.set_source(encoded_data);
+        decoder.initialize_decoding();
+        decoded_data.clear();
+        decoder.decode_data_by_end_symbol(decoded_data);
+        keep_value(decoded_data);
+    });
+
+    RansEncoder rans_encoder;
+    rans_encoder.initialize_encoding(freqs);
+
+    run_kernel("rans_encode_data", input.name, size, repetition_count, [&]() {
+        encoded_data.clear();
+        rans_encoder.encode_data(data, encoded_data);
+        keep_value(encoded_data);
+    });
+
+    RansDecoder rans_decoder;
+
+    run_kernel("rans_decode_data", input.name, size, repetition_count, [&]() {
+        rans_decoder.set_source(encoded_data);
+        rans_decoder.initialize_decoding();
+        rans_decoder.decode_data(decoded_data, size);
+        keep_value(decoded_data);
+    });
+
+    if (decoded_data != data) {
+        std::cerr << "rans_decode_data: the decoded data differ from the input '" << input.name << "'" << std::endl;
+    }
+
+    run_kernel("encode_adj_val_diff", input.name, size, repetition_count, [&]() {
+        keep_value(encode_adj_val_diff(data));
+    });
+
+    const auto diff_data = encode_adj_val_diff(data);
+
+    run_kernel("decode_adj_val_diff", input.name, size, repetition_count, [&]() {
+        keep_value(decode_adj_val_diff(diff_data));
+    });
+
+    // The RLE is measured on the output of the model the same way as it is used by the codec
+    run_kernel("encode_rle", input.name, size, repetition_count, [&]() {
+        keep_value(encode_rle(diff_data));
+    });
+
+    const auto rle_data = encode_rle(diff_data);
+
+    std::vector<std::uint8_t> decoded_rle_data;
+
+    run_kernel("decode_rle", input.name, size, repetition_count, [&]() {
+        decode_rle(rle_data, DEFAULT_MARKER, size, decoded_rle_data);
+        keep_value(decoded_rle_data);
+    });
+
+    // The block kernels process the data as a sequence of whole blocks
+    const std::uint64_t block_count = size / BLOCK_SIZE;
+
+    if (block_count == 0) {
+        return;
+    }
+
+    // The code tables are built for the histograms of the blocks of the output of the model the same way as by the adaptive scanning
+    std::vector<std::vector<std::uint64_t>> block_freqs;
+    std::vector<std::vector<std::uint64_t>> block_used_symbol_freqs;
+
+    for (std::uint64_t i = 0; i < block_count; i++) {
+        block_freqs.push_back(get_freqs(std::span<const std::uint8_t>(diff_data).subspan(i * BLOCK_SIZE, BLOCK_SIZE)));
+        block_used_symbol_freqs.emplace_back();
+
+        for (const auto &freq: block_freqs.back()) {
+            if (freq > 0) {
+                block_used_symbol_freqs.back().push_back(freq);
+            }
+        }
+
+        block_used_symbol_freqs.back().push_back(0);
+    }
+
+    run_kernel("block_code_bitlens", input.name, block_count * BLOCK_SIZE, repetition_count, [&]() {
+        for (const auto &used_freqs: block_used_symbol_freqs) {
+            keep_value(HuffmanEncoder::compute_code_bitlens(used_freqs));
+        }
+    });
+
+    run_kernel("block_get_encoded_size", input.name, block_count * BLOCK_SIZE, repetition_count, [&]() {
+        for (const auto &freqs_of_block: block_freqs) {
+            keep_value(encoder.get_encoded_size(freqs_of_block));
+        }
+    });
+
+    // The code tables of the blocks are stored one after another and rebuilt by the decoder
+    std::vector<std::uint8_t> block_codebooks;
+
+    run_kernel("block_initialize_encoding", input.name, block_count * BLOCK_SIZE, repetition_count, [&]() {
+        block_codebooks.clear();
+
+        for (const auto &freqs_of_block: block_freqs) {
+            encoder.initialize_encoding(freqs_of_block, block_codebooks);
+        }
+
+        keep_value(block_codebooks);
+    });
+
+    run_kernel("block_initialize_decoding", input.name, block_count * BLOCK_SIZE, repetition_count, [&]() {
+        decoder.set_source(block_codebooks);
+
+        for (std::uint64_t i = 0; i < block_count; i++) {
+            keep_value(decoder.initialize_decoding());
+        }
+    });
+
+    std::vector<std::uint8_t> block(BLOCK_SIZE);
+    std::vector<std::uint8_t> serialized_block(BLOCK_SIZE);
+
+    run_kernel("transpose_block_in_place", input.name, block_count * BLOCK_SIZE, repetition_count, [&]() {
+        for (std::uint64_t i = 0; i < block_count; i++) {
+            std::copy_n(data.begin() + i * BLOCK_SIZE, BLOCK_SIZE, block.begin());
+            transpose_block_in_place(block);
+            keep_value(block);
+        }
+    });
+
+    run_kernel("serialize_block", input.name, block_count * BLOCK_SIZE, repetition_count, [&]() {
+        for (std::uint64_t i = 0; i < block_count; i++) {
+            std::copy_n(data.begin() + i * BLOCK_SIZE, BLOCK_SIZE, block.begin());
+            serialize_block(block, i % 2 == 1, BLOCK_SIZE, BLOCK_SIDE_SIZE, BLOCK_SIDE_SIZE, serialized_block);
+            keep_value(serialized_block);
+        }
+    });
+
+    run_kernel("deserialize_block", input.name, block_count * BLOCK_SIZE, repetition_count, [&]() {
+        for (std::uint64_t i = 0; i < block_count; i++) {
+            std::copy_n(data.begin() + i * BLOCK_SIZE, BLOCK_SIZE, serialized_block.begin());
+            deserialize_block(serialized_block, i % 2 == 1, BLOCK_SIZE, BLOCK_SIDE_SIZE, BLOCK_SIDE_SIZE, block);
+            keep_value(block);
+        }
+    });
+}
+
+
+/**
+ * @brief Run the microbenchmarks of the codec kernels on the given files and on the synthetic inputs.
+ *
+ * @param argc The number of command line arguments
+ * @param argv Values of command line arguments ([-r <repetition_count>] [file...])
+ *
+ * @return 0 in case of success, 1 otherwise.
+ */
+int main(int argc, char *argv[]) {
+    unsigned repetition_count = DEFAULT_REPETITION_COUNT;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:")) != -1) {
+        if (opt != 'r' || std::atoi(optarg) < 1) {
+            std::cerr << "Usage: " << argv[0] << " [-r <repetition_count>] [file...]" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        repetition_count = std::atoi(optarg);
+    }
+
+    std::vector<BenchInput> inputs;
+
+    for (int i = optind; i < argc; i++) {
+        BenchInput input;
+        const std::string filename = argv[i];
+
+        if (!read_bin_file(filename, input.data)) {
+            return EXIT_FAILURE;
+        }
+
+        if (input.data.empty()) {
+            continue;
+        }
+
+        input.name = filename.substr(filename.find_last_of('/') + 1);
+        inputs.push_back(std::move(input));
+    }
+
+    for (auto &input: generate_synthetic_inputs()) {
+        inputs.push_back(std::move(input));
+    }
+
+    std::cout << "Repetitions: " << repetition_count << " (median and best of them)" << std::endl;
+#ifndef HAS_CYCLE_COUNTER
+    std::cout << "The cycle counter is not available, the cycles are reported as 0" << std::endl;
+#endif
+    std::cout << std::left << std::setw(26) << "kernel" << std::setw(16) << "input" << std::right
+        << std::setw(10) << "bytes" << std::setw(14) << "ns/call" << std::setw(10) << "ns/B" << std::setw(10) << "best ns/B"
+        << std::setw(10) << "MB/s" << std::setw(10) << "cycles/B" << std::endl;
+
+    for (const auto &input: inputs) {
+        bench_input(input, repetition_count);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Multi-channel image data (layout of the channels and reversible color transforms) module
+ */
+
+
+#include <array>
+#include <type_traits>
+
+#include "channels.h"
+#include "compress.h"
+
+
+/**
+ * @brief Load the sample stored in little endian.
+ *
+ * @param data The beginning of the stored sample
+ *
+ * @return The loaded sample.
+ */
+template<typename Sample>
+inline Sample load_sample(const std::uint8_t *data) {
+    if constexpr (sizeof(Sample) == 1) {
+        return *data;
+    }
+    else {
+        return data[0] | data[1] << 8;
+    }
+}
+
+
+/**
+ * @brief Store the sample in little endian.
+ *
+ * @param data The beginning of the place for the sample
+ * @param sample The sample to be stored
+ */
+template<typename Sample>
+inline void store_sample(std::uint8_t *data, const Sample sample) {
+    data[0] = sample;
+
+    if constexpr (sizeof(Sample) > 1) {
+        data[1] = sample >> 8;
+    }
+}
+
+
+/**
+ * @brief Halve the sample interpreted as a signed number (rounding down), as done by the lifting steps of YCoCg-R.
+ *
+ * @param sample The sample (a difference of samples modulo the range of the sample type)
+ *
+ * @return The halved sample.
+ */
+template<typename Sample>
+inline Sample halve_signed(const Sample sample) {
+    return static_cast<std::make_signed_t<Sample>>(sample) >> 1;
+}
+
+
+/**
+ * @brief Apply the color transform to the samples of one pixel.
+ *
+ * @param pixel The samples of the pixel (at least COLOR_TRANSFORM_CHANNEL_COUNT of them for the transforms other than COLOR_TRANSFORM_NONE)
+ * @param color_transform The color transform
+ */
+template<typename Sample>
+inline void transform_pixel(std::array<Sample, MAX_CHANNEL_COUNT> &pixel, const unsigned color_transform) {
+    const Sample red = pixel[0];
+    const Sample green = pixel[1];
+    const Sample blue = pixel[2];
+
+    if (color_transform == COLOR_TRANSFORM_SUBTRACT_GREEN) {
+        pixel[0] = red - green;
+        pixel[2] = blue - green;
+    }
+    else if (color_transform == COLOR_TRANSFORM_YCOCG_R) {
+        const Sample orange_chroma = red - blue;
+        const Sample temp = blue + halve_signed<Sample>(orange_chroma);
+        const Sample green_chroma = green - temp;
+        pixel[0] = temp + halve_signed<Sample>(green_chroma);
+        pixel[1] = orange_chroma;
+        pixel[2] = green_chroma;
+    }
+}
+
+
+/**
+ * @brief Apply the inverse color transform to the transformed samples of one pixel.
+ *
+ * @param pixel The transformed samples of the pixel
+ * @param color_transform The color transform
+ */
+template<typename Sample>
+inline void inverse_transform_pixel(std::array<Sample, MAX_CHANNEL_COUNT> &pixel, const unsigned color_transform) {
+    if (color_transform == COLOR_TRANSFORM_SUBTRACT_GREEN) {
+        pixel[0] += pixel[1];
+        pixel[2] += pixel[1];
+    }
+    else if (color_transform == COLOR_TRANSFORM_YCOCG_R) {
+        const Sample luma = pixel[0];
+        const Sample orange_chroma = pixel[1];
+        const Sample green_chroma = pixel[2];
+        const Sample temp = luma - halve_signed<Sample>(green_chroma);
+        const Sample blue = temp - halve_signed<Sample>(orange_chroma);
+        pixel[0] = blue + orange_chroma;
+        pixel[1] = green_chroma + temp;
+        pixel[2] = blue;
+    }
+}
+
+
+/**
+ * @brief Split the multi-channel data of the given sample type into the transformed planes of the individual channels.
+ *
+ * @param data The multi-channel data
+ * @param channel_count The number of channels
+ * @param is_planar Indicates whether the channels are stored one after another
+ * @param color_transform The color transform
+ * @param planes The resulting planes of the transformed channels
+ */
+template<typename Sample>
+void split_sample_channels(
+    std::span<const std::uint8_t> data,
+    const unsigned channel_count,
+    const bool is_planar,
+    const unsigned color_transform,
+    std::vector<std::vector<std::uint8_t>> &planes
+) {
+    const std::uint64_t plane_size = data.size() / channel_count;
+    const std::uint64_t pixel_count = plane_size / sizeof(Sample);
+    // The distance of the samples of the neighbouring pixels and of the neighbouring channels of one pixel
+    const std::uint64_t pixel_stride = is_planar ? sizeof(Sample) : channel_count * sizeof(Sample);
+    const std::uint64_t channel_stride = is_planar ? plane_size : sizeof(Sample);
+    std::array<Sample, MAX_CHANNEL_COUNT> pixel = {};
+
+    planes.resize(channel_count);
+
+    for (auto &plane: planes) {
+        plane.resize(plane_size);
+    }
+
+    for (std::uint64_t i = 0; i < pixel_count; i++) {
+        const std::uint8_t *pixel_data = data.data() + i * pixel_stride;
+
+        for (unsigned j = 0; j < channel_count; j++) {
+            pixel[j] = load_sample<Sample>(pixel_data + j * channel_stride);
+        }
+
+        transform_pixel(pixel, color_transform);
+
+        for (unsigned j = 0; j < channel_count; j++) {
+            store_sample(planes[j].data() + i * sizeof(Sample), pixel[j]);
+        }
+    }
+}
+
+
+/**
+ * @brief Merge the transformed planes of the individual channels into the multi-channel data of the given sample type.
+ *
+ * @param planes The planes of the transformed channels
+ * @param is_planar Indicates whether the channels are stored one after another
+ * @param color_transform The color transform
+ * @param data The memory for the resulting multi-channel data
+ */
+template<typename Sample>
+void merge_sample_channels(
+    const std::vector<std::vector<std::uint8_t>> &planes,
+    const bool is_planar,
+    const unsigned color_transform,
+    std::span<std::uint8_t> data
+) {
+    const std::uint64_t channel_count = planes.size();
+    const std::uint64_t plane_size = data.size() / channel_count;
+    const std::uint64_t pixel_count = plane_size / sizeof(Sample);
+    const std::uint64_t pixel_stride = is_planar ? sizeof(Sample) : channel_count * sizeof(Sample);
+    const std::uint64_t channel_stride = is_planar ? plane_size : sizeof(Sample);
+    std::array<Sample, MAX_CHANNEL_COUNT> pixel = {};
+
+    for (std::uint64_t i = 0; i < pixel_count; i++) {
+        for (unsigned j = 0; j < channel_count; j++) {
+            pixel[j] = load_sample<Sample>(planes[j].data() + i * sizeof(Sample));
+        }
+
+        inverse_transform_pixel(pixel, color_transform);
+
+        std::uint8_t *pixel_data = data.data() + i * pixel_stride;
+
+        for (unsigned j = 0; j < channel_count; j++) {
+            store_sample(pixel_data + j * channel_stride, pixel[j]);
+        }
+    }
+}
+
+
+void split_channels(
+    std::span<const std::uint8_t> data,
+    const unsigned sample_bits,
+    const unsigned channel_count,
+    const bool is_planar,
+    const unsigned color_transform,
+    std::vector<std::vector<std::uint8_t>> &planes
+) {
+    if (sample_bits > MAX_BYTE_SAMPLE_BITS) {
+        split_sample_channels<std::uint16_t>(data, channel_count, is_planar, color_transform, planes);
+    }
+    else {
+        split_sample_channels<std::uint8_t>(data, channel_count, is_planar, color_transform, planes);
+    }
+}
+
+
+void merge_channels(
+    const std::vector<std::vector<std::uint8_t>> &planes,
+    const unsigned sample_bits,
+    const bool is_planar,
+    const unsigned color_transform,
+    std::span<std::uint8_t> data
+) {
+    if (sample_bits > MAX_BYTE_SAMPLE_BITS) {
+        merge_sample_channels<std::uint16_t>(planes, is_planar, color_transform, data);
+    }
+    else {
+        merge_sample_channels<std::uint8_t>(planes, is_planar, color_transform, data);
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Multi-channel image data (layout of the channels and reversible color transforms) interface
+ */
+
+
+#ifndef CHANNELS_H
+#define CHANNELS_H
+
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+
+// The maximum number of channels of the image (e.g. RGBA)
+#define MAX_CHANNEL_COUNT 4
+
+// Reversible color transforms of the first three channels (R, G and B), the other channels are kept as they are
+#define COLOR_TRANSFORM_NONE 0
+#define COLOR_TRANSFORM_SUBTRACT_GREEN 1   // R - G, G, B - G
+#define COLOR_TRANSFORM_YCOCG_R 2          // Y, Co, Cg by the lifting steps of YCoCg-R
+#define COLOR_TRANSFORM_COUNT 3
+
+// The minimum number of channels the color transforms can be applied to
+#define COLOR_TRANSFORM_CHANNEL_COUNT 3
+
+
+/**
+ * @brief Split the multi-channel data into the planes of the individual channels and apply the color transform to them.
+ *
+ * @note The transforms work modulo 2^8 (or 2^16 for the 16-bit samples), so the transformed samples have the same width as the original ones.
+ *
+ * @param data The multi-channel data (their size has to be a multiple of the size of one pixel)
+ * @param sample_bits The width of the samples (in bits)
+ * @param channel_count The number of channels
+ * @param is_planar Indicates whether the channels are stored one after another (planar layout) instead of pixel by pixel (interleaved layout)
+ * @param color_transform The color transform (COLOR_TRANSFORM_NONE for the data of less than COLOR_TRANSFORM_CHANNEL_COUNT channels)
+ * @param planes The resulting planes of the transformed channels (each of them of the same size)
+ */
+void split_channels(
+    std::span<const std::uint8_t> data,
+    const unsigned sample_bits,
+    const unsigned channel_count,
+    const bool is_planar,
+    const unsigned color_transform,
+    std::vector<std::vector<std::uint8_t>> &planes
+);
+
+/**
+ * @brief Apply the inverse color transform to the planes of the individual channels and merge them into the multi-channel data.
+ *
+ * @param planes The planes of the transformed channels (each of them of the same size)
+ * @param sample_bits The width of the samples (in bits)
+ * @param is_planar Indicates whether the channels are stored one after another (planar layout) instead of pixel by pixel (interleaved layout)
+ * @param color_transform The color transform applied by split_channels
+ * @param data The memory for the resulting multi-channel data (of the total size of the planes)
+ */
+void merge_channels(
+    const std::vector<std::vector<std::uint8_t>> &planes,
+    const unsigned sample_bits,
+    const bool is_planar,
+    const unsigned color_transform,
+    std::span<std::uint8_t> data
+);
+
+
+#endif
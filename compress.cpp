@@ -9,486 +9,3594 @@
 
 
 #include <utility>
-#include <iostream>
 #include <iterator>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <algorithm>
+#include <array>
+#include <new>
+#include <type_traits>
 
 #include "compress.h"
+#include "channels.h"
+#include "thumbnail.h"
 #include "model.h"
 #include "rle.h"
 #include "huffman.h"
+#include "dictionary.h"
+#include "rans.h"
+#include "header.h"
+#include "crc.h"
+#include "stats.h"
+#include "error.h"
 
 
+// The compression flag of a block selects the entropy coder of its data
 #define COMPRESSED 1
-#define UNCOMPRESSED 0
+#define UNCOMPRESSED 0              // The raw samples of the data block follow the flag
+#define RANS_COMPRESSED 2
+#define REUSED_TABLE_COMPRESSED 3   // Huffman encoded by the code table of the preceding Huffman encoded block with its own table
+#define DICTIONARY_COMPRESSED 4     // Huffman encoded by the code table of the dictionary whose index follows the flag
+#define SHARED_TABLE_CHUNKS_COMPRESSED 5    // Statically scanned data split into independently compressed chunks sharing the code table following the flag
+#define SOLID_COMPRESSED 6          // All the samples of the data block equal the single sample following the flag
+
+// Each adaptively scanned block starts with its mode, i.e. the scan direction and the preprocessing disabled for the block
+#define HORIZONTAL_SCAN 0x01
+#define VERTICAL_SCAN 0x00
+#define BLOCK_WITHOUT_MODEL 0x02
+#define BLOCK_WITHOUT_RLE 0x04
+#define BLOCK_TEMPORAL 0x08     // The block of the sequence of frames is the difference from the co-located block of the previous frame
+#define BLOCK_MODE_MASK (HORIZONTAL_SCAN | BLOCK_WITHOUT_MODEL | BLOCK_WITHOUT_RLE | BLOCK_TEMPORAL)
 
-#define HORIZONTAL_SCAN 1
-#define VERTICAL_SCAN 0
-
-#define BLOCK_SIDE_SIZE 32
 #define BLOCK_SIZE (BLOCK_SIDE_SIZE * BLOCK_SIDE_SIZE)
 
-#define BYTE_BIT_LENGTH 8
+// With the checksums, each block is preceded by its size (including its mode) and its CRC32C checksum
+#define BLOCK_SIZE_BYTE_COUNT 2
+#define BLOCK_RECORD_SIZE (BLOCK_SIZE_BYTE_COUNT + CRC_BYTE_COUNT)
+
+// Each block of the adaptively scanned data takes at least its mode and its compression flag
+#define MIN_COMPRESSED_BLOCK_SIZE 2
+
+
+/**
+ * @brief Block of the adaptively scanned compressed data stored with its checksum.
+ */
+struct BlockRecord {
+    std::span<const std::uint8_t> data; // The mode and the compressed block
+    std::uint32_t checksum;             // The stored checksum of the data
+};
+
+/**
+ * @brief Statically scanned data split into the chunks sharing the code table.
+ */
+struct SharedTableChunks {
+    std::uint64_t chunk_val_count = 0;                  // The number of the samples of each chunk (but the last one)
+    HuffmanDecoder shared_decoder;                      // The decoder with the shared code table
+    std::vector<std::span<const std::uint8_t>> chunks;  // The compressed chunks
+};
+
+/**
+ * @brief Search of the encoder for the smallest compressed blocks.
+ */
+struct SearchParams {
+    bool try_rans;                          // The rANS coder is considered
+    bool encode_rans_exactly;               // The rANS encoding is tried even if its estimated size is not the smallest
+    std::uint8_t vertical_scan_min_ratio;   // The vertical scan is tried only if the horizontally scanned block takes more than this percentage of the uncompressed block
+    bool search_preprocessing;              // The blocks are compressed also without the model and without the RLE
+    bool reuse_tables;                      // The blocks may be encoded by the Huffman code table of the preceding block
+    std::uint8_t spatial_min_ratio;         // The block of frames is compressed also without the temporal prediction only if the predicted block takes more than this percentage of the uncompressed block
+};
+
+
+// The search of the individual effort levels (from the lowest)
+constexpr SearchParams SEARCH_PARAMS[MAX_EFFORT_LEVEL - MIN_EFFORT_LEVEL + 1] = {
+    {false, false, 100, false, false, 25}, 
+    {true, false, 100, false, false, 25}, 
+    {true, false, 50, false, false, 25}, 
+    {true, false, 25, false, false, 10}, 
+    {true, false, 10, false, false, 10}, 
+    {true, false, 0, false, false, 10}, 
+    {true, false, 0, true, false, 5}, 
+    {true, false, 0, true, true, 5}, 
+    {true, true, 0, true, true, 0}
+};
+
+
+/**
+ * @brief Get the search of the encoder for the effort level.
+ * 
+ * @param effort_level The effort level (the nearest valid one is used for an invalid one)
+ * 
+ * @return The search of the encoder.
+ */
+const SearchParams &get_search_params(const unsigned effort_level) {
+    return SEARCH_PARAMS[std::clamp(effort_level, static_cast<unsigned>(MIN_EFFORT_LEVEL), static_cast<unsigned>(MAX_EFFORT_LEVEL)) - MIN_EFFORT_LEVEL];
+}
+
+
+/**
+ * @brief Call the function with the sample type of the samples of the given width.
+ * 
+ * @param sample_bits The width of the samples (in bits)
+ * @param function Generic function called with a value of the sample type (std::uint8_t or std::uint16_t)
+ * 
+ * @return The value returned by the function.
+ */
+template<typename Function>
+auto with_sample_type(const unsigned sample_bits, Function function) {
+    if (sample_bits > MAX_BYTE_SAMPLE_BITS) {
+        return function(std::uint16_t());
+    }
+
+    return function(std::uint8_t());
+}
+
+
+/**
+ * @brief Load the samples stored in the data (the 16-bit samples in little endian).
+ * 
+ * @param data The stored samples
+ * @param samples The resulting samples
+ */
+void load_samples(std::span<const std::uint8_t> data, std::vector<std::uint8_t> &samples) {
+    samples.assign(data.begin(), data.end());
+}
+
+
+void load_samples(std::span<const std::uint8_t> data, std::vector<std::uint16_t> &samples) {
+    samples.resize(data.size() / 2);
+
+    for (std::uint64_t i = 0; i < samples.size(); i++) {
+        samples[i] = data[2 * i] | data[2 * i + 1] << 8;
+    }
+}
+
+
+/**
+ * @brief Append the stored samples to the data (the 16-bit samples in little endian).
+ * 
+ * @param data Buffer to which the stored samples are appended
+ * @param samples The samples to be stored
+ */
+void append_samples(std::vector<std::uint8_t> &data, std::span<const std::uint8_t> samples) {
+    data.insert(data.end(), samples.begin(), samples.end());
+}
+
+
+void append_samples(std::vector<std::uint8_t> &data, std::span<const std::uint16_t> samples) {
+    for (const std::uint16_t sample: samples) {
+        data.push_back(sample);
+        data.push_back(sample >> 8);
+    }
+}
+
+
+/**
+ * @brief Store the sample to its position in the data (the 16-bit samples in little endian).
+ * 
+ * @param data The data
+ * @param index The index of the sample
+ * @param sample The sample to be stored
+ */
+inline void store_sample(std::span<std::uint8_t> data, const std::uint64_t index, const std::uint8_t sample) {
+    data[index] = sample;
+}
+
+
+inline void store_sample(std::span<std::uint8_t> data, const std::uint64_t index, const std::uint16_t sample) {
+    data[2 * index] = sample;
+    data[2 * index + 1] = sample >> 8;
+}
+
+
+/**
+ * @brief Store the samples to their positions in the data (the 16-bit samples in little endian).
+ * 
+ * @param data The data
+ * @param index The index of the first sample
+ * @param samples The samples to be stored
+ */
+void store_samples(std::span<std::uint8_t> data, const std::uint64_t index, std::span<const std::uint8_t> samples) {
+    std::copy(samples.begin(), samples.end(), data.begin() + index);
+}
+
+
+void store_samples(std::span<std::uint8_t> data, const std::uint64_t index, std::span<const std::uint16_t> samples) {
+    for (std::uint64_t i = 0; i < samples.size(); i++) {
+        store_sample(data, index + i, samples[i]);
+    }
+}
+
+
+/**
+ * @brief Load the sample from its position in the data (the 16-bit samples in little endian).
+ * 
+ * @param data The data
+ * @param index The index of the sample
+ * 
+ * @return The sample.
+ */
+template<typename Sample>
+inline Sample load_sample(std::span<const std::uint8_t> data, const std::uint64_t index) {
+    if constexpr (sizeof(Sample) == 1) {
+        return data[index];
+    }
+    else {
+        return data[2 * index] | data[2 * index + 1] << 8;
+    }
+}
+
+
+/**
+ * @brief Quantize the samples to the bins of 2 * max_error + 1 values, so that each sample is reconstructed by the center of its bin
+ * with the error of at most max_error.
+ *
+ * @param data The samples to be quantized (the 16-bit samples in little endian)
+ * @param max_error The maximum absolute error of the reconstructed samples (greater than 0)
+ * @param quantized_data The resulting indices of the bins of the samples (stored in the same way as the samples)
+ *
+ * @return The maximum sample of the data, so that the reconstructed samples do not exceed the range of the original ones.
+ */
+template<typename Sample>
+Sample quantize_samples(std::span<const std::uint8_t> data, const unsigned max_error, std::vector<std::uint8_t> &quantized_data) {
+    const std::uint64_t sample_count = data.size() / sizeof(Sample);
+    const unsigned bin_size = 2 * max_error + 1;
+    Sample max_sample = 0;
+    quantized_data.resize(data.size());
+
+    for (std::uint64_t i = 0; i < sample_count; i++) {
+        const Sample sample = load_sample<Sample>(data, i);
+        max_sample = std::max(max_sample, sample);
+        store_sample(quantized_data, i, static_cast<Sample>(sample / bin_size));
+    }
+
+    return max_sample;
+}
+
+
+/**
+ * @brief Reconstruct the quantized samples in place by the centers of their bins.
+ *
+ * @note The corrupted indices of the bins give valid samples as well, since the reconstructed samples are clamped.
+ *
+ * @param data The indices of the bins of the samples to be replaced by the reconstructed samples (the 16-bit samples in little endian)
+ * @param max_error The maximum absolute error of the reconstructed samples (greater than 0)
+ * @param max_sample The maximum sample of the original data
+ */
+template<typename Sample>
+void dequantize_samples(std::span<std::uint8_t> data, const unsigned max_error, const Sample max_sample) {
+    const std::uint64_t sample_count = data.size() / sizeof(Sample);
+    const std::uint32_t bin_size = 2 * max_error + 1;
+
+    // The byte samples are looked up in the table of all their reconstructions
+    if constexpr (sizeof(Sample) == 1) {
+        std::array<std::uint8_t, 1 << MAX_BYTE_SAMPLE_BITS> reconstructed_samples;
+
+        for (std::uint32_t i = 0; i < reconstructed_samples.size(); i++) {
+            reconstructed_samples[i] = std::min(i * bin_size + max_error, static_cast<std::uint32_t>(max_sample));
+        }
+
+        for (auto &value: data) {
+            value = reconstructed_samples[value];
+        }
+    }
+    else {
+        for (std::uint64_t i = 0; i < sample_count; i++) {
+            const std::uint32_t sample = load_sample<Sample>(data, i) * bin_size + max_error;
+            store_sample(data, i, static_cast<Sample>(std::min(sample, static_cast<std::uint32_t>(max_sample))));
+        }
+    }
+}
+
+
+/**
+ * @brief Copy the encoders with the code tables of the dictionary, so that they can be used by one compression.
+ * 
+ * @param dictionary The dictionary (NULL if no dictionary is used)
+ * 
+ * @return The encoders indexed by the table IDs (empty if no dictionary is used).
+ */
+std::vector<HuffmanEncoder> copy_dictionary_encoders(const HuffmanDictionary *dictionary) {
+    return dictionary == NULL ? std::vector<HuffmanEncoder>() : dictionary->get_encoders();
+}
+
+
+/**
+ * @brief Copy the decoders with the code tables of the dictionary, so that they can be used by one decompression.
+ * 
+ * @param dictionary The dictionary (NULL if no dictionary is used)
+ * 
+ * @return The decoders indexed by the table IDs (empty if no dictionary is used).
+ */
+std::vector<HuffmanDecoder> copy_dictionary_decoders(const HuffmanDictionary *dictionary) {
+    return dictionary == NULL ? std::vector<HuffmanDecoder>() : dictionary->get_decoders();
+}
+
+
+/**
+ * @brief Call the function with the preprocessing fixed at compile time, so that each combination of the stages is compiled separately.
+ * 
+ * @param use_model Indicates whether the adjacent value difference model is used
+ * @param use_rle Indicates whether the RLE is used
+ * @param function Generic function called with std::bool_constant values of use_model and use_rle
+ * 
+ * @return The value returned by the function.
+ */
+template<typename Function>
+auto with_preprocessing(const bool use_model, const bool use_rle, Function function) {
+    if (use_model) {
+        return use_rle ? function(std::true_type(), std::true_type()) : function(std::true_type(), std::false_type());
+    }
+
+    return use_rle ? function(std::false_type(), std::true_type()) : function(std::false_type(), std::false_type());
+}
+
+
+/**
+ * @brief Preprocess the data block to the symbols encoded by the entropy coders.
+ * 
+ * @note The 16-bit samples are always packed into bytes, by the high byte escape scheme after the model transformation or as the pairs
+ * of their bytes without it, so both the coders work with the byte alphabet for all the sample widths. The stages are selected by UseModel and UseRle at compile time
+ * and the model of the 8-bit samples is fused with the RLE, i.e. the differences are encoded by the RLE as they are computed
+ * (the fused stage is timed as STAGE_MODEL_RLE).
+ * 
+ * @param data The data block to be preprocessed
+ * @param preprocessed_data Buffer for the preprocessed data
+ * 
+ * @return The symbols to be encoded (the data block itself if it is not preprocessed at all).
+ */
+template<typename Sample, bool UseModel, bool UseRle>
+std::span<const std::uint8_t> preprocess(std::span<const Sample> data, std::vector<std::uint8_t> &preprocessed_data) {
+    if constexpr (sizeof(Sample) == 1 && UseRle) {
+        using ModelTransform = std::conditional_t<UseModel, AdjValDiffEncoder, IdentityTransform>;
+        preprocessed_data = STATS_MEASURE(UseModel ? STAGE_MODEL_RLE : STAGE_RLE, encode_rle(data, DEFAULT_MARKER, ModelTransform()));
+        return preprocessed_data;
+    }
+    else if constexpr (sizeof(Sample) == 1) {
+        if constexpr (!UseModel) {
+            return data;
+        }
+
+        preprocessed_data = STATS_MEASURE(STAGE_MODEL, encode_adj_val_diff(data));
+        return preprocessed_data;
+    }
+    else {
+        if constexpr (UseModel) {
+            preprocessed_data = STATS_MEASURE(STAGE_MODEL, encode_adj_val_diff(data));
+        }
+        else {
+            preprocessed_data = STATS_MEASURE(STAGE_MODEL, pack_samples(data));
+        }
+
+        if constexpr (UseRle) {
+            preprocessed_data = STATS_MEASURE(STAGE_RLE, encode_rle(preprocessed_data, DEFAULT_MARKER));
+        }
+
+        return preprocessed_data;
+    }
+}
+
+
+/**
+ * @brief Preprocess the data block by its instantiation for the given stages.
+ * 
+ * @param data The data block to be preprocessed
+ * @param use_model Indicates whether the adjacent value difference model should be used for data block preprocessing
+ * @param use_rle Indicates whether the RLE should be used for data block preprocessing
+ * @param preprocessed_data Buffer for the preprocessed data
+ * 
+ * @return The symbols to be encoded (the data block itself if it is not preprocessed at all).
+ */
+template<typename Sample>
+std::span<const std::uint8_t> preprocess(std::span<const Sample> data, const bool use_model, const bool use_rle, std::vector<std::uint8_t> &preprocessed_data) {
+    return with_preprocessing(use_model, use_rle, [&](auto model_stage, auto rle_stage) {
+        return preprocess<Sample, decltype(model_stage)::value, decltype(rle_stage)::value>(data, preprocessed_data);
+    });
+}
 
 
 /**
- * @brief Compress the data block using canonical Huffman encoding.
+ * @brief Compress the data block using canonical Huffman encoding or interleaved rANS, whichever gives the smaller block.
+ * 
+ * @note The exact size of the Huffman encoded block is computed from the histogram before encoding it and the size of the rANS encoded block is estimated
+ * from the quantized frequencies, so the data block is encoded only by the coder whose block is expected to be the smallest. If neither of them
+ * can achieve compression, the data block is stored uncompressed without encoding it at all. The constant data block is stored as its single sample
+ * without any preprocessing.
  * 
  * @param data The data block to be compressed
  * @param huffman_encoder The canonical Huffman code encoder
- * @param compressed_data The resulting compressed data block
+ * @param compressed_data Buffer to which the resulting compressed data block is appended
  * @param use_model Indicates whether the adjacent value difference model should be used for data block preprocessing
  * @param use_rle Indicates whether the RLE should be used for data block preprocessing
+ * @param search_params The search of the encoder
+ * @param reused_table_encoder The encoder with the code table that can be reused by the data block (NULL if there is none)
+ * @param dictionary_encoders The encoders with the code tables of the dictionary (empty if no dictionary is used)
  */
+template<typename Sample>
 void compress(
-    const std::vector<std::uint8_t> &data, 
+    std::span<const Sample> data, 
     HuffmanEncoder &huffman_encoder, 
     std::vector<std::uint8_t> &compressed_data, 
     const bool use_model, 
-    const bool use_rle
+    const bool use_rle, 
+    const SearchParams &search_params, 
+    HuffmanEncoder *reused_table_encoder, 
+    std::span<HuffmanEncoder> dictionary_encoders
 ) {
-    compressed_data.push_back(COMPRESSED);
+    // The compressed data block is appended to the data compressed so far
+    const std::uint64_t compressed_block_offset = compressed_data.size();
+    const std::uint64_t uncompressed_block_size = data.size() * sizeof(Sample) + 1;
+
+    if (!data.empty() && std::all_of(data.begin() + 1, data.end(), [&](const Sample sample) { return sample == data.front(); })) {
+        compressed_data.push_back(SOLID_COMPRESSED);
+        append_samples(compressed_data, data.first(1));
+        return;
+    }
 
-    if (use_model) {
-        auto preprocessed_data = encode_adj_val_diff(data.begin(), data.end());
+    std::vector<std::uint8_t> preprocessed_data;
+    const auto symbols = preprocess(data, use_model, use_rle, preprocessed_data);
 
-        if (use_rle) {
-            preprocessed_data = encode_rle(preprocessed_data.begin(), preprocessed_data.end(), DEFAULT_MARKER);
+    if (symbols.empty()) {
+        compressed_data.push_back(UNCOMPRESSED);
+        return;
+    }
+
+    // The sizes of the encoded blocks are known from the histogram, so the block is encoded only by the coder that can achieve compression
+    const auto freqs = STATS_MEASURE(STAGE_HISTOGRAM, get_freqs(symbols));
+    const std::uint64_t huffman_block_size = 1 + STATS_MEASURE(STAGE_TREE, huffman_encoder.get_encoded_size(freqs));
+    const std::uint64_t reused_table_size = reused_table_encoder == NULL ? 0 : reused_table_encoder->get_reused_encoded_size(freqs);
+    std::uint64_t best_block_size = uncompressed_block_size;
+    std::uint8_t best_flag = UNCOMPRESSED;
+
+    if (huffman_block_size < best_block_size) {
+        best_block_size = huffman_block_size;
+        best_flag = COMPRESSED;
+    }
+
+    if (reused_table_size > 0 && reused_table_size + 1 < best_block_size) {
+        best_block_size = reused_table_size + 1;
+        best_flag = REUSED_TABLE_COMPRESSED;
+    }
+
+    // The tables of the dictionary cost only their index
+    std::uint8_t dictionary_table_index = 0;
+
+    for (std::uint16_t i = 0; i < dictionary_encoders.size(); i++) {
+        const std::uint64_t dictionary_table_size = dictionary_encoders[i].get_reused_encoded_size(freqs);
+
+        if (dictionary_table_size > 0 && dictionary_table_size + 2 < best_block_size) {
+            best_block_size = dictionary_table_size + 2;
+            best_flag = DICTIONARY_COMPRESSED;
+            dictionary_table_index = i;
+        }
+    }
+
+    if (search_params.try_rans) {
+        auto rans_encoder = RansEncoder();
+        STATS_MEASURE(STAGE_TREE, rans_encoder.initialize_encoding(freqs));
+
+        if (search_params.encode_rans_exactly || 1 + rans_encoder.estimate_encoded_size(freqs) < best_block_size) {
+            compressed_data.push_back(RANS_COMPRESSED);
+            STATS_MEASURE(STAGE_BIT_ENCODING, rans_encoder.encode_data(symbols, compressed_data));
+
+            if (compressed_data.size() - compressed_block_offset < best_block_size) {
+                return;
+            }
+
+            compressed_data.resize(compressed_block_offset);
         }
+    }
+
+    if (best_flag == UNCOMPRESSED) {
+        // In case it is not possible to achieve compression, keep the data uncompressed
+        compressed_data.push_back(UNCOMPRESSED);
+        append_samples(compressed_data, data);
+        return;
+    }
 
-        huffman_encoder.initialize_encoding(get_freqs(preprocessed_data.begin(), preprocessed_data.end()), compressed_data);
-        huffman_encoder.encode_data(preprocessed_data.begin(), preprocessed_data.end(), compressed_data);
+    HuffmanEncoder &encoder = best_flag == COMPRESSED ? huffman_encoder 
+        : (best_flag == REUSED_TABLE_COMPRESSED ? *reused_table_encoder : dictionary_encoders[dictionary_table_index]);
+    compressed_data.push_back(best_flag);
+
+    if (best_flag == COMPRESSED) {
+        STATS_MEASURE(STAGE_TREE, encoder.initialize_encoding(freqs, compressed_data));
     }
     else {
-        if (use_rle) {
-            auto preprocessed_data = encode_rle(data.begin(), data.end(), DEFAULT_MARKER);
-            huffman_encoder.initialize_encoding(get_freqs(preprocessed_data.begin(), preprocessed_data.end()), compressed_data);
-            huffman_encoder.encode_data(preprocessed_data.begin(), preprocessed_data.end(), compressed_data);
+        if (best_flag == DICTIONARY_COMPRESSED) {
+            compressed_data.push_back(dictionary_table_index);
         }
-        else {
-            huffman_encoder.initialize_encoding(get_freqs(data.begin(), data.end()), compressed_data);
-            huffman_encoder.encode_data(data.begin(), data.end(), compressed_data);
+
+        encoder.reuse_encoding();
+    }
+
+    STATS_MEASURE(STAGE_BIT_ENCODING, encoder.encode_data(symbols, compressed_data));
+    STATS_MEASURE(STAGE_BIT_ENCODING, encoder.finalize_encoding(compressed_data));
+}
+
+
+/**
+ * @brief Decode the symbols of the data block encoded using canonical Huffman encoding or interleaved rANS.
+ * 
+ * @param symbols The resulting decoded symbols
+ * @param huffman_decoder The canonical Huffman code decoder with the source at the compression flag of the data block
+ * @param dictionary_decoders The decoders with the code tables of the dictionary (empty if no dictionary is used)
+ * @param use_rle Indicates whether the RLE was used for original data block preprocessing
+ * @param max_symbol_count The maximum number of symbols of the valid data block before the RLE
+ * 
+ * @return True in case of successful decoding, false otherwise.
+ */
+bool decode_symbols(
+    std::vector<std::uint8_t> &symbols, 
+    HuffmanDecoder &huffman_decoder, 
+    std::span<HuffmanDecoder> dictionary_decoders, 
+    const bool use_rle, 
+    const std::uint64_t max_symbol_count
+) {
+    const auto source = huffman_decoder.get_remaining_source();
+
+    if (source.front() == RANS_COMPRESSED) {
+        auto rans_decoder = RansDecoder();
+        rans_decoder.set_source(source.subspan(1));
+
+        // The RLE encodes each value by at most 2 symbols
+        if (!STATS_MEASURE(STAGE_TREE, rans_decoder.initialize_decoding())
+            || !STATS_MEASURE(STAGE_BIT_DECODING, rans_decoder.decode_data(symbols, use_rle ? 2 * max_symbol_count : max_symbol_count))) {
+            return false;
+        }
+
+        huffman_decoder.advance_source(source.size() - rans_decoder.get_remaining_source().size());
+        return true;
+    }
+
+    if (source.front() == DICTIONARY_COMPRESSED) {
+        if (source.size() < 2 || source[1] >= dictionary_decoders.size()) {
+            report_error("Invalid compressed data - the data block refers to an unknown code table of the dictionary");
+            return false;
+        }
+
+        // The dictionary decoder keeps its table, so the table of the main decoder stays available to the following blocks reusing it
+        HuffmanDecoder &dictionary_decoder = dictionary_decoders[source[1]];
+        dictionary_decoder.set_source_keeping_codebook(source.subspan(2));
+        symbols.clear();
+
+        // Each Huffman encoded symbol takes at least one bit
+        if (!use_rle) {
+            symbols.reserve(std::min(max_symbol_count, 8 * source.size()));
+        }
+
+        if (!STATS_MEASURE(STAGE_BIT_DECODING, dictionary_decoder.decode_data_by_end_symbol(symbols))) {
+            return false;
+        }
+
+        huffman_decoder.advance_source(source.size() - dictionary_decoder.get_remaining_source().size());
+        return true;
+    }
+
+    if (source.front() == COMPRESSED || source.front() == REUSED_TABLE_COMPRESSED) {
+        const bool is_reused_table = source.front() == REUSED_TABLE_COMPRESSED;
+        huffman_decoder.advance_source(1);
+
+        if (is_reused_table && !huffman_decoder.reuse_decoding()) {
+            report_error("Invalid compressed data - the data block reuses the code table, but no preceding block of the data has its own code table");
+            return false;
+        }
+
+        if (!is_reused_table && !STATS_MEASURE(STAGE_TREE, huffman_decoder.initialize_decoding())) {
+            return false;
+        }
+
+        symbols.clear();
+
+        // The number of decoded symbols is known in advance only without the RLE (each of them takes at least one bit)
+        if (!use_rle) {
+            symbols.reserve(std::min(max_symbol_count, 8 * source.size()));
+        }
+
+        return STATS_MEASURE(STAGE_BIT_DECODING, huffman_decoder.decode_data_by_end_symbol(symbols));
+    }
+
+    report_error("Invalid compressed data - unknown compression flag of the data block: " + std::to_string(source.front()));
+    return false;
+}
+
+
+/**
+ * @brief Decompress the data block compressed using canonical Huffman encoding or interleaved rANS.
+ * 
+ * @note The preprocessing stages are selected by UseModel and UseRle at compile time. The inverse model of the 8-bit samples is fused
+ * with the RLE decoding or applied in place without it.
+ * 
+ * @param decompressed_data The resulting decompressed data block
+ * @param huffman_decoder The canonical Huffman code decoder (used as the source of the data block also for the other coders)
+ * @param dictionary_decoders The decoders with the code tables of the dictionary (empty if no dictionary is used)
+ * @param original_val_count The number of original values (samples) in the data block
+ *
+ * @return True in case of successful decompression, false otherwise.
+ */
+template<typename Sample, bool UseModel, bool UseRle>
+bool decompress(
+    std::vector<Sample> &decompressed_data, 
+    HuffmanDecoder &huffman_decoder, 
+    std::span<HuffmanDecoder> dictionary_decoders, 
+    const std::uint64_t original_val_count
+) {
+    if (huffman_decoder.is_source_proccessed()) {
+        report_error("Invalid compressed data - unexpected end of the compressed data, expected compression flag");
+        return false;
+    }
+
+    const auto source = huffman_decoder.get_remaining_source();
+
+    // If the data in the compressed data block are kept uncompressed, use number of original values in data block to determine how many uncompressed symbols to load from source
+    if (source.front() == UNCOMPRESSED) {
+        const std::uint64_t uncompressed_data_size = original_val_count * sizeof(Sample);
+
+        if (source.size() - 1 < uncompressed_data_size) {
+            report_error("Invalid compressed data - unexpected end of the uncompressed data block");
+            return false;
+        }
+
+        load_samples(source.subspan(1, uncompressed_data_size), decompressed_data);
+        huffman_decoder.advance_source(1 + uncompressed_data_size);
+        return true;
+    }
+
+    // The solid data block is filled by its single sample without any decoding
+    if (source.front() == SOLID_COMPRESSED) {
+        if (source.size() - 1 < sizeof(Sample)) {
+            report_error("Invalid compressed data - unexpected end of the sample of the solid data block");
+            return false;
+        }
+
+        if (original_val_count == 0) {
+            report_error("Invalid compressed data - solid data block without samples");
+            return false;
+        }
+
+        decompressed_data.assign(original_val_count, load_sample<Sample>(source.subspan(1), 0));
+        huffman_decoder.advance_source(1 + sizeof(Sample));
+        return true;
+    }
+
+    if constexpr (sizeof(Sample) == 1) {
+        if (!decode_symbols(decompressed_data, huffman_decoder, dictionary_decoders, UseRle, original_val_count)) {
+            return false;
+        }
+
+        if constexpr (UseRle) {
+            using ModelTransform = std::conditional_t<UseModel, AdjValDiffDecoder, IdentityTransform>;
+            const auto symbols = std::move(decompressed_data);
+
+            if (!STATS_MEASURE(UseModel ? STAGE_MODEL_RLE : STAGE_RLE, decode_rle(symbols, DEFAULT_MARKER, original_val_count, decompressed_data, ModelTransform()))) {
+                report_error("Invalid compressed data - the runs of the RLE exceed the size of the data block");
+                return false;
+            }
+        }
+        else if constexpr (UseModel) {
+            STATS_SCOPE(STAGE_MODEL);
+            auto model = AdjValDiffDecoder();
+
+            for (auto &val: decompressed_data) {
+                val = model(val);
+            }
+        }
+    }
+    else {
+        // The raw samples are packed as the pairs of their bytes, the residuals of the model by the high byte escape scheme
+        const std::uint64_t max_packed_size = (UseModel ? MAX_PACKED_SAMPLE_SIZE : sizeof(Sample)) * original_val_count;
+        std::vector<std::uint8_t> packed_data;
+
+        if (!decode_symbols(packed_data, huffman_decoder, dictionary_decoders, UseRle, max_packed_size)) {
+            return false;
+        }
+
+        if constexpr (UseRle) {
+            const auto symbols = std::move(packed_data);
+
+            if (!STATS_MEASURE(STAGE_RLE, decode_rle(symbols, DEFAULT_MARKER, max_packed_size, packed_data))) {
+                report_error("Invalid compressed data - the runs of the RLE exceed the size of the data block");
+                return false;
+            }
+        }
+
+        if (!STATS_MEASURE(STAGE_MODEL, UseModel ? decode_adj_val_diff(packed_data, decompressed_data) : unpack_samples(packed_data, decompressed_data))) {
+            report_error("Invalid compressed data - incomplete packed sample of the data block");
+            return false;
+        }
+    }
+
+    if (decompressed_data.size() != original_val_count) {
+        report_error("Invalid compressed data - the size of the decompressed data differs from the size specified in the compressed data header");
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Decompress the data block by the instantiation for the preprocessing it was compressed with.
+ * 
+ * @param decompressed_data The resulting decompressed data block
+ * @param huffman_decoder The canonical Huffman code decoder (used as the source of the data block also for the other coders)
+ * @param dictionary_decoders The decoders with the code tables of the dictionary (empty if no dictionary is used)
+ * @param use_model Indicates whether the adjacent value difference model was used for original data block preprocessing
+ * @param use_rle Indicates whether the RLE was used for original data block preprocessing
+ * @param original_val_count The number of original values (samples) in the data block
+ *
+ * @return True in case of successful decompression, false otherwise.
+ */
+template<typename Sample>
+bool decompress(
+    std::vector<Sample> &decompressed_data, 
+    HuffmanDecoder &huffman_decoder, 
+    std::span<HuffmanDecoder> dictionary_decoders, 
+    const bool use_model, 
+    const bool use_rle, 
+    const std::uint64_t original_val_count
+) {
+    return with_preprocessing(use_model, use_rle, [&](auto model_stage, auto rle_stage) {
+        return decompress<Sample, decltype(model_stage)::value, decltype(rle_stage)::value>(
+            decompressed_data, huffman_decoder, dictionary_decoders, original_val_count
+        );
+    });
+}
+
+
+#ifndef DISABLE_STATS
+/**
+ * @brief Add the statistics of the compressed block to the statistics collected by the current thread.
+ * 
+ * @param is_vertical Indicates whether the block is scanned vertically
+ * @param compressed_block The compressed block (starting with its compression flag)
+ */
+void record_block_stats(const bool is_vertical, std::span<const std::uint8_t> compressed_block) {
+    BlockStats block_stats;
+    block_stats.is_vertical = is_vertical;
+    block_stats.is_uncompressed = compressed_block.front() == UNCOMPRESSED;
+    block_stats.is_solid = compressed_block.front() == SOLID_COMPRESSED;
+    block_stats.is_rans = compressed_block.front() == RANS_COMPRESSED;
+    block_stats.is_reused_table = compressed_block.front() == REUSED_TABLE_COMPRESSED;
+    block_stats.is_dictionary_table = compressed_block.front() == DICTIONARY_COMPRESSED;
+    block_stats.payload_size = compressed_block.size() - 1;
+
+    // The size of the code table is obtained by loading it once more (only when the statistics are collected)
+    if (block_stats.is_rans) {
+        auto rans_decoder = RansDecoder();
+        rans_decoder.set_source(compressed_block.subspan(1));
+        rans_decoder.initialize_decoding();
+        block_stats.payload_size = rans_decoder.get_remaining_source().size();
+        block_stats.table_size = compressed_block.size() - 1 - block_stats.payload_size;
+    }
+    else if (compressed_block.front() == COMPRESSED) {
+        auto huffman_decoder = HuffmanDecoder();
+        huffman_decoder.set_source(compressed_block.subspan(1));
+        huffman_decoder.initialize_decoding();
+        block_stats.payload_size = huffman_decoder.get_remaining_source().size();
+        block_stats.table_size = compressed_block.size() - 1 - block_stats.payload_size;
+    }
+    else if (block_stats.is_dictionary_table) {
+        // The table is referred to by its index only
+        block_stats.table_size = 1;
+        block_stats.payload_size = compressed_block.size() - 2;
+    }
+    else if (compressed_block.front() == SHARED_TABLE_CHUNKS_COMPRESSED && compressed_block.size() > 1 + CHUNK_SIZE_BYTE_COUNT) {
+        // The shared table is preceded by the chunk size and the payload consists of the sizes of the chunks and the chunks
+        auto huffman_decoder = HuffmanDecoder();
+        huffman_decoder.set_source(compressed_block.subspan(1 + CHUNK_SIZE_BYTE_COUNT));
+        huffman_decoder.initialize_decoding();
+        block_stats.payload_size = huffman_decoder.get_remaining_source().size();
+        block_stats.table_size = compressed_block.size() - 1 - block_stats.payload_size;
+    }
+
+    active_stats->blocks.push_back(block_stats);
+}
+#endif
+
+
+/**
+ * @brief Process the tasks split into contiguous ranges by more threads at the same time (the current thread processes the first range).
+ * 
+ * @note The description of the error of a failed range is reported in the current thread.
+ * 
+ * @param task_count The number of tasks
+ * @param thread_count The maximum number of threads
+ * @param process_range Function processing the tasks from the given index to the given end index, returning false in case of an error
+ * 
+ * @return True if all the ranges are successfully processed, false otherwise.
+ */
+template<typename RangeProcessor>
+bool process_in_parallel(const std::uint64_t task_count, const unsigned thread_count, RangeProcessor process_range) {
+    const std::uint64_t range_count = std::max(static_cast<std::uint64_t>(1), std::min(task_count, static_cast<std::uint64_t>(thread_count)));
+    std::mutex error_mutex;
+    std::string error;
+    bool is_successful = true;
+
+    auto process = [&](const std::uint64_t range_index) {
+        if (!process_range(task_count * range_index / range_count, task_count * (range_index + 1) / range_count)) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+
+            // Keep the first error (the error descriptions are stored separately for each thread)
+            if (is_successful) {
+                error = get_last_error();
+                is_successful = false;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::uint64_t i = 1; i < range_count; i++) {
+        threads.emplace_back(process, i);
+    }
+
+    process(0);
+
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    if (!is_successful) {
+        report_error(error);
+    }
+
+    return is_successful;
+}
+
+
+/**
+ * @brief Compress the statically scanned data split into the chunks decodable independently of each other by more threads at the same time.
+ * 
+ * @note The compressed data start with the number of values of each chunk (except the last one) and the code table built from the histogram
+ * of all the chunks, followed by the sizes of the compressed chunks and the chunks themselves. Each chunk is compressed as the whole statically
+ * scanned data (with the model and the RLE restarted), so it is usually encoded by the shared code table, but it may use any other coder.
+ * 
+ * @param data The data to be compressed
+ * @param compressed_data Buffer to which the resulting compressed data are appended
+ * @param use_model Indicates whether the adjacent value difference model should be used for each chunk preprocessing
+ * @param use_rle Indicates whether the RLE should be used for each chunk preprocessing
+ * @param search_params The search of the encoder
+ * @param dictionary The dictionary of the code tables the chunks may be encoded by (NULL if there is none)
+ */
+template<typename Sample>
+void compress_shared_table_chunks(
+    std::span<const Sample> data, 
+    std::vector<std::uint8_t> &compressed_data, 
+    const bool use_model, 
+    const bool use_rle, 
+    const SearchParams &search_params, 
+    const HuffmanDictionary *dictionary
+) {
+    const std::uint64_t chunk_val_count = STATIC_CHUNK_SIZE / sizeof(Sample);
+    const std::uint64_t chunk_count = (data.size() + chunk_val_count - 1) / chunk_val_count;
+    const unsigned thread_count = std::max(1u, std::thread::hardware_concurrency());
+    CodecStats *const stats = STATS_ACTIVE;
+    std::vector<CodecStats> chunk_stats(stats != NULL ? chunk_count : 0);
+    std::atomic<bool> is_out_of_memory = false;
+
+    auto get_chunk = [&](const std::uint64_t chunk_index) {
+        return data.subspan(chunk_index * chunk_val_count, std::min(chunk_val_count, data.size() - chunk_index * chunk_val_count));
+    };
+
+    // The shared code table is built from the summed histograms of the preprocessed chunks
+    std::vector<std::uint64_t> freqs;
+    std::mutex freqs_mutex;
+
+    process_in_parallel(chunk_count, thread_count, [&](const std::uint64_t begin, const std::uint64_t end) {
+        try {
+            std::vector<std::uint64_t> range_freqs;
+            std::vector<std::uint8_t> preprocessed_chunk;
+
+            for (std::uint64_t i = begin; i < end; i++) {
+                STATS_REDIRECT(stats != NULL ? &chunk_stats[i] : NULL);
+                const auto symbols = preprocess(get_chunk(i), use_model, use_rle, preprocessed_chunk);
+                const auto chunk_freqs = STATS_MEASURE(STAGE_HISTOGRAM, get_freqs(symbols));
+                range_freqs.resize(chunk_freqs.size());
+
+                for (std::uint16_t j = 0; j < chunk_freqs.size(); j++) {
+                    range_freqs[j] += chunk_freqs[j];
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(freqs_mutex);
+            freqs.resize(range_freqs.size());
+
+            for (std::uint16_t j = 0; j < range_freqs.size(); j++) {
+                freqs[j] += range_freqs[j];
+            }
+        }
+        catch (const std::bad_alloc &) {
+            is_out_of_memory = true;
+            return false;
+        }
+
+        return true;
+    });
+
+    // The allocation failure is passed to the caller as if the chunks were compressed by the current thread
+    if (is_out_of_memory) {
+        throw std::bad_alloc();
+    }
+
+    auto shared_encoder = HuffmanEncoder();
+    std::vector<std::uint8_t> shared_codebook;
+    STATS_MEASURE(STAGE_TREE, shared_encoder.initialize_encoding(freqs, shared_codebook));
+
+    std::vector<std::vector<std::uint8_t>> compressed_chunks(chunk_count);
+
+    process_in_parallel(chunk_count, thread_count, [&](const std::uint64_t begin, const std::uint64_t end) {
+        try {
+            auto huffman_encoder = HuffmanEncoder();
+            auto dictionary_encoders = copy_dictionary_encoders(dictionary);
+
+            for (std::uint64_t i = begin; i < end; i++) {
+                STATS_REDIRECT(stats != NULL ? &chunk_stats[i] : NULL);
+
+                // The encoder of the shared table is copied, so that each chunk is encoded from its initial state
+                auto reused_table_encoder = shared_encoder;
+                compress<Sample>(
+                    get_chunk(i), huffman_encoder, compressed_chunks[i], use_model, use_rle, search_params, &reused_table_encoder, dictionary_encoders
+                );
+            }
+        }
+        catch (const std::bad_alloc &) {
+            is_out_of_memory = true;
+            return false;
+        }
+
+        return true;
+    });
+
+    if (is_out_of_memory) {
+        throw std::bad_alloc();
+    }
+
+    for (const auto &stats_of_chunk: chunk_stats) {
+        merge_stats(*stats, stats_of_chunk);
+    }
+
+    std::uint64_t chunked_data_size = 1 + CHUNK_SIZE_BYTE_COUNT + shared_codebook.size() + chunk_count * CHUNK_SIZE_BYTE_COUNT;
+
+    for (const auto &compressed_chunk: compressed_chunks) {
+        chunked_data_size += compressed_chunk.size();
+    }
+
+    // In case the chunks do not achieve compression, keep the whole data uncompressed
+    if (chunked_data_size >= 1 + data.size() * sizeof(Sample)) {
+        compressed_data.push_back(UNCOMPRESSED);
+        append_samples(compressed_data, data);
+        return;
+    }
+
+    compressed_data.push_back(SHARED_TABLE_CHUNKS_COMPRESSED);
+    append_number(compressed_data, chunk_val_count, CHUNK_SIZE_BYTE_COUNT);
+    compressed_data.insert(compressed_data.end(), shared_codebook.begin(), shared_codebook.end());
+
+    for (const auto &compressed_chunk: compressed_chunks) {
+        append_number(compressed_data, compressed_chunk.size(), CHUNK_SIZE_BYTE_COUNT);
+    }
+
+    for (const auto &compressed_chunk: compressed_chunks) {
+        compressed_data.insert(compressed_data.end(), compressed_chunk.begin(), compressed_chunk.end());
+    }
+}
+
+
+/**
+ * @brief Split the statically scanned data compressed into the chunks sharing the code table into the individual chunks.
+ * 
+ * @note The sizes of all the chunks are checked against the compressed data, so that the memory for the decompressed data is allocated
+ * only once they are known to be complete.
+ * 
+ * @param compressed_data The compressed chunks (following their compression flag)
+ * @param original_data_size The size of the original data
+ * @param sample_bits The number of bits per sample of the original data
+ * @param shared_table_chunks The resulting chunks with the decoder of the shared table
+ * 
+ * @return True if the compressed data consist of the shared table and of the complete chunks of the original data, false otherwise.
+ */
+bool split_shared_table_chunks(
+    std::span<const std::uint8_t> compressed_data, 
+    const std::uint64_t original_data_size, 
+    const unsigned sample_bits, 
+    SharedTableChunks &shared_table_chunks
+) {
+    if (compressed_data.size() < CHUNK_SIZE_BYTE_COUNT) {
+        report_error("Invalid compressed data - missing chunk size of the statically scanned data");
+        return false;
+    }
+
+    const std::uint64_t chunk_val_count = load_number(compressed_data.data(), CHUNK_SIZE_BYTE_COUNT);
+
+    const std::uint64_t sample_size = sample_bits > MAX_BYTE_SAMPLE_BITS ? 2 : 1;
+    const std::uint64_t val_count = original_data_size / sample_size;
+
+    if (chunk_val_count == 0 || chunk_val_count > STATIC_CHUNK_SIZE / sample_size) {
+        report_error("Invalid compressed data - invalid size of the chunks of the statically scanned data");
+        return false;
+    }
+
+    const std::uint64_t chunk_count = val_count / chunk_val_count + (val_count % chunk_val_count != 0);
+    auto &shared_decoder = shared_table_chunks.shared_decoder;
+    shared_decoder.set_source(compressed_data.subspan(CHUNK_SIZE_BYTE_COUNT));
+
+    if (!STATS_MEASURE(STAGE_TREE, shared_decoder.initialize_decoding())) {
+        return false;
+    }
+
+    auto chunk_sizes = shared_decoder.get_remaining_source();
+
+    if (chunk_sizes.size() / CHUNK_SIZE_BYTE_COUNT < chunk_count) {
+        report_error("Invalid compressed data - incomplete sizes of the chunks of the statically scanned data");
+        return false;
+    }
+
+    auto &chunks = shared_table_chunks.chunks;
+    auto remaining_chunks = chunk_sizes.subspan(chunk_count * CHUNK_SIZE_BYTE_COUNT);
+    chunks.resize(chunk_count);
+
+    for (std::uint64_t i = 0; i < chunk_count; i++) {
+        const std::uint64_t chunk_size = load_number(chunk_sizes.data() + i * CHUNK_SIZE_BYTE_COUNT, CHUNK_SIZE_BYTE_COUNT);
+
+        if (chunk_size > remaining_chunks.size()) {
+            report_error("Invalid compressed data - the size of the chunk of the statically scanned data exceeds the compressed data");
+            return false;
+        }
+
+        chunks[i] = remaining_chunks.first(chunk_size);
+        remaining_chunks = remaining_chunks.subspan(chunk_size);
+    }
+
+    shared_table_chunks.chunk_val_count = chunk_val_count;
+    return true;
+}
+
+
+/**
+ * @brief Decompress the statically scanned data split into the chunks sharing the code table (by more threads at the same time).
+ * 
+ * @param shared_table_chunks The compressed chunks with the decoder of the shared table
+ * @param decompressed_data The resulting decompressed data (their size is the size of the original data)
+ * @param use_model Indicates whether the adjacent value difference model was used for each chunk preprocessing
+ * @param use_rle Indicates whether the RLE was used for each chunk preprocessing
+ * @param thread_count The maximum number of threads decompressing the chunks
+ * @param dictionary The dictionary of the code tables the chunks were compressed with (NULL if there is none)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+template<typename Sample>
+bool decompress_shared_table_chunks(
+    const SharedTableChunks &shared_table_chunks, 
+    std::span<std::uint8_t> decompressed_data, 
+    const bool use_model, 
+    const bool use_rle, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+) {
+    const std::uint64_t val_count = decompressed_data.size() / sizeof(Sample);
+    const std::uint64_t chunk_val_count = shared_table_chunks.chunk_val_count;
+    const auto &chunks = shared_table_chunks.chunks;
+    CodecStats *const stats = STATS_ACTIVE;
+    std::vector<CodecStats> chunk_stats(stats != NULL ? chunks.size() : 0);
+    std::atomic<bool> is_out_of_memory = false;
+
+    // Each chunk is decoded by a copy of the decoder with the shared table to its own part of the decompressed data
+    const bool is_successful = process_in_parallel(chunks.size(), thread_count, [&](const std::uint64_t begin, const std::uint64_t end) {
+        try {
+            auto dictionary_decoders = copy_dictionary_decoders(dictionary);
+            std::vector<Sample> chunk;
+
+            for (std::uint64_t i = begin; i < end; i++) {
+                STATS_REDIRECT(stats != NULL ? &chunk_stats[i] : NULL);
+                const std::uint64_t first_val_index = i * chunk_val_count;
+                auto huffman_decoder = shared_table_chunks.shared_decoder;
+                huffman_decoder.set_source_keeping_codebook(chunks[i]);
+
+                if (!decompress<Sample>(chunk, huffman_decoder, dictionary_decoders, use_model, use_rle, std::min(chunk_val_count, val_count - first_val_index))) {
+                    return false;
+                }
+
+                store_samples(decompressed_data, first_val_index, chunk);
+            }
+        }
+        catch (const std::bad_alloc &) {
+            is_out_of_memory = true;
+            return false;
+        }
+
+        return true;
+    });
+
+    if (is_out_of_memory) {
+        throw std::bad_alloc();
+    }
+
+    for (const auto &stats_of_chunk: chunk_stats) {
+        merge_stats(*stats, stats_of_chunk);
+    }
+
+    return is_successful;
+}
+
+
+/**
+ * @brief Decompress the statically scanned data split into the chunks sharing the code table by the instantiation for their sample width.
+ * 
+ * @param compressed_data The compressed data (starting with their compression flag)
+ * @param shared_table_chunks The compressed chunks with the decoder of the shared table
+ * @param decompressed_data The resulting decompressed data (their size is the size of the original data)
+ * @param sample_bits The width of the samples (in bits)
+ * @param use_model Indicates whether the adjacent value difference model was used for each chunk preprocessing
+ * @param use_rle Indicates whether the RLE was used for each chunk preprocessing
+ * @param thread_count The maximum number of threads decompressing the chunks
+ * @param dictionary The dictionary of the code tables the chunks were compressed with (NULL if there is none)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+bool decompress_shared_table_chunks(
+    std::span<const std::uint8_t> compressed_data, 
+    const SharedTableChunks &shared_table_chunks, 
+    std::span<std::uint8_t> decompressed_data, 
+    const unsigned sample_bits, 
+    const bool use_model, 
+    const bool use_rle, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+) {
+    if (!with_sample_type(sample_bits, [&](auto sample) {
+        return decompress_shared_table_chunks<decltype(sample)>(shared_table_chunks, decompressed_data, use_model, use_rle, thread_count, dictionary);
+    })) {
+        return false;
+    }
+
+    STATS_IF_ACTIVE(record_block_stats(false, compressed_data));
+    return true;
+}
+
+
+void compress_statically(
+    std::span<const std::uint8_t> data, 
+    std::vector<std::uint8_t> &compressed_data, 
+    const CompressOptions &options, 
+    const HuffmanDictionary *dictionary
+) {
+    auto huffman_encoder = HuffmanEncoder();
+    auto dictionary_encoders = copy_dictionary_encoders(dictionary);
+    const SearchParams &search_params = get_search_params(options.effort_level);
+    const bool use_model = options.use_model;
+    const bool use_rle = options.use_rle;
+
+    // The data of at most one chunk are kept as one block
+    const bool split_to_chunks = options.use_static_chunks && data.size() > STATIC_CHUNK_SIZE;
+
+    if (options.sample_bits > MAX_BYTE_SAMPLE_BITS) {
+        std::vector<std::uint16_t> samples;
+        load_samples(data, samples);
+
+        if (split_to_chunks) {
+            compress_shared_table_chunks<std::uint16_t>(samples, compressed_data, use_model, use_rle, search_params, dictionary);
+        }
+        else {
+            compress<std::uint16_t>(samples, huffman_encoder, compressed_data, use_model, use_rle, search_params, NULL, dictionary_encoders);
+        }
+    }
+    else if (split_to_chunks) {
+        compress_shared_table_chunks<std::uint8_t>(data, compressed_data, use_model, use_rle, search_params, dictionary);
+    }
+    else {
+        compress<std::uint8_t>(data, huffman_encoder, compressed_data, use_model, use_rle, search_params, NULL, dictionary_encoders);
+    }
+}
+
+
+bool decompress_statically(
+    std::span<const std::uint8_t> compressed_data, 
+    std::vector<std::uint8_t> &decompressed_data, 
+    const std::uint64_t original_data_size, 
+    const unsigned sample_bits, 
+    const bool use_model, 
+    const bool use_rle, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+) {
+    // The chunks are decoded directly to the decompressed data, which are allocated only once the chunk table is checked
+    if (!compressed_data.empty() && compressed_data.front() == SHARED_TABLE_CHUNKS_COMPRESSED) {
+        SharedTableChunks shared_table_chunks;
+
+        if (!split_shared_table_chunks(compressed_data.subspan(1), original_data_size, sample_bits, shared_table_chunks)) {
+            return false;
+        }
+
+        decompressed_data.resize(original_data_size);
+        return decompress_shared_table_chunks(compressed_data, shared_table_chunks, decompressed_data, sample_bits, use_model, use_rle, thread_count, dictionary);
+    }
+
+    auto huffman_decoder = HuffmanDecoder();
+    auto dictionary_decoders = copy_dictionary_decoders(dictionary);
+    huffman_decoder.set_source(compressed_data);
+
+    if (sample_bits > MAX_BYTE_SAMPLE_BITS) {
+        std::vector<std::uint16_t> samples;
+
+        if (!decompress(samples, huffman_decoder, dictionary_decoders, use_model, use_rle, original_data_size / 2)) {
+            return false;
+        }
+
+        decompressed_data.clear();
+        decompressed_data.reserve(original_data_size);
+        append_samples(decompressed_data, samples);
+    }
+    else if (!decompress(decompressed_data, huffman_decoder, dictionary_decoders, use_model, use_rle, original_data_size)) {
+        return false;
+    }
+
+    STATS_IF_ACTIVE(record_block_stats(false, compressed_data.first(compressed_data.size() - huffman_decoder.get_remaining_source().size())));
+    return true;
+}
+
+
+bool decompress_statically(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<std::uint8_t> decompressed_data, 
+    const unsigned sample_bits, 
+    const bool use_model, 
+    const bool use_rle, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+) {
+    if (!compressed_data.empty() && compressed_data.front() == SHARED_TABLE_CHUNKS_COMPRESSED) {
+        SharedTableChunks shared_table_chunks;
+
+        return split_shared_table_chunks(compressed_data.subspan(1), decompressed_data.size(), sample_bits, shared_table_chunks) 
+            && decompress_shared_table_chunks(compressed_data, shared_table_chunks, decompressed_data, sample_bits, use_model, use_rle, thread_count, dictionary);
+    }
+
+    // The data not split into the chunks are decoded to a vector anyway, so they are copied to the provided memory
+    std::vector<std::uint8_t> static_data;
+
+    if (!decompress_statically(compressed_data, static_data, decompressed_data.size(), sample_bits, use_model, use_rle, thread_count, dictionary)) {
+        return false;
+    }
+
+    std::copy(static_data.begin(), static_data.end(), decompressed_data.begin());
+    return true;
+}
+
+
+template<typename Sample>
+void transpose_block_in_place(std::vector<Sample> &block) {
+    for (std::uint8_t i = 0; i < BLOCK_SIDE_SIZE; i++) {
+        std::uint16_t row_offset = i * BLOCK_SIDE_SIZE;
+
+        for (std::uint8_t j = i + 1; j < BLOCK_SIDE_SIZE; j++) {
+            std::swap(block[j + row_offset], block[i + j * BLOCK_SIDE_SIZE]);
+        }
+    }
+}
+
+
+template<typename Sample>
+void serialize_block(
+    const std::vector<Sample> &deserialized_block, 
+    const bool is_transposed, 
+    const std::uint16_t block_val_count, 
+    const std::uint8_t block_width, 
+    const std::uint8_t block_height, 
+    std::vector<Sample> &serialized_block
+) {
+    if (!is_transposed) {
+        for (std::uint8_t i = 0; i < block_height; i++) {
+            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
+            std::uint16_t serialized_block_offset = i * block_width;
+
+            for (std::uint8_t j = 0; j < block_width; j++) {
+                // Stop when all the values are processed (for the case when the data does not fill the whole block)
+                if (j + serialized_block_offset >= block_val_count) {
+                    break;
+                }
+
+                serialized_block[j + serialized_block_offset] = deserialized_block[j + deserialized_block_offset];
+            }
+        }
+    }
+    else {
+        // The number of block unshortened rows (in the case when the data does not fill the whole block the transposed block may have the last few rows 1 value shorter)
+        std::uint8_t num_of_orig_width_rows = block_val_count % block_height;
+
+        if (num_of_orig_width_rows == 0) {
+            num_of_orig_width_rows = block_height;
+        }
+
+        // Serialize unshortened lines
+        for (std::uint8_t i = 0; i < num_of_orig_width_rows; i++) {
+            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
+            std::uint16_t serialized_block_offset = i * block_width;
+
+            for (std::uint8_t j = 0; j < block_width; j++) {
+                serialized_block[j + serialized_block_offset] = deserialized_block[j + deserialized_block_offset];
+            }
+        }
+
+        std::uint8_t shorten_block_width = block_width - 1;
+
+        // Serialize shortened rows
+        for (std::uint8_t i = num_of_orig_width_rows; i < block_height; i++) {
+            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
+            std::uint16_t serialized_block_offset = num_of_orig_width_rows * block_width + (i - num_of_orig_width_rows) * shorten_block_width;
+
+            for (std::uint8_t j = 0; j < shorten_block_width; j++) {
+                serialized_block[j + serialized_block_offset] = deserialized_block[j + deserialized_block_offset];
+            }
+        }
+    }
+}
+
+
+template<typename Sample>
+void deserialize_block(
+    const std::vector<Sample> &serialized_block, 
+    const bool is_transposed, 
+    const std::uint16_t block_val_count, 
+    const std::uint8_t block_width, 
+    const std::uint8_t block_height, 
+    std::vector<Sample> &deserialized_block
+) {
+    if (!is_transposed) {
+        for (std::uint8_t i = 0; i < block_height; i++) {
+            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
+            std::uint16_t serialized_block_offset = i * block_width;
+
+            for (std::uint8_t j = 0; j < block_width; j++) {
+                // Stop when all the values are processed (for the case when the data does not fill the whole block)
+                if (j + serialized_block_offset >= block_val_count) {
+                    break;
+                }
+
+                deserialized_block[j + deserialized_block_offset] = serialized_block[j + serialized_block_offset];
+            }
+        }
+    }
+    else {
+        // The number of block unshortened rows (in the case when the data does not fill the whole block the transposed block may have the last few rows 1 value shorter)
+        std::uint8_t num_of_orig_width_rows = block_val_count % block_height;
+
+        if (num_of_orig_width_rows == 0) {
+            num_of_orig_width_rows = block_height;
+        }
+
+        // Deserialize unshortened lines
+        for (std::uint8_t i = 0; i < num_of_orig_width_rows; i++) {
+            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
+            std::uint16_t serialized_block_offset = i * block_width;
+
+            for (std::uint8_t j = 0; j < block_width; j++) {
+                deserialized_block[j + deserialized_block_offset] = serialized_block[j + serialized_block_offset];
+            }
+        }
+
+        std::uint8_t shorten_block_width = block_width - 1;
+
+        // deserialize shortened lines
+        for (std::uint8_t i = num_of_orig_width_rows; i < block_height; i++) {
+            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
+            std::uint16_t serialized_block_offset = num_of_orig_width_rows * block_width + (i - num_of_orig_width_rows) * shorten_block_width;
+
+            for (std::uint8_t j = 0; j < shorten_block_width; j++) {
+                deserialized_block[j + deserialized_block_offset] = serialized_block[j + serialized_block_offset];
+            }
+        }
+    }
+}
+
+
+// The block functions are provided for the samples of both the widths
+template void transpose_block_in_place<std::uint8_t>(std::vector<std::uint8_t> &block);
+template void transpose_block_in_place<std::uint16_t>(std::vector<std::uint16_t> &block);
+template void serialize_block<std::uint8_t>(
+    const std::vector<std::uint8_t> &, const bool, const std::uint16_t, const std::uint8_t, const std::uint8_t, std::vector<std::uint8_t> &
+);
+template void serialize_block<std::uint16_t>(
+    const std::vector<std::uint16_t> &, const bool, const std::uint16_t, const std::uint8_t, const std::uint8_t, std::vector<std::uint16_t> &
+);
+template void deserialize_block<std::uint8_t>(
+    const std::vector<std::uint8_t> &, const bool, const std::uint16_t, const std::uint8_t, const std::uint8_t, std::vector<std::uint8_t> &
+);
+template void deserialize_block<std::uint16_t>(
+    const std::vector<std::uint16_t> &, const bool, const std::uint16_t, const std::uint8_t, const std::uint8_t, std::vector<std::uint16_t> &
+);
+
+
+/**
+ * @brief Get the height of the block at the given position in the data.
+ * 
+ * @note The blocks beyond the end of the incomplete last row of the data are one row lower.
+ * 
+ * @param data_height The height of data (2D image) including its incomplete last row
+ * @param unaligned_data_remainder The number of samples of the incomplete last row of the data (0 if it is complete)
+ * @param data_horizontal_offset The horizontal position of the block in the data
+ * @param data_vertical_offset The vertical position of the block in the data
+ * 
+ * @return The height of the block.
+ */
+std::uint8_t get_block_height(
+    const std::uint64_t data_height, 
+    const std::uint64_t unaligned_data_remainder, 
+    const std::uint64_t data_horizontal_offset, 
+    const std::uint64_t data_vertical_offset
+) {
+    return std::min(
+        static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), 
+        data_height - data_vertical_offset 
+            - (unaligned_data_remainder == 0 || data_height - data_vertical_offset > BLOCK_SIDE_SIZE || data_horizontal_offset < unaligned_data_remainder ? 0 : 1)
+    );
+}
+
+
+/**
+ * @brief Extract the data block from its position in the data.
+ * 
+ * @param data The samples of the whole data (2D image)
+ * @param data_width The width of data (2D image)
+ * @param data_block_offset The offset of the top left sample of the block in the data
+ * @param block_width The width of the block
+ * @param block_height The height of the block
+ * @param deserialized_block The resulting deserialized data block
+ * 
+ * @return The number of values of the block (lower than its area if the data end inside the block).
+ */
+template<typename Sample>
+std::uint16_t extract_block(
+    std::span<const Sample> data, 
+    const std::uint64_t data_width, 
+    const std::uint64_t data_block_offset, 
+    const std::uint8_t block_width, 
+    const std::uint8_t block_height, 
+    std::vector<Sample> &deserialized_block
+) {
+    std::uint16_t block_val_count = block_height * block_width;
+
+    for (std::uint8_t i = 0; i < block_height; i++) {
+        std::uint16_t block_offset = i * BLOCK_SIDE_SIZE;
+        std::uint64_t data_offset = i * data_width + data_block_offset;
+
+        for (std::uint8_t j = 0; j < block_width; j++) {
+            if (j + data_offset >= data.size()) {
+                block_val_count += j - block_width;
+                break;
+            }
+
+            deserialized_block[j + block_offset] = data[j + data_offset];
+        }
+    }
+
+    return block_val_count;
+}
+
+
+/**
+ * @brief Buffers reused by the compression of the consecutive blocks.
+ */
+template<typename Sample>
+struct BlockBuffers {
+    std::vector<Sample> serialized_block;
+    std::vector<Sample> residual_block;     // The difference of the deserialized block from the co-located block of the previous frame
+    std::vector<std::uint8_t> candidate_block;
+    std::vector<std::uint8_t> best_block;   // The smallest compressed block (starting with its compression flag)
+    HuffmanEncoder candidate_encoder;
+    HuffmanEncoder best_encoder;            // The encoder of the smallest compressed block, so that its code table can be reused
+};
+
+
+/**
+ * @brief Compress the deserialized data block by all the candidates of the encoder search and keep the smallest one.
+ * 
+ * @param deserialized_block The deserialized data block (transposed in place if the vertical scan is tried)
+ * @param block_val_count The number of values of the block
+ * @param block_width The width of the block
+ * @param block_height The height of the block
+ * @param use_model Indicates whether the adjacent value difference model should be used for the data block preprocessing
+ * @param use_rle Indicates whether the RLE should be used for the data block preprocessing
+ * @param search_params The search of the encoder
+ * @param reused_table_encoder The encoder with the code table that can be reused by the block (NULL if there is none)
+ * @param dictionary_encoders The encoders with the code tables of the dictionary (empty if no dictionary is used)
+ * @param reference_block The co-located deserialized block of the previous frame the block may be predicted from (NULL if there is none)
+ * @param buffers The buffers of the compression holding the smallest compressed block and its encoder afterwards
+ * 
+ * @return The mode of the smallest compressed block.
+ */
+template<typename Sample>
+std::uint8_t compress_block(
+    std::vector<Sample> &deserialized_block, 
+    const std::uint16_t block_val_count, 
+    const std::uint8_t block_width, 
+    const std::uint8_t block_height, 
+    const bool use_model, 
+    const bool use_rle, 
+    const SearchParams &search_params, 
+    HuffmanEncoder *reused_table_encoder, 
+    std::span<HuffmanEncoder> dictionary_encoders, 
+    const std::vector<Sample> *reference_block, 
+    BlockBuffers<Sample> &buffers
+) {
+    // The preprocessing disabled for the block by the individual candidates
+    std::array<std::uint8_t, 4> preprocessing_modes = {0};
+    std::uint8_t preprocessing_mode_count = 1;
+
+    if (search_params.search_preprocessing) {
+        if (use_model) {
+            preprocessing_modes[preprocessing_mode_count++] = BLOCK_WITHOUT_MODEL;
+        }
+
+        if (use_rle) {
+            preprocessing_modes[preprocessing_mode_count++] = BLOCK_WITHOUT_RLE;
+        }
+
+        if (use_model && use_rle) {
+            preprocessing_modes[preprocessing_mode_count++] = BLOCK_WITHOUT_MODEL | BLOCK_WITHOUT_RLE;
+        }
+    }
+
+    std::uint8_t best_mode = HORIZONTAL_SCAN;
+    const std::uint64_t uncompressed_block_size = block_val_count * sizeof(Sample) + 1;
+
+    // Compress the serialized block by all the candidates of the scan and keep the smallest one
+    auto try_candidates = [&](const std::uint8_t scan_mode) {
+        for (std::uint8_t i = 0; i < preprocessing_mode_count; i++) {
+            buffers.candidate_block.clear();
+            compress<Sample>(
+                buffers.serialized_block, 
+                buffers.candidate_encoder, 
+                buffers.candidate_block, 
+                use_model && !(preprocessing_modes[i] & BLOCK_WITHOUT_MODEL), 
+                use_rle && !(preprocessing_modes[i] & BLOCK_WITHOUT_RLE), 
+                search_params, 
+                reused_table_encoder, 
+                dictionary_encoders
+            );
+
+            if (buffers.best_block.empty() || buffers.candidate_block.size() < buffers.best_block.size()) {
+                std::swap(buffers.best_block, buffers.candidate_block);
+                std::swap(buffers.best_encoder, buffers.candidate_encoder);
+                best_mode = scan_mode | preprocessing_modes[i];
+            }
+
+            // The constant block is stored as the solid block regardless of the preprocessing
+            if (buffers.best_block.front() == SOLID_COMPRESSED) {
+                break;
+            }
+        }
+    };
+
+    // Serialize the deseriaized data block (or its residual) and compress it by both scans
+    auto try_scans = [&](std::vector<Sample> &block, const std::uint8_t prediction_mode) {
+        STATS_MEASURE(STAGE_BLOCK_SERIALIZATION, serialize_block(block, false, block_val_count, block_width, block_height, buffers.serialized_block));
+        try_candidates(HORIZONTAL_SCAN | prediction_mode);
+
+        // The vertical scan makes difference only with the preprocessing (and not for the solid blocks) and it is tried only for the blocks
+        // compressed poorly enough by the horizontal scan
+        if ((use_model || use_rle) && buffers.best_block.front() != SOLID_COMPRESSED
+            && buffers.best_block.size() * 100 > search_params.vertical_scan_min_ratio * uncompressed_block_size) {
+            STATS_MEASURE(STAGE_BLOCK_SERIALIZATION, transpose_block_in_place(block));
+            STATS_MEASURE(STAGE_BLOCK_SERIALIZATION, serialize_block(block, true, block_val_count, block_height, block_width, buffers.serialized_block));
+            try_candidates(VERTICAL_SCAN | prediction_mode);
+        }
+    };
+
+    buffers.serialized_block.resize(block_val_count);
+    buffers.best_block.clear();
+
+    // The static parts of the scene are predicted almost exactly by the previous frame, so the block is compressed without the prediction
+    // only if its residual is compressed poorly enough
+    if (reference_block != NULL) {
+        buffers.residual_block.resize(BLOCK_SIZE);
+
+        for (std::uint16_t i = 0; i < block_height * BLOCK_SIDE_SIZE; i += BLOCK_SIDE_SIZE) {
+            for (std::uint16_t j = i; j < i + block_width; j++) {
+                buffers.residual_block[j] = deserialized_block[j] - (*reference_block)[j];
+            }
+        }
+
+        try_scans(buffers.residual_block, BLOCK_TEMPORAL);
+
+        if (buffers.best_block.size() * 100 <= search_params.spatial_min_ratio * uncompressed_block_size) {
+            return best_mode;
+        }
+    }
+
+    try_scans(deserialized_block, 0);
+    return best_mode;
+}
+
+
+/**
+ * @brief Append the compressed block with its mode (preceded by its size and its checksum if the checksums are used) to the compressed data.
+ * 
+ * @param compressed_data Buffer to which the block is appended
+ * @param mode The mode of the block
+ * @param compressed_block The compressed block (starting with its compression flag)
+ * @param use_checksum Indicates whether the block should be preceded by its size and its CRC32C checksum
+ */
+void append_block(std::vector<std::uint8_t> &compressed_data, const std::uint8_t mode, std::span<const std::uint8_t> compressed_block, const bool use_checksum) {
+    // The place for the size and the checksum of the block filled in once the block is stored
+    const std::uint64_t block_record_offset = compressed_data.size();
+
+    if (use_checksum) {
+        compressed_data.resize(block_record_offset + BLOCK_RECORD_SIZE);
+    }
+
+    compressed_data.push_back(mode);
+    compressed_data.insert(compressed_data.end(), compressed_block.begin(), compressed_block.end());
+
+    if (use_checksum) {
+        const auto block = std::span<const std::uint8_t>(compressed_data).subspan(block_record_offset + BLOCK_RECORD_SIZE);
+        store_number(compressed_data.data() + block_record_offset, block.size(), BLOCK_SIZE_BYTE_COUNT);
+        store_number(compressed_data.data() + block_record_offset + BLOCK_SIZE_BYTE_COUNT, crc32c(block), CRC_BYTE_COUNT);
+    }
+}
+
+
+/**
+ * @brief Compress the samples using canonical Huffman encoding with adaptive scanning (without the header).
+ * 
+ * @note The frames of the sequence of frames are decomposed into the blocks one after another, each block may be predicted from
+ * the co-located block of the previous frame. The code table of the last block of a frame can be reused by the blocks of the next frame.
+ * 
+ * @param data The samples to be compressed
+ * @param compressed_data Buffer to which the resulting compressed data are appended
+ * @param data_width The width of data (2D image) in samples
+ * @param frame_height The height of the frames of the sequence of frames (0 if the data are a single image)
+ * @param use_model Indicates whether the adjacent value difference model should be used for each data block preprocessing
+ * @param use_rle Indicates whether the RLE should be used for each original data block preprocessing
+ * @param use_checksum Indicates whether each block should be preceded by its size and its CRC32C checksum
+ * @param effort_level The effort level of the encoder search
+ * @param dictionary The dictionary of the code tables the blocks may be encoded by (NULL if there is none)
+ */
+template<typename Sample>
+void compress_sample_blocks(
+    std::span<const Sample> data, 
+    std::vector<std::uint8_t> &compressed_data, 
+    const std::uint64_t data_width, 
+    const std::uint64_t frame_height, 
+    const bool use_model, 
+    const bool use_rle, 
+    const bool use_checksum, 
+    const unsigned effort_level, 
+    const HuffmanDictionary *dictionary
+) {
+    const std::uint64_t data_height = data.size() / data_width + (data.size() % data_width != 0 ? 1 : 0);
+    const std::uint64_t frame_size = frame_height != 0 && frame_height < data_height ? frame_height * data_width : data.size();
+    const SearchParams &search_params = get_search_params(effort_level);
+    // The blocks with the checksums have to be decodable independently of each other, so they never reuse the code tables,
+    // while the blocks predicted from the previous frame (mostly the same residuals of the static scene) always may reuse them
+    const bool reuse_tables = (search_params.reuse_tables || frame_height != 0) && !use_checksum;
+    std::vector<Sample> deserialized_block(BLOCK_SIZE);
+    std::vector<Sample> reference_block(BLOCK_SIZE);
+    auto buffers = BlockBuffers<Sample>();
+    auto previous_table_encoder = HuffmanEncoder();
+    bool has_previous_table = false;
+    auto dictionary_encoders = copy_dictionary_encoders(dictionary);
+
+    for (std::uint64_t frame_offset = 0; frame_offset < data.size(); frame_offset += frame_size) {
+        const auto frame = data.subspan(frame_offset, std::min(frame_size, data.size() - frame_offset));
+        // All the frames but the last one are complete, so the previous frame covers the whole current frame
+        const auto previous_frame = frame_offset > 0 ? data.subspan(frame_offset - frame_size, frame_size) : std::span<const Sample>();
+        const std::uint64_t original_frame_size = frame.size();
+        const std::uint64_t frame_rows = original_frame_size / data_width + (original_frame_size % data_width != 0 ? 1 : 0);
+        const std::uint64_t unaligned_data_remainder = original_frame_size % data_width;
+        std::uint64_t data_horizontal_offset = 0;
+        std::uint64_t data_vertical_offset = 0;
+        std::uint64_t remaining_decompressed_data_size = original_frame_size;
+
+        while (remaining_decompressed_data_size > 0) {
+            std::uint64_t data_block_offset = data_horizontal_offset + data_vertical_offset * data_width;
+            std::uint8_t block_width = std::min(static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), data_width - data_horizontal_offset);
+            std::uint8_t block_height = get_block_height(frame_rows, unaligned_data_remainder, data_horizontal_offset, data_vertical_offset);
+            std::uint16_t block_val_count = STATS_MEASURE(
+                STAGE_BLOCK_SERIALIZATION, 
+                extract_block(frame, data_width, data_block_offset, block_width, block_height, deserialized_block)
+            );
+
+            if (!previous_frame.empty()) {
+                STATS_MEASURE(STAGE_BLOCK_SERIALIZATION, extract_block(previous_frame, data_width, data_block_offset, block_width, block_height, reference_block));
+            }
+
+            data_horizontal_offset += BLOCK_SIDE_SIZE;
+
+            if (data_horizontal_offset >= data_width) {
+                data_horizontal_offset = 0;
+                data_vertical_offset += BLOCK_SIDE_SIZE;
+            }
+
+            const std::uint8_t best_mode = compress_block(
+                deserialized_block, 
+                block_val_count, 
+                block_width, 
+                block_height, 
+                use_model, 
+                use_rle, 
+                search_params, 
+                has_previous_table ? &previous_table_encoder : NULL, 
+                dictionary_encoders, 
+                !previous_frame.empty() ? &reference_block : NULL, 
+                buffers
+            );
+
+            append_block(compressed_data, best_mode, buffers.best_block, use_checksum);
+            STATS_IF_ACTIVE(record_block_stats(!(best_mode & HORIZONTAL_SCAN), buffers.best_block));
+
+            // The following blocks can reuse the code table of the last block with its own table
+            if (reuse_tables && buffers.best_block.front() == COMPRESSED) {
+                std::swap(previous_table_encoder, buffers.best_encoder);
+                has_previous_table = true;
+            }
+
+            remaining_decompressed_data_size -= block_val_count;
+        }
+    }
+}
+
+
+void compress_adaptively(
+    std::span<const std::uint8_t> data, 
+    std::vector<std::uint8_t> &compressed_data, 
+    const CompressOptions &options, 
+    const HuffmanDictionary *dictionary
+) {
+    // The blocks of the sequence of frames are preceded by the height of the frames
+    if (options.frame_height != 0) {
+        append_number(compressed_data, options.frame_height, FRAME_HEIGHT_BYTE_COUNT);
+    }
+
+    if (options.sample_bits > MAX_BYTE_SAMPLE_BITS) {
+        std::vector<std::uint16_t> samples;
+        load_samples(data, samples);
+        compress_sample_blocks<std::uint16_t>(
+            samples, compressed_data, options.width_value, options.frame_height, options.use_model, options.use_rle, options.use_checksum, 
+            options.effort_level, dictionary
+        );
+    }
+    else {
+        compress_sample_blocks<std::uint8_t>(
+            data, compressed_data, options.width_value, options.frame_height, options.use_model, options.use_rle, options.use_checksum, 
+            options.effort_level, dictionary
+        );
+    }
+}
+
+
+/**
+ * @brief Collect the histograms of the symbols of the horizontally scanned blocks of the samples (or of the whole samples with the static scanning).
+ * 
+ * @param data The samples
+ * @param data_width The width of data (2D image) in samples
+ * @param adapt_scan Indicates whether the data are decomposed into the blocks
+ * @param use_model Indicates whether the adjacent value difference model should be used for data preprocessing
+ * @param use_rle Indicates whether the RLE should be used for data preprocessing
+ * @param block_freqs Buffer to which the resulting histograms are appended
+ */
+template<typename Sample>
+void collect_sample_block_freqs(
+    std::span<const Sample> data, 
+    const std::uint64_t data_width, 
+    const bool adapt_scan, 
+    const bool use_model, 
+    const bool use_rle, 
+    std::vector<std::vector<std::uint64_t>> &block_freqs
+) {
+    std::vector<std::uint8_t> preprocessed_data;
+
+    if (!adapt_scan) {
+        block_freqs.push_back(get_freqs(preprocess(data, use_model, use_rle, preprocessed_data)));
+        return;
+    }
+
+    const std::uint64_t data_height = data.size() / data_width + (data.size() % data_width != 0 ? 1 : 0);
+    const std::uint64_t unaligned_data_remainder = data.size() % data_width;
+    std::vector<Sample> deserialized_block(BLOCK_SIZE);
+    std::vector<Sample> serialized_block;
+
+    for (std::uint64_t data_vertical_offset = 0; data_vertical_offset < data_height; data_vertical_offset += BLOCK_SIDE_SIZE) {
+        for (std::uint64_t data_horizontal_offset = 0; data_horizontal_offset < data_width; data_horizontal_offset += BLOCK_SIDE_SIZE) {
+            const std::uint8_t block_width = std::min(static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), data_width - data_horizontal_offset);
+            const std::uint8_t block_height = get_block_height(data_height, unaligned_data_remainder, data_horizontal_offset, data_vertical_offset);
+            const std::uint16_t block_val_count = extract_block(
+                data, data_width, data_horizontal_offset + data_vertical_offset * data_width, block_width, block_height, deserialized_block
+            );
+
+            if (block_val_count == 0) {
+                continue;
+            }
+
+            serialized_block.resize(block_val_count);
+            serialize_block(deserialized_block, false, block_val_count, block_width, block_height, serialized_block);
+            block_freqs.push_back(get_freqs(preprocess<Sample>(serialized_block, use_model, use_rle, preprocessed_data)));
+        }
+    }
+}
+
+
+void collect_block_freqs(
+    std::span<const std::uint8_t> data, 
+    const std::uint64_t width_value, 
+    const unsigned sample_bits, 
+    const bool adapt_scan, 
+    const bool use_model, 
+    const bool use_rle, 
+    std::vector<std::vector<std::uint64_t>> &block_freqs
+) {
+    if (sample_bits > MAX_BYTE_SAMPLE_BITS) {
+        std::vector<std::uint16_t> samples;
+        load_samples(data, samples);
+        collect_sample_block_freqs<std::uint16_t>(samples, width_value, adapt_scan, use_model, use_rle, block_freqs);
+    }
+    else {
+        collect_sample_block_freqs<std::uint8_t>(data, width_value, adapt_scan, use_model, use_rle, block_freqs);
+    }
+}
+
+
+/**
+ * @brief Decompress one block of the adaptively scanned data to the deserialized block.
+ * 
+ * @param huffman_decoder The canonical Huffman code decoder with the source at the beginning of the block (its mode)
+ * @param dictionary_decoders The decoders with the code tables of the dictionary (empty if no dictionary is used)
+ * @param original_data_size The number of the samples of the whole data
+ * @param data_width The width of data (2D image) in samples
+ * @param data_horizontal_offset The horizontal position of the block in the data
+ * @param data_vertical_offset The vertical position of the block in the data
+ * @param use_model Indicates whether the adjacent value difference model was used for the original data block preprocessing
+ * @param use_rle Indicates whether the RLE was used for the original data block preprocessing
+ * @param has_previous_frame Indicates whether the block may be predicted from the co-located block of the previous frame
+ * @param is_temporal The resulting indication whether the deserialized block is the difference from the co-located block of the previous frame
+ * @param serialized_block Buffer for the serialized block, holding the decompressed values of the block afterwards
+ * @param deserialized_block Buffer for the resulting deserialized block (of BLOCK_SIZE values)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+template<typename Sample>
+bool decode_block(
+    HuffmanDecoder &huffman_decoder, 
+    std::span<HuffmanDecoder> dictionary_decoders, 
+    const std::uint64_t original_data_size, 
+    const std::uint64_t data_width, 
+    const std::uint64_t data_horizontal_offset, 
+    const std::uint64_t data_vertical_offset, 
+    const bool use_model, 
+    const bool use_rle, 
+    const bool has_previous_frame, 
+    bool &is_temporal, 
+    std::vector<Sample> &serialized_block, 
+    std::vector<Sample> &deserialized_block
+) {
+    const std::uint64_t data_height = original_data_size / data_width + (original_data_size % data_width != 0 ? 1 : 0);
+    const std::uint64_t unaligned_data_remainder = original_data_size % data_width;
+
+    if (huffman_decoder.is_source_proccessed()) {
+        report_error("Invalid compressed data - the size of the decompressed data is lower than the size specified in the compressed data header");
+        return false;
+    }
+
+    if (data_vertical_offset >= data_height) {
+        report_error("Invalid compressed data - the size of the decompressed data is greater than the size specified in the compressed data header");
+        return false;
+    }
+
+    const std::uint8_t mode = huffman_decoder.get_remaining_source().front();
+
+    if ((mode & ~BLOCK_MODE_MASK) || ((mode & BLOCK_TEMPORAL) && !has_previous_frame)) {
+        report_error("Invalid compressed data - unknown mode of the data block: " + std::to_string(mode));
+        return false;
+    }
+
+    const bool is_transposed = !(mode & HORIZONTAL_SCAN);
+    is_temporal = mode & BLOCK_TEMPORAL;
+    huffman_decoder.advance_source();
+    const auto compressed_block = huffman_decoder.get_remaining_source();
+
+    std::uint8_t block_width = std::min(static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), data_width - data_horizontal_offset);
+    std::uint8_t block_height = get_block_height(data_height, unaligned_data_remainder, data_horizontal_offset, data_vertical_offset);
+    std::uint64_t data_block_offset = data_horizontal_offset + data_vertical_offset * data_width;
+    std::uint64_t data_block_end_offset = data_block_offset + block_width + (block_height - 1) * data_width;
+
+    // Decompress the serialized data block and deserialize it
+    if (!decompress(
+        serialized_block, 
+        huffman_decoder, 
+        dictionary_decoders, 
+        use_model && !(mode & BLOCK_WITHOUT_MODEL), 
+        use_rle && !(mode & BLOCK_WITHOUT_RLE), 
+        block_height * block_width - (data_block_end_offset > original_data_size ? data_block_end_offset - original_data_size : 0)
+    )) {
+        return false;
+    }
+
+    STATS_IF_ACTIVE(record_block_stats(
+        is_transposed, 
+        compressed_block.first(compressed_block.size() - huffman_decoder.get_remaining_source().size())
+    ));
+    STATS_SCOPE(STAGE_BLOCK_SERIALIZATION);
+
+    // The solid block is the same in any scan
+    if (compressed_block.front() == SOLID_COMPRESSED) {
+        std::fill(deserialized_block.begin(), deserialized_block.end(), serialized_block.front());
+    }
+    else if (!is_transposed) {
+        deserialize_block(serialized_block, is_transposed, serialized_block.size(), block_width, block_height, deserialized_block);
+    }
+    else {
+        deserialize_block(serialized_block, is_transposed, serialized_block.size(), block_height, block_width, deserialized_block);
+        transpose_block_in_place(deserialized_block);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Decompress one block of the adaptively scanned data and put it to its position in the decompressed data.
+ * 
+ * @param huffman_decoder The canonical Huffman code decoder with the source at the beginning of the block (its mode)
+ * @param dictionary_decoders The decoders with the code tables of the dictionary (empty if no dictionary is used)
+ * @param decompressed_data The memory for the whole decompressed data or frame (the 16-bit samples are stored in little endian)
+ * @param previous_frame The decompressed previous frame of the sequence of frames (empty if there is none)
+ * @param data_width The width of data (2D image) in samples
+ * @param data_horizontal_offset The horizontal position of the block in the data
+ * @param data_vertical_offset The vertical position of the block in the data
+ * @param use_model Indicates whether the adjacent value difference model was used for the original data block preprocessing
+ * @param use_rle Indicates whether the RLE was used for the original data block preprocessing
+ * @param serialized_block Buffer for the serialized block, holding the decompressed values of the block afterwards
+ * @param deserialized_block Buffer for the deserialized block (of BLOCK_SIZE values)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+template<typename Sample>
+bool decompress_block(
+    HuffmanDecoder &huffman_decoder, 
+    std::span<HuffmanDecoder> dictionary_decoders, 
+    std::span<std::uint8_t> decompressed_data, 
+    std::span<const std::uint8_t> previous_frame, 
+    const std::uint64_t data_width, 
+    const std::uint64_t data_horizontal_offset, 
+    const std::uint64_t data_vertical_offset, 
+    const bool use_model, 
+    const bool use_rle, 
+    std::vector<Sample> &serialized_block, 
+    std::vector<Sample> &deserialized_block
+) {
+    const std::uint64_t original_data_size = decompressed_data.size() / sizeof(Sample);
+    bool is_temporal;
+
+    if (!decode_block(
+        huffman_decoder, 
+        dictionary_decoders, 
+        original_data_size, 
+        data_width, 
+        data_horizontal_offset, 
+        data_vertical_offset, 
+        use_model, 
+        use_rle, 
+        !previous_frame.empty(), 
+        is_temporal, 
+        serialized_block, 
+        deserialized_block
+    )) {
+        return false;
+    }
+
+    STATS_SCOPE(STAGE_BLOCK_SERIALIZATION);
+    const std::uint64_t data_height = original_data_size / data_width + (original_data_size % data_width != 0 ? 1 : 0);
+    std::uint8_t block_width = std::min(static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), data_width - data_horizontal_offset);
+    std::uint8_t block_height = get_block_height(data_height, original_data_size % data_width, data_horizontal_offset, data_vertical_offset);
+    std::uint64_t data_block_offset = data_horizontal_offset + data_vertical_offset * data_width;
+
+    // Put the deserialized data block to its original position in the original data (adding the co-located block of the previous frame to its difference)
+    for (std::uint8_t i = 0; i < block_height; i++) {
+        std::uint16_t block_offset = i * BLOCK_SIDE_SIZE;
+        std::uint64_t data_offset = i * data_width + data_block_offset;
+
+        if (data_offset >= original_data_size) {
+            break;
+        }
+
+        const std::uint8_t row_width = std::min(static_cast<std::uint64_t>(block_width), original_data_size - data_offset);
+
+        // The rows of the 8-bit samples are copied at once
+        if constexpr (sizeof(Sample) == 1) {
+            if (!is_temporal) {
+                std::copy_n(deserialized_block.begin() + block_offset, row_width, decompressed_data.begin() + data_offset);
+                continue;
+            }
+        }
+
+        for (std::uint8_t j = 0; j < row_width; j++) {
+            const Sample sample = deserialized_block[j + block_offset];
+            store_sample(decompressed_data, j + data_offset, is_temporal ? static_cast<Sample>(sample + load_sample<Sample>(previous_frame, j + data_offset)) : sample);
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Split the adaptively scanned compressed data with the checksums into the blocks.
+ * 
+ * @param compressed_data The compressed blocks each of which is preceded by its size and its checksum
+ * @param block_records The resulting blocks
+ * 
+ * @return True if the compressed data consist of complete blocks, false otherwise.
+ */
+bool split_block_records(std::span<const std::uint8_t> compressed_data, std::vector<BlockRecord> &block_records) {
+    block_records.clear();
+
+    while (!compressed_data.empty()) {
+        if (compressed_data.size() < BLOCK_RECORD_SIZE) {
+            report_error("Invalid compressed data - incomplete size and checksum of the block");
+            return false;
+        }
+
+        const std::uint64_t block_size = load_number(compressed_data.data(), BLOCK_SIZE_BYTE_COUNT);
+        const std::uint32_t checksum = load_number(compressed_data.data() + BLOCK_SIZE_BYTE_COUNT, CRC_BYTE_COUNT);
+        compressed_data = compressed_data.subspan(BLOCK_RECORD_SIZE);
+
+        if (block_size > compressed_data.size()) {
+            report_error("Invalid compressed data - unexpected end of the compressed block");
+            return false;
+        }
+
+        block_records.push_back({compressed_data.first(block_size), checksum});
+        compressed_data = compressed_data.subspan(block_size);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Check the checksums of the consecutive blocks of the adaptively scanned data and decompress them to their positions in the decompressed data.
+ * 
+ * @param block_records The blocks to be decompressed
+ * @param first_block_index The index of the first of the blocks in the whole data
+ * @param decompressed_data The memory for the whole decompressed data
+ * @param data_width The width of data (2D image) in samples
+ * @param use_model Indicates whether the adjacent value difference model was used for each original data block preprocessing
+ * @param use_rle Indicates whether the RLE was used for each original data block preprocessing
+ * @param dictionary The dictionary of the code tables the blocks may be encoded by (NULL if there is none)
+ * @param decompressed_val_count The resulting number of the decompressed samples of the blocks
+ * 
+ * @return True if all the checksums match and the blocks are successfully decompressed, false otherwise.
+ */
+template<typename Sample>
+bool decompress_block_records(
+    std::span<const BlockRecord> block_records, 
+    const std::uint64_t first_block_index, 
+    std::span<std::uint8_t> decompressed_data, 
+    const std::uint64_t data_width, 
+    const bool use_model, 
+    const bool use_rle, 
+    const HuffmanDictionary *dictionary, 
+    std::uint64_t &decompressed_val_count
+) {
+    const std::uint64_t blocks_per_row = data_width / BLOCK_SIDE_SIZE + (data_width % BLOCK_SIDE_SIZE != 0 ? 1 : 0);
+    std::vector<Sample> serialized_block;
+    std::vector<Sample> deserialized_block(BLOCK_SIZE);
+    auto huffman_decoder = HuffmanDecoder();
+    auto dictionary_decoders = copy_dictionary_decoders(dictionary);
+    decompressed_val_count = 0;
+
+    for (std::uint64_t i = 0; i < block_records.size(); i++) {
+        const std::uint64_t block_index = first_block_index + i;
+
+        if (crc32c(block_records[i].data) != block_records[i].checksum) {
+            report_error("Invalid compressed data - checksum mismatch of the block " + std::to_string(block_index));
+            return false;
+        }
+
+        huffman_decoder.set_source(block_records[i].data);
+
+        if (!decompress_block(
+            huffman_decoder, 
+            dictionary_decoders, 
+            decompressed_data, 
+            std::span<const std::uint8_t>(), 
+            data_width, 
+            block_index % blocks_per_row * BLOCK_SIDE_SIZE, 
+            block_index / blocks_per_row * BLOCK_SIDE_SIZE, 
+            use_model, 
+            use_rle, 
+            serialized_block, 
+            deserialized_block
+        )) {
+            return false;
+        }
+
+        if (!huffman_decoder.is_source_proccessed()) {
+            report_error("Invalid compressed data - the block " + std::to_string(block_index) + " is longer than its compressed content");
+            return false;
+        }
+
+        decompressed_val_count += serialized_block.size();
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Decompress the samples compressed using canonical Huffman encoding with adaptive scanning (without the header) to the memory provided by the caller.
+ * 
+ * @param compressed_data The data to be decompressed
+ * @param decompressed_data The memory for the resulting decompressed data (the 16-bit samples are stored in little endian)
+ * @param data_width The width of data (2D image) in samples
+ * @param frame_height The height of the frames of the sequence of frames (0 if the data are a single image)
+ * @param use_model Indicates whether the adjacent value difference model was used for each original data block preprocessing
+ * @param use_rle Indicates whether the RLE was used for each original data block preprocessing
+ * @param use_checksum Indicates whether each block is preceded by its size and its CRC32C checksum (not used by the sequence of frames)
+ * @param dictionary The dictionary of the code tables the blocks may be encoded by (NULL if there is none)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+template<typename Sample>
+bool decompress_sample_blocks(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<std::uint8_t> decompressed_data, 
+    const std::uint64_t data_width, 
+    const std::uint64_t frame_height, 
+    const bool use_model, 
+    const bool use_rle, 
+    const bool use_checksum, 
+    const HuffmanDictionary *dictionary
+) {
+    const std::uint64_t original_data_size = decompressed_data.size() / sizeof(Sample);
+
+    if (use_checksum) {
+        std::vector<BlockRecord> block_records;
+        std::uint64_t decompressed_val_count;
+
+        if (!split_block_records(compressed_data, block_records)
+            || !decompress_block_records<Sample>(block_records, 0, decompressed_data, data_width, use_model, use_rle, dictionary, decompressed_val_count)) {
+            return false;
+        }
+
+        if (decompressed_val_count != original_data_size) {
+            report_error("Invalid compressed data - the size of the decompressed data differs from the size specified in the compressed data header");
+            return false;
+        }
+
+        return true;
+    }
+
+    const std::uint64_t data_height = original_data_size / data_width + (original_data_size % data_width != 0 ? 1 : 0);
+    // The frames lower than the whole data cover less samples than the data, so their size cannot overflow
+    const std::uint64_t frame_size = (frame_height != 0 && frame_height < data_height ? frame_height * data_width : original_data_size) * sizeof(Sample);
+    std::vector<Sample> serialized_block;
+    std::vector<Sample> deserialized_block(BLOCK_SIZE);
+    auto huffman_decoder = HuffmanDecoder();
+    auto dictionary_decoders = copy_dictionary_decoders(dictionary);
+    huffman_decoder.set_source(compressed_data);
+
+    // The frames are decompressed one after another, so the previous frame is already decompressed for the prediction of the blocks
+    for (std::uint64_t frame_offset = 0; frame_offset < decompressed_data.size(); frame_offset += frame_size) {
+        const auto frame = decompressed_data.subspan(frame_offset, std::min(frame_size, decompressed_data.size() - frame_offset));
+        const auto previous_frame = frame_offset > 0 ? std::span<const std::uint8_t>(decompressed_data).subspan(frame_offset - frame_size, frame_size) 
+            : std::span<const std::uint8_t>();
+        std::uint64_t data_horizontal_offset = 0;
+        std::uint64_t data_vertical_offset = 0;
+        std::uint64_t remaining_decompressed_data_size = frame.size() / sizeof(Sample);
+
+        while (remaining_decompressed_data_size > 0) {
+            if (!decompress_block(
+                huffman_decoder, 
+                dictionary_decoders, 
+                frame, 
+                previous_frame, 
+                data_width, 
+                data_horizontal_offset, 
+                data_vertical_offset, 
+                use_model, 
+                use_rle, 
+                serialized_block, 
+                deserialized_block
+            )) {
+                return false;
+            }
+
+            if (remaining_decompressed_data_size < serialized_block.size()) {
+                report_error("Invalid compressed data - the size of the decompressed data is greater than the size specified in the compressed data header");
+                return false;
+            }
+
+            remaining_decompressed_data_size -= serialized_block.size();
+            data_horizontal_offset += BLOCK_SIDE_SIZE;
+
+            if (data_horizontal_offset >= data_width) {
+                data_horizontal_offset = 0;
+                data_vertical_offset += BLOCK_SIDE_SIZE;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool decompress_adaptively(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<std::uint8_t> decompressed_data, 
+    const std::uint64_t data_width, 
+    const unsigned sample_bits, 
+    const bool use_frames, 
+    const bool use_model, 
+    const bool use_rle, 
+    const bool use_checksum, 
+    const HuffmanDictionary *dictionary
+) {
+    std::uint64_t frame_height = 0;
+
+    if (use_frames) {
+        const std::uint64_t sample_count = decompressed_data.size() / (sample_bits > MAX_BYTE_SAMPLE_BITS ? 2 : 1);
+        const std::uint64_t data_height = sample_count / data_width + (sample_count % data_width != 0 ? 1 : 0);
+
+        if (compressed_data.size() < FRAME_HEIGHT_BYTE_COUNT) {
+            report_error("Invalid compressed data - missing height of the frames");
+            return false;
+        }
+
+        frame_height = load_number(compressed_data.data(), FRAME_HEIGHT_BYTE_COUNT);
+        compressed_data = compressed_data.subspan(FRAME_HEIGHT_BYTE_COUNT);
+
+        if (frame_height == 0 || frame_height >= data_height) {
+            report_error("Invalid compressed data - invalid height of the frames: " + std::to_string(frame_height));
+            return false;
+        }
+    }
+
+    return with_sample_type(sample_bits, [&](auto sample) {
+        return decompress_sample_blocks<decltype(sample)>(compressed_data, decompressed_data, data_width, frame_height, use_model, use_rle, use_checksum, dictionary);
+    });
+}
+
+
+/**
+ * @brief Compress the thumbnail of the image and append it preceded by the side of its cells and by its size.
+ * 
+ * @note The thumbnail is compressed as the adaptively scanned data of its own (multi-channel data with the same color transform
+ * for the multi-channel image) without any dictionary, so that it is decompressed without decoding the blocks of the image.
+ * 
+ * @param data The image
+ * @param compressed_data Buffer to which the compressed thumbnail is appended
+ * @param options The options of the compression of the image (with the side of the cells summarized by one pixel of the thumbnail)
+ */
+void append_thumbnail(std::span<const std::uint8_t> data, std::vector<std::uint8_t> &compressed_data, const CompressOptions &options) {
+    std::vector<std::uint8_t> thumbnail;
+    std::vector<std::uint8_t> compressed_thumbnail;
+    // The thumbnail is a lossless single image with the same preprocessing, channels and checksums as the image
+    CompressOptions thumbnail_options = options;
+    thumbnail_options.width_value = get_thumbnail_width(options.width_value, options.thumbnail_cell_side);
+    thumbnail_options.adapt_scan = true;
+    thumbnail_options.use_static_chunks = false;
+    thumbnail_options.thumbnail_cell_side = 0;
+    thumbnail_options.frame_height = 0;
+    thumbnail_options.max_error = 0;
+
+    // The blocks of the thumbnail are not counted in the statistics of the image
+    STATS_REDIRECT(NULL);
+    compute_thumbnail(data, options.width_value, options.sample_bits, options.channel_count, options.is_planar, options.thumbnail_cell_side, thumbnail);
+
+    if (options.channel_count > 1) {
+        compress_channels(thumbnail, compressed_thumbnail, thumbnail_options, NULL);
+    }
+    else {
+        compress_data(thumbnail, compressed_thumbnail, thumbnail_options, NULL);
+    }
+
+    compressed_data.push_back(options.thumbnail_cell_side);
+    append_number(compressed_data, compressed_thumbnail.size(), CHUNK_SIZE_BYTE_COUNT);
+    compressed_data.insert(compressed_data.end(), compressed_thumbnail.begin(), compressed_thumbnail.end());
+}
+
+
+void compress_data(
+    std::span<const std::uint8_t> data, 
+    std::vector<std::uint8_t> &compressed_data, 
+    const CompressOptions &options, 
+    const HuffmanDictionary *dictionary
+) {
+    const std::uint64_t sample_count = data.size() / (options.sample_bits > MAX_BYTE_SAMPLE_BITS ? 2 : 1);
+    // The data not higher than one frame are a single image
+    const bool use_frames = options.frame_height != 0 && options.adapt_scan && !options.use_checksum 
+        && options.frame_height < sample_count / options.width_value + (sample_count % options.width_value != 0 ? 1 : 0);
+    StreamHeader header;
+    header.flags = FLAG_RANS | (options.use_model ? FLAG_MODEL : 0) | (options.use_rle ? FLAG_RLE : 0) | (options.adapt_scan ? FLAG_ADAPTIVE : 0) 
+        | (options.use_checksum ? FLAG_CHECKSUM : 0) | (options.sample_bits > MAX_BYTE_SAMPLE_BITS ? FLAG_SAMPLES_16 : 0) 
+        | (dictionary != NULL && !data.empty() ? FLAG_DICTIONARY : 0) | (options.thumbnail_cell_side != 0 && options.adapt_scan && !data.empty() ? FLAG_THUMBNAIL : 0) 
+        | (use_frames ? FLAG_FRAMES : 0) | (options.max_error != 0 && !data.empty() ? FLAG_NEAR_LOSSLESS : 0);
+    header.original_size = data.size();
+    header.width = options.adapt_scan ? options.width_value : 0;
+    std::vector<std::uint8_t> payload;
+    std::vector<std::uint8_t> quantized_data;
+    std::uint16_t max_sample = 0;
+
+    // The quantized samples are compressed instead of the original ones, so that all the following stages stay lossless
+    if (header.flags & FLAG_NEAR_LOSSLESS) {
+        max_sample = with_sample_type(options.sample_bits, [&](auto sample) -> std::uint16_t {
+            return quantize_samples<decltype(sample)>(data, options.max_error, quantized_data);
+        });
+    }
+
+    const std::span<const std::uint8_t> samples = header.flags & FLAG_NEAR_LOSSLESS ? std::span<const std::uint8_t>(quantized_data) : data;
+
+    if (!samples.empty()) {
+        if (options.adapt_scan) {
+            CompressOptions adaptive_options = options;
+            adaptive_options.frame_height = use_frames ? options.frame_height : 0;
+            compress_adaptively(samples, payload, adaptive_options, dictionary);
+        }
+        else {
+            compress_statically(samples, payload, options, dictionary);
+
+            // The static scanning has only one block, so the preprocessing of the whole data is chosen by the header flags
+            if (get_search_params(options.effort_level).search_preprocessing) {
+                std::vector<std::uint8_t> candidate_payload;
+                CompressOptions candidate_options = options;
+
+                for (const std::uint8_t flags: {FLAG_MODEL, FLAG_RLE, 0}) {
+                    // Only the subsets of the allowed preprocessing are tried
+                    if ((flags & ~header.flags) || flags == (header.flags & (FLAG_MODEL | FLAG_RLE))) {
+                        continue;
+                    }
+
+                    candidate_payload.clear();
+                    candidate_options.use_model = flags & FLAG_MODEL;
+                    candidate_options.use_rle = flags & FLAG_RLE;
+                    compress_statically(samples, candidate_payload, candidate_options, dictionary);
+
+                    if (candidate_payload.size() < payload.size()) {
+                        std::swap(payload, candidate_payload);
+                        header.flags = (header.flags & ~(FLAG_MODEL | FLAG_RLE)) | flags;
+                    }
+                }
+            }
+
+            STATS_IF_ACTIVE(record_block_stats(false, payload));
+        }
+    }
+
+    write_header(header, compressed_data);
+
+    // The compressed content using the dictionary starts with its hash, so that it is decompressed only by the same dictionary
+    if (header.flags & FLAG_DICTIONARY) {
+        append_number(compressed_data, dictionary->get_hash(), DICTIONARY_HASH_BYTE_COUNT);
+    }
+
+    // The data are a single channel regardless of the options of the channels
+    if (header.flags & FLAG_THUMBNAIL) {
+        CompressOptions image_options = options;
+        image_options.channel_count = 1;
+        image_options.is_planar = false;
+        image_options.color_transform = COLOR_TRANSFORM_NONE;
+        append_thumbnail(data, compressed_data, image_options);
+    }
+
+    if (header.flags & FLAG_NEAR_LOSSLESS) {
+        compressed_data.push_back(options.max_error);
+        append_number(compressed_data, max_sample, NEAR_LOSSLESS_DESCRIPTOR_SIZE - 1);
+    }
+
+    compressed_data.insert(compressed_data.end(), payload.begin(), payload.end());
+
+    // The checksum of the whole original (or quantized) data is stored at the end
+    if (options.use_checksum) {
+        append_number(compressed_data, crc32c(samples), CRC_BYTE_COUNT);
+    }
+}
+
+
+void compress_channels(
+    std::span<const std::uint8_t> data,
+    std::vector<std::uint8_t> &compressed_data,
+    const CompressOptions &options,
+    const HuffmanDictionary *dictionary
+) {
+    StreamHeader header;
+    header.flags = FLAG_CHANNELS | FLAG_RANS | (options.use_model ? FLAG_MODEL : 0) | (options.use_rle ? FLAG_RLE : 0) | (options.adapt_scan ? FLAG_ADAPTIVE : 0)
+        | (options.use_checksum ? FLAG_CHECKSUM : 0) | (options.sample_bits > MAX_BYTE_SAMPLE_BITS ? FLAG_SAMPLES_16 : 0)
+        | (options.thumbnail_cell_side != 0 && options.adapt_scan && !data.empty() ? FLAG_THUMBNAIL : 0) | (options.max_error != 0 && !data.empty() ? FLAG_NEAR_LOSSLESS : 0);
+    header.original_size = data.size();
+    header.width = options.adapt_scan ? options.width_value : 0;
+    write_header(header, compressed_data);
+
+    // The thumbnail of the untransformed channels precedes the channels, the channels themselves have none
+    if (header.flags & FLAG_THUMBNAIL) {
+        append_thumbnail(data, compressed_data, options);
+    }
+
+    std::vector<std::uint8_t> quantized_data;
+    std::span<const std::uint8_t> samples = data;
+
+    // The untransformed samples are quantized, since the errors of the transformed channels would add up in the reconstructed ones
+    if (header.flags & FLAG_NEAR_LOSSLESS) {
+        const std::uint16_t max_sample = with_sample_type(options.sample_bits, [&](auto sample) -> std::uint16_t {
+            return quantize_samples<decltype(sample)>(data, options.max_error, quantized_data);
+        });
+        samples = quantized_data;
+        compressed_data.push_back(options.max_error);
+        append_number(compressed_data, max_sample, NEAR_LOSSLESS_DESCRIPTOR_SIZE - 1);
+    }
+
+    if (!samples.empty()) {
+        std::vector<std::vector<std::uint8_t>> planes;
+        std::vector<std::vector<std::uint8_t>> compressed_planes(options.channel_count);
+        CodecStats *const stats = STATS_ACTIVE;
+        std::vector<CodecStats> channel_stats(stats != NULL ? options.channel_count : 0);
+        std::atomic<bool> is_out_of_memory = false;
+        // The channels are lossless single-channel data of their own without any thumbnail
+        CompressOptions channel_options = options;
+        channel_options.channel_count = 1;
+        channel_options.thumbnail_cell_side = 0;
+        channel_options.max_error = 0;
+
+        {
+            STATS_SCOPE(STAGE_CHANNEL_TRANSFORM);
+            split_channels(samples, options.sample_bits, options.channel_count, options.is_planar, options.color_transform, planes);
+        }
+
+        // The channels are independent, so each of them is compressed by its own thread (collecting its own statistics)
+        process_in_parallel(options.channel_count, options.channel_count, [&](const std::uint64_t begin, const std::uint64_t end) {
+            for (std::uint64_t i = begin; i < end; i++) {
+                STATS_REDIRECT(stats != NULL ? &channel_stats[i] : NULL);
+
+                try {
+                    compress_data(planes[i], compressed_planes[i], channel_options, dictionary);
+                }
+                catch (const std::bad_alloc &) {
+                    is_out_of_memory = true;
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+        // The allocation failure is passed to the caller as if the channels were compressed by the current thread
+        if (is_out_of_memory) {
+            throw std::bad_alloc();
+        }
+
+        for (const auto &stats_of_channel: channel_stats) {
+            merge_stats(*stats, stats_of_channel);
+        }
+
+        compressed_data.push_back(options.channel_count);
+        compressed_data.push_back(options.is_planar);
+        compressed_data.push_back(options.color_transform);
+
+        for (const auto &compressed_plane: compressed_planes) {
+            append_number(compressed_data, compressed_plane.size(), CHUNK_SIZE_BYTE_COUNT);
+            compressed_data.insert(compressed_data.end(), compressed_plane.begin(), compressed_plane.end());
+        }
+    }
+
+    // The checksum of the whole original (or quantized) data is stored at the end
+    if (options.use_checksum) {
+        append_number(compressed_data, crc32c(samples), CRC_BYTE_COUNT);
+    }
+}
+
+
+/**
+ * @brief Get the width of the samples of the data in the self-describing format.
+ * 
+ * @param header The header of the compressed data
+ * 
+ * @return The width of the samples (in bits).
+ */
+unsigned get_sample_bits(const StreamHeader &header) {
+    return header.flags & FLAG_SAMPLES_16 ? MAX_SAMPLE_BITS : MAX_BYTE_SAMPLE_BITS;
+}
+
+
+/**
+ * @brief Split the compressed thumbnail from the beginning of the compressed content.
+ * 
+ * @param content The compressed content starting by the thumbnail (the content following it afterwards)
+ * @param cell_side The resulting side of the cells of the image summarized by one pixel of the thumbnail
+ * @param compressed_thumbnail The resulting compressed thumbnail
+ * 
+ * @return True if the content starts by a complete thumbnail with the supported side of the cells, false otherwise.
+ */
+bool split_thumbnail(std::span<const std::uint8_t> &content, unsigned &cell_side, std::span<const std::uint8_t> &compressed_thumbnail) {
+    if (content.size() < THUMBNAIL_DESCRIPTOR_SIZE) {
+        report_error("Invalid compressed data - missing descriptor of the thumbnail");
+        return false;
+    }
+
+    cell_side = content[0];
+    const std::uint64_t thumbnail_size = load_number(content.data() + 1, CHUNK_SIZE_BYTE_COUNT);
+    content = content.subspan(THUMBNAIL_DESCRIPTOR_SIZE);
+
+    if ((cell_side != THUMBNAIL_BLOCK_CELL_SIDE && cell_side != THUMBNAIL_MOSAIC_CELL_SIDE) || thumbnail_size > content.size()) {
+        report_error("Invalid compressed data - invalid descriptor of the thumbnail");
+        return false;
+    }
+
+    compressed_thumbnail = content.first(thumbnail_size);
+    content = content.subspan(thumbnail_size);
+    return true;
+}
+
+
+/**
+ * @brief Read the header of the compressed thumbnail and check that it matches the image.
+ * 
+ * @param compressed_thumbnail The compressed thumbnail
+ * @param header The header of the compressed image
+ * @param pixel_size The size of one pixel of the image (in bytes)
+ * @param cell_side The side of the cells of the image summarized by one pixel of the thumbnail
+ * @param thumbnail_header The resulting header of the thumbnail
+ * 
+ * @return True if the thumbnail is adaptively scanned data of the same samples with the expected width and size, false otherwise.
+ */
+bool read_thumbnail_header(
+    std::span<const std::uint8_t> compressed_thumbnail, 
+    const StreamHeader &header, 
+    const std::uint64_t pixel_size, 
+    const unsigned cell_side, 
+    StreamHeader &thumbnail_header
+) {
+    if (!read_header(compressed_thumbnail, thumbnail_header)) {
+        return false;
+    }
+
+    const std::uint64_t inherited_flags = FLAG_SAMPLES_16 | FLAG_CHANNELS;
+
+    if ((thumbnail_header.flags & (FLAG_CHUNKED | FLAG_DICTIONARY | FLAG_THUMBNAIL)) || !(thumbnail_header.flags & FLAG_ADAPTIVE) 
+        || (thumbnail_header.flags & inherited_flags) != (header.flags & inherited_flags) || header.width == 0 
+        || thumbnail_header.width != get_thumbnail_width(header.width, cell_side) 
+        || thumbnail_header.original_size != get_thumbnail_pixel_count(header.original_size / pixel_size, header.width, cell_side) * pixel_size) {
+        report_error("Invalid compressed data - invalid header of the compressed thumbnail");
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Get the compressed content of the data in the self-describing format, i.e. the data without the header, without the hash of the dictionary,
+ * without the compressed thumbnail and without the checksum of the whole original data.
+ * 
+ * @param compressed_data The compressed data
+ * @param header The header of the compressed data
+ * @param dictionary The dictionary of the code tables given for the decompression (NULL if there is none)
+ * @param payload The resulting compressed content
+ * @param checksum The resulting stored checksum of the whole original data (if the checksums are used)
+ * 
+ * @return True if the compressed data are long enough and they use no dictionary or the given one, false otherwise.
+ */
+bool get_payload(
+    std::span<const std::uint8_t> compressed_data, 
+    const StreamHeader &header, 
+    const HuffmanDictionary *dictionary, 
+    std::span<const std::uint8_t> &payload, 
+    std::uint32_t &checksum
+) {
+    payload = compressed_data.subspan(HEADER_SIZE);
+
+    if (header.flags & FLAG_DICTIONARY) {
+        if (payload.size() < DICTIONARY_HASH_BYTE_COUNT) {
+            report_error("Invalid compressed data - missing hash of the dictionary");
+            return false;
+        }
+
+        const std::uint32_t dictionary_hash = load_number(payload.data(), DICTIONARY_HASH_BYTE_COUNT);
+
+        if (dictionary == NULL) {
+            report_error("The compressed data require the dictionary of the code tables they were compressed with");
+            return false;
+        }
+
+        if (dictionary->get_hash() != dictionary_hash) {
+            report_error("The dictionary differs from the dictionary of the code tables the data were compressed with");
+            return false;
+        }
+
+        payload = payload.subspan(DICTIONARY_HASH_BYTE_COUNT);
+    }
+
+    // The chunks of the chunked data have the thumbnails of their own
+    if ((header.flags & FLAG_THUMBNAIL) && !(header.flags & FLAG_CHUNKED)) {
+        unsigned cell_side;
+        std::span<const std::uint8_t> compressed_thumbnail;
+
+        if (!split_thumbnail(payload, cell_side, compressed_thumbnail)) {
+            return false;
+        }
+    }
+
+    if (!(header.flags & FLAG_CHECKSUM) || (header.flags & FLAG_CHUNKED)) {
+        return true;
+    }
+
+    if (payload.size() < CRC_BYTE_COUNT) {
+        report_error("Invalid compressed data - missing checksum of the original data");
+        return false;
+    }
+
+    checksum = load_number(payload.data() + payload.size() - CRC_BYTE_COUNT, CRC_BYTE_COUNT);
+    payload = payload.first(payload.size() - CRC_BYTE_COUNT);
+    return true;
+}
+
+
+/**
+ * @brief Split the descriptor of the quantization from the beginning of the compressed content of the near-lossless data.
+ *
+ * @param payload The compressed content (the content following the descriptor afterwards)
+ * @param header The header of the compressed data
+ * @param max_error The resulting maximum absolute error of the samples (0 if the data are not quantized)
+ * @param max_sample The resulting maximum sample of the original data
+ *
+ * @return True if the data are not quantized or the content starts by a valid descriptor, false otherwise.
+ */
+bool split_near_lossless_descriptor(std::span<const std::uint8_t> &payload, const StreamHeader &header, unsigned &max_error, std::uint16_t &max_sample) {
+    max_error = 0;
+    max_sample = 0;
+
+    if (!(header.flags & FLAG_NEAR_LOSSLESS)) {
+        return true;
+    }
+
+    if (payload.size() < NEAR_LOSSLESS_DESCRIPTOR_SIZE) {
+        report_error("Invalid compressed data - missing descriptor of the quantization");
+        return false;
+    }
+
+    max_error = payload[0];
+    max_sample = load_number(payload.data() + 1, NEAR_LOSSLESS_DESCRIPTOR_SIZE - 1);
+    payload = payload.subspan(NEAR_LOSSLESS_DESCRIPTOR_SIZE);
+
+    if (max_error == 0 || (get_sample_bits(header) <= MAX_BYTE_SAMPLE_BITS && max_sample >= 1 << MAX_BYTE_SAMPLE_BITS)) {
+        report_error("Invalid compressed data - invalid descriptor of the quantization");
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Reconstruct the decompressed quantized samples of the near-lossless data in place (if the data are quantized).
+ *
+ * @param decompressed_data The decompressed data
+ * @param header The header of the compressed data
+ * @param max_error The maximum absolute error of the samples (0 if the data are not quantized)
+ * @param max_sample The maximum sample of the original data
+ */
+void reconstruct_samples(std::span<std::uint8_t> decompressed_data, const StreamHeader &header, const unsigned max_error, const std::uint16_t max_sample) {
+    if (max_error == 0) {
+        return;
+    }
+
+    with_sample_type(get_sample_bits(header), [&](auto sample) {
+        dequantize_samples<decltype(sample)>(decompressed_data, max_error, max_sample);
+    });
+}
+
+
+/**
+ * @brief Compare the checksum of the decompressed data with the stored checksum of the original data (if the checksums are used).
+ * 
+ * @param decompressed_data The decompressed data
+ * @param header The header of the compressed data
+ * @param checksum The stored checksum of the original data
+ * 
+ * @return True if the checksums are not used or they match, false otherwise.
+ */
+bool check_data_checksum(std::span<const std::uint8_t> decompressed_data, const StreamHeader &header, const std::uint32_t checksum) {
+    if (!(header.flags & FLAG_CHECKSUM) || (header.flags & FLAG_CHUNKED) || crc32c(decompressed_data) == checksum) {
+        return true;
+    }
+
+    report_error("Invalid compressed data - checksum mismatch of the decompressed data");
+    return false;
+}
+
+
+/**
+ * @brief Split the chunks of the chunked compressed data.
+ * 
+ * @param compressed_chunks The compressed chunks (each of them preceded by its size)
+ * @param chunks The resulting compressed chunks (each of them with its own header)
+ * 
+ * @return True if the compressed data consist of complete chunks, false otherwise.
+ */
+bool split_chunks(std::span<const std::uint8_t> compressed_chunks, std::vector<std::span<const std::uint8_t>> &chunks) {
+    while (!compressed_chunks.empty()) {
+        if (compressed_chunks.size() < CHUNK_SIZE_BYTE_COUNT) {
+            report_error("Invalid compressed data - incomplete size of the compressed chunk");
+            return false;
+        }
+
+        const std::uint64_t chunk_size = load_number(compressed_chunks.data(), CHUNK_SIZE_BYTE_COUNT);
+        compressed_chunks = compressed_chunks.subspan(CHUNK_SIZE_BYTE_COUNT);
+
+        if (chunk_size > compressed_chunks.size()) {
+            report_error("Invalid compressed data - unexpected end of the compressed chunk");
+            return false;
+        }
+
+        chunks.push_back(compressed_chunks.first(chunk_size));
+        compressed_chunks = compressed_chunks.subspan(chunk_size);
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Get the largest size of the original data the compressed data can hold.
+ * 
+ * @note The adaptively scanned data consist of at most BLOCK_SIZE samples per MIN_COMPRESSED_BLOCK_SIZE bytes of their content and the chunked data
+ * hold at most the sum of the sizes held by their chunks. The statically scanned data split into the chunks sharing the code table hold at most
+ * one chunk per stored chunk size and the uncompressed statically scanned data hold their content. The other statically scanned data are not bounded,
+ * since a single solid block or a single run of the RLE can hold any number of samples (the memory for them is allocated as they are decoded).
+ * 
+ * @param compressed_data The compressed data
+ * @param header The header of the compressed data
+ * 
+ * @return The largest size of the original data (the size specified in the header if it is not bounded).
+ */
+std::uint64_t get_max_original_size(std::span<const std::uint8_t> compressed_data, const StreamHeader &header) {
+    auto content = compressed_data.subspan(std::min(compressed_data.size(), static_cast<std::uint64_t>(HEADER_SIZE)));
+
+    if (header.flags & FLAG_CHUNKED) {
+        std::vector<std::span<const std::uint8_t>> chunks;
+        std::uint64_t max_size = 0;
+
+        if (header.flags & FLAG_DICTIONARY) {
+            content = content.subspan(std::min(content.size(), static_cast<std::uint64_t>(DICTIONARY_HASH_BYTE_COUNT)));
+        }
+
+        if (!split_chunks(content, chunks)) {
+            return 0;
+        }
+
+        for (const auto &chunk: chunks) {
+            StreamHeader chunk_header;
+
+            if (!read_header(chunk, chunk_header)) {
+                return 0;
+            }
+
+            max_size += std::min(chunk_header.original_size, get_max_original_size(chunk, chunk_header));
+        }
+
+        return max_size;
+    }
+
+    const std::uint64_t sample_size = get_sample_bits(header) > MAX_BYTE_SAMPLE_BITS ? 2 : 1;
+
+    if (header.flags & FLAG_ADAPTIVE) {
+        const std::uint64_t max_block_count = content.size() / MIN_COMPRESSED_BLOCK_SIZE;
+        return std::min(header.original_size, max_block_count * BLOCK_SIZE * sample_size);
+    }
+
+    // The channels are bounded by their own headers
+    if (header.flags & FLAG_CHANNELS) {
+        return header.original_size;
+    }
+
+    // The payload of the statically scanned data follows the hash of the dictionary and the descriptor of the quantization and precedes the checksum
+    const std::uint64_t payload_offset = (header.flags & FLAG_DICTIONARY ? DICTIONARY_HASH_BYTE_COUNT : 0) 
+        + (header.flags & FLAG_NEAR_LOSSLESS ? NEAR_LOSSLESS_DESCRIPTOR_SIZE : 0);
+    const std::uint64_t checksum_size = header.flags & FLAG_CHECKSUM ? CRC_BYTE_COUNT : 0;
+
+    if (content.size() <= payload_offset + checksum_size) {
+        return header.original_size;
+    }
+
+    const auto payload = content.subspan(payload_offset, content.size() - payload_offset - checksum_size);
+
+    if (payload.front() == UNCOMPRESSED) {
+        return std::min(header.original_size, static_cast<std::uint64_t>(payload.size() - 1));
+    }
+
+    if (payload.front() == SHARED_TABLE_CHUNKS_COMPRESSED && payload.size() >= 1 + CHUNK_SIZE_BYTE_COUNT) {
+        const std::uint64_t chunk_val_count = std::min(load_number(payload.data() + 1, CHUNK_SIZE_BYTE_COUNT), STATIC_CHUNK_SIZE / sample_size);
+        const std::uint64_t max_chunk_count = (payload.size() - 1 - CHUNK_SIZE_BYTE_COUNT) / CHUNK_SIZE_BYTE_COUNT;
+        return std::min(header.original_size, chunk_val_count * max_chunk_count * sample_size);
+    }
+
+    return header.original_size;
+}
+
+
+/**
+ * @brief Read the header of the compressed data and check that the compressed data can hold the original data of the size specified in the header,
+ * so that no memory is allocated for the decompressed data of a corrupted header.
+ * 
+ * @param compressed_data The compressed data
+ * @param header The resulting header
+ * 
+ * @return True if the compressed data start with a valid header whose size of the original data they can hold, false otherwise.
+ */
+bool read_bounded_header(std::span<const std::uint8_t> compressed_data, StreamHeader &header) {
+    if (!read_header(compressed_data, header)) {
+        return false;
+    }
+
+    if (header.original_size > get_max_original_size(compressed_data, header)) {
+        report_error("Invalid compressed data - the size specified in the compressed data header exceeds the size the compressed data can hold");
+        return false;
+    }
+
+    return true;
+}
+
+
+bool get_decompressed_size(std::span<const std::uint8_t> compressed_data, std::uint64_t &decompressed_data_size) {
+    StreamHeader header;
+
+    if (!read_bounded_header(compressed_data, header)) {
+        return false;
+    }
+
+    decompressed_data_size = header.original_size;
+    return true;
+}
+
+
+/**
+ * @brief Read the header of the chunk of the chunked compressed data.
+ * 
+ * @param chunk The compressed chunk
+ * @param remaining_size The size of the decompressed data not covered by the preceding chunks
+ * @param header The resulting header of the chunk
+ * 
+ * @return True if the chunk has a valid header, false otherwise.
+ */
+bool read_chunk_header(std::span<const std::uint8_t> chunk, const std::uint64_t remaining_size, StreamHeader &header) {
+    if (!read_header(chunk, header)) {
+        return false;
+    }
+
+    if ((header.flags & FLAG_CHUNKED) || header.original_size > remaining_size) {
+        report_error("Invalid compressed data - invalid header of the compressed chunk");
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Decompress the chunks of the chunked compressed data, each chunk is decompressed to its part of the decompressed data.
+ * 
+ * @param compressed_chunks The compressed chunks (each of them preceded by its size)
+ * @param decompressed_data The memory for the resulting decompressed data
+ * @param thread_count The maximum number of threads decompressing each chunk
+ * @param dictionary The dictionary of the code tables (NULL if there is none)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+bool decompress_chunks(
+    std::span<const std::uint8_t> compressed_chunks, 
+    std::span<std::uint8_t> decompressed_data, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+) {
+    std::vector<std::span<const std::uint8_t>> chunks;
+    std::uint64_t decompressed_data_offset = 0;
+
+    if (!split_chunks(compressed_chunks, chunks)) {
+        return false;
+    }
+
+    for (const auto &chunk: chunks) {
+        StreamHeader header;
+
+        if (!read_chunk_header(chunk, decompressed_data.size() - decompressed_data_offset, header)
+            || !decompress_data(chunk, decompressed_data.subspan(decompressed_data_offset, header.original_size), thread_count, dictionary)) {
+            return false;
+        }
+
+        decompressed_data_offset += header.original_size;
+    }
+
+    if (decompressed_data_offset != decompressed_data.size()) {
+        report_error("Invalid compressed data - the size of the decompressed chunks is lower than the size specified in the compressed data header");
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Decompress the channels of the multi-channel compressed data, each channel is decompressed by its own thread.
+ *
+ * @param compressed_channels The descriptor of the channels followed by the compressed channels (each of them preceded by its size)
+ * @param header The header of the multi-channel compressed data
+ * @param decompressed_data The memory for the resulting decompressed data
+ * @param thread_count The maximum number of threads decompressing the channels (shared among them)
+ * @param dictionary The dictionary of the code tables (NULL if there is none)
+ *
+ * @return True in case of successful decompression, false otherwise.
+ */
+bool decompress_channels(
+    std::span<const std::uint8_t> compressed_channels,
+    const StreamHeader &header,
+    std::span<std::uint8_t> decompressed_data,
+    const unsigned thread_count,
+    const HuffmanDictionary *dictionary
+) {
+    if (compressed_channels.size() < CHANNEL_DESCRIPTOR_SIZE) {
+        report_error("Invalid compressed data - missing descriptor of the channels");
+        return false;
+    }
+
+    const unsigned channel_count = compressed_channels[0];
+    const unsigned layout = compressed_channels[1];
+    const unsigned color_transform = compressed_channels[2];
+    const unsigned sample_bits = get_sample_bits(header);
+
+    if (channel_count < 2 || channel_count > MAX_CHANNEL_COUNT || layout > 1 || color_transform >= COLOR_TRANSFORM_COUNT
+        || (color_transform != COLOR_TRANSFORM_NONE && channel_count < COLOR_TRANSFORM_CHANNEL_COUNT)
+        || decompressed_data.size() % (channel_count * (sample_bits > MAX_BYTE_SAMPLE_BITS ? 2 : 1)) != 0) {
+        report_error("Invalid compressed data - invalid descriptor of the channels");
+        return false;
+    }
+
+    std::vector<std::span<const std::uint8_t>> channels;
+
+    if (!split_chunks(compressed_channels.subspan(CHANNEL_DESCRIPTOR_SIZE), channels)) {
+        return false;
+    }
+
+    if (channels.size() != channel_count) {
+        report_error("Invalid compressed data - the number of the compressed channels differs from the channel count");
+        return false;
+    }
+
+    const std::uint64_t plane_size = decompressed_data.size() / channel_count;
+
+    for (const auto &channel: channels) {
+        StreamHeader channel_header;
+
+        if (!read_bounded_header(channel, channel_header)) {
+            return false;
+        }
+
+        if ((channel_header.flags & (FLAG_CHUNKED | FLAG_CHANNELS)) || channel_header.original_size != plane_size
+            || (channel_header.flags & FLAG_SAMPLES_16) != (header.flags & FLAG_SAMPLES_16)) {
+            report_error("Invalid compressed data - invalid header of the compressed channel");
+            return false;
+        }
+    }
+
+    std::vector<std::vector<std::uint8_t>> planes(channel_count);
+    const unsigned channel_thread_count = std::max(1u, thread_count / channel_count);
+    CodecStats *const stats = STATS_ACTIVE;
+    std::vector<CodecStats> channel_stats(stats != NULL ? channel_count : 0);
+    std::atomic<bool> is_out_of_memory = false;
+
+    const bool is_successful = process_in_parallel(channel_count, channel_count, [&](const std::uint64_t begin, const std::uint64_t end) {
+        for (std::uint64_t i = begin; i < end; i++) {
+            STATS_REDIRECT(stats != NULL ? &channel_stats[i] : NULL);
+
+            try {
+                planes[i].resize(plane_size);
+
+                if (!decompress_data(channels[i], std::span<std::uint8_t>(planes[i]), channel_thread_count, dictionary)) {
+                    return false;
+                }
+            }
+            catch (const std::bad_alloc &) {
+                is_out_of_memory = true;
+                return false;
+            }
         }
+
+        return true;
+    });
+
+    if (is_out_of_memory) {
+        throw std::bad_alloc();
     }
 
-    huffman_encoder.finalize_encoding(compressed_data);
+    for (const auto &stats_of_channel: channel_stats) {
+        merge_stats(*stats, stats_of_channel);
+    }
 
-    // In case it is not possible to achieve compression, keep the data uncompressed
-    if (compressed_data.size() >= data.size() + 1) {
-        std::copy(data.begin(), data.end(), compressed_data.begin() + 1);
-        compressed_data.resize(data.size() + 1);
-        compressed_data[0] = UNCOMPRESSED;
+    if (!is_successful) {
+        return false;
     }
+
+    STATS_SCOPE(STAGE_CHANNEL_TRANSFORM);
+    merge_channels(planes, sample_bits, layout == 1, color_transform, decompressed_data);
+    return true;
 }
 
 
-/**
- * @brief Decompress the data block compressed using canonical Huffman encoding.
- * 
- * @param decompressed_data The resulting decompressed data block
- * @param huffman_decoder The canonical Huffman code decoder
- * @param use_model Indicates whether the adjacent value difference model was used for original data block preprocessing
- * @param use_rle Indicates whether the RLE was used for original data block preprocessing
- * @param block_original_val_count The number of original values in data block (0 by default means that all the remaining data to be decompressed are in the same block)
- *
- * @return True in case of successful decompression, false otherwise.
- */
-bool decompress(
+bool decompress_data(
+    std::span<const std::uint8_t> compressed_data, 
     std::vector<std::uint8_t> &decompressed_data, 
-    HuffmanDecoder &huffman_decoder, 
-    const bool use_model, 
-    const bool use_rle, 
-    const std::uint16_t block_original_val_count = 0
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
 ) {
-    if (huffman_decoder.is_source_proccessed()) {
-        std::cerr << "Invalid compressed data - unexpected end of the compressed data, expected compression flag" << std::endl;
+    StreamHeader header;
+    std::span<const std::uint8_t> payload;
+    std::uint32_t checksum = 0;
+    unsigned max_error;
+    std::uint16_t max_sample;
+
+    if (!read_bounded_header(compressed_data, header) || !get_payload(compressed_data, header, dictionary, payload, checksum) 
+        || !split_near_lossless_descriptor(payload, header, max_error, max_sample)) {
         return false;
     }
 
-    auto current_data_it = huffman_decoder.get_current_source_it();
-
-    // If the data in the compressed data block are kept uncompressed, use number of original values in data block to determine how many uncompressed symbols to load from source
-    if (*current_data_it == UNCOMPRESSED) {
-        if (block_original_val_count == 0) {
-            decompressed_data.assign(current_data_it + 1, huffman_decoder.get_source_end_it());
-        }
-        else {
-            decompressed_data.assign(current_data_it + 1, current_data_it + 1 + block_original_val_count);
-            huffman_decoder.advance_source(1 + block_original_val_count);
+    // The static scanning without chunks produces a vector anyway, so there is no need to decompress it to the preallocated buffer and copy it
+    if (!(header.flags & (FLAG_ADAPTIVE | FLAG_CHUNKED | FLAG_CHANNELS)) && header.original_size > 0) {
+        if (!decompress_statically(
+            payload, decompressed_data, header.original_size, get_sample_bits(header), header.flags & FLAG_MODEL, header.flags & FLAG_RLE, thread_count, 
+            dictionary
+        ) || !check_data_checksum(decompressed_data, header, checksum)) {
+            return false;
         }
 
+        reconstruct_samples(decompressed_data, header, max_error, max_sample);
         return true;
     }
 
-    huffman_decoder.advance_source(1);
+    decompressed_data.resize(header.original_size);
+    return decompress_data(compressed_data, std::span<std::uint8_t>(decompressed_data), thread_count, dictionary);
+}
+
 
-    if (!huffman_decoder.initialize_decoding()) {
+bool decompress_data(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<std::uint8_t> decompressed_data, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+) {
+    StreamHeader header;
+    std::span<const std::uint8_t> payload;
+    std::uint32_t checksum = 0;
+    unsigned max_error;
+    std::uint16_t max_sample;
+
+    if (!read_bounded_header(compressed_data, header) || !get_payload(compressed_data, header, dictionary, payload, checksum) 
+        || !split_near_lossless_descriptor(payload, header, max_error, max_sample)) {
         return false;
     }
 
-    decompressed_data.clear();
-
-    if (!huffman_decoder.decode_data_by_end_symbol(decompressed_data)) {
+    if (header.original_size != decompressed_data.size()) {
+        report_error("Invalid decompressed data buffer - its size differs from the size specified in the compressed data header");
         return false;
     }
 
-    if (use_rle) {
-        decompressed_data = decode_rle(decompressed_data.begin(), decompressed_data.end(), DEFAULT_MARKER);
+    const bool use_model = header.flags & FLAG_MODEL;
+    const bool use_rle = header.flags & FLAG_RLE;
+
+    if (header.flags & FLAG_CHUNKED) {
+        return decompress_chunks(payload, decompressed_data, thread_count, dictionary);
     }
 
-    if (use_model) {
-        decompressed_data = decode_adj_val_diff(decompressed_data.begin(), decompressed_data.end());
+    if (header.original_size == 0) {
+        return check_data_checksum(decompressed_data, header, checksum);
     }
 
-    return true;
-}
+    if (header.flags & FLAG_CHANNELS) {
+        if (!decompress_channels(payload, header, decompressed_data, thread_count, dictionary)) {
+            return false;
+        }
+    }
+    else if (header.flags & FLAG_ADAPTIVE) {
+        if (!decompress_adaptively(
+            payload, decompressed_data, header.width, get_sample_bits(header), header.flags & FLAG_FRAMES, use_model, use_rle, header.flags & FLAG_CHECKSUM, 
+            dictionary
+        )) {
+            return false;
+        }
+    }
+    else {
+        if (!decompress_statically(payload, decompressed_data, get_sample_bits(header), use_model, use_rle, thread_count, dictionary)) {
+            return false;
+        }
+    }
 
+    // The checksum covers the quantized samples of the near-lossless data, so they are reconstructed once it is checked
+    if (!check_data_checksum(decompressed_data, header, checksum)) {
+        return false;
+    }
 
-void compress_statically(const std::vector<std::uint8_t> &data, std::vector<std::uint8_t> &compressed_data, const bool use_model, const bool use_rle) {
-    auto huffman_encoder = HuffmanEncoder();
-    compress(data, huffman_encoder, compressed_data, use_model, use_rle);
+    reconstruct_samples(decompressed_data, header, max_error, max_sample);
+    return true;
 }
 
 
-bool decompress_statically(
-    std::vector<std::uint8_t>::const_iterator first, 
-    std::vector<std::uint8_t>::const_iterator last, 
-    std::vector<std::uint8_t> &decompressed_data, 
-    const bool use_model, 
-    const bool use_rle
+bool decompress_thumbnail(
+    std::span<const std::uint8_t> compressed_data, 
+    std::vector<std::uint8_t> &thumbnail, 
+    std::uint64_t &thumbnail_width, 
+    unsigned &cell_side
 ) {
-    auto huffman_decoder = HuffmanDecoder();
-    huffman_decoder.set_source(first, last);
-    return decompress(decompressed_data, huffman_decoder, use_model, use_rle);
-}
+    StreamHeader header;
 
+    if (!read_header(compressed_data, header)) {
+        return false;
+    }
 
-/**
- * @brief Transpose the block in place.
- * 
- * @param block The block to be transposed
- */
-void transpose_block_in_place(std::vector<std::uint8_t> &block) {
-    for (std::uint8_t i = 0; i < BLOCK_SIDE_SIZE; i++) {
-        std::uint16_t row_offset = i * BLOCK_SIDE_SIZE;
+    // The thumbnail precedes the blocks, so only the hash of the dictionary is skipped without the dictionary itself
+    auto content = compressed_data.subspan(HEADER_SIZE);
 
-        for (std::uint8_t j = i + 1; j < BLOCK_SIDE_SIZE; j++) {
-            std::swap(block[j + row_offset], block[i + j * BLOCK_SIDE_SIZE]);
+    if (header.flags & FLAG_DICTIONARY) {
+        if (content.size() < DICTIONARY_HASH_BYTE_COUNT) {
+            report_error("Invalid compressed data - missing hash of the dictionary");
+            return false;
         }
-    }
-}
-
 
-/**
- * @brief Serialize the data block.
- * 
- * @param deserialized_block The deserialized data (image) block
- * @param is_transposed Indicates whether the deserialized data block is transposed
- * @param block_val_count The number of values (bytes) in the data block
- * @param block_width The deserialized data block width
- * @param block_height The deserialized data block height
- * @param serialized_block The resulting serialized data block
- */
-void serialize_block(
-    const std::vector<std::uint8_t> &deserialized_block, 
-    const bool is_transposed, 
-    const std::uint16_t block_val_count, 
-    const std::uint8_t block_width, 
-    const std::uint8_t block_height, 
-    std::vector<std::uint8_t> &serialized_block
-) {
-    if (!is_transposed) {
-        for (std::uint8_t i = 0; i < block_height; i++) {
-            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
-            std::uint16_t serialized_block_offset = i * block_width;
+        content = content.subspan(DICTIONARY_HASH_BYTE_COUNT);
+    }
 
-            for (std::uint8_t j = 0; j < block_width; j++) {
-                // Stop when all the values are processed (for the case when the data does not fill the whole block)
-                if (j + serialized_block_offset >= block_val_count) {
-                    break;
-                }
+    // The chunks are the strips of the whole rows of the cells, so their thumbnails are joined
+    if (header.flags & FLAG_CHUNKED) {
+        std::vector<std::span<const std::uint8_t>> chunks;
 
-                serialized_block[j + serialized_block_offset] = deserialized_block[j + deserialized_block_offset];
-            }
+        if (!split_chunks(content, chunks)) {
+            return false;
         }
-    }
-    else {
-        // The number of block unshortened rows (in the case when the data does not fill the whole block the transposed block may have the last few rows 1 value shorter)
-        std::uint8_t num_of_orig_width_rows = block_val_count % block_height;
 
-        if (num_of_orig_width_rows == 0) {
-            num_of_orig_width_rows = block_height;
+        if (chunks.empty()) {
+            report_error("The compressed data contain no thumbnail");
+            return false;
         }
 
-        // Serialize unshortened lines
-        for (std::uint8_t i = 0; i < num_of_orig_width_rows; i++) {
-            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
-            std::uint16_t serialized_block_offset = i * block_width;
+        for (std::uint64_t i = 0; i < chunks.size(); i++) {
+            std::uint64_t chunk_thumbnail_width;
+            unsigned chunk_cell_side;
 
-            for (std::uint8_t j = 0; j < block_width; j++) {
-                serialized_block[j + serialized_block_offset] = deserialized_block[j + deserialized_block_offset];
+            if (!decompress_thumbnail(chunks[i], thumbnail, chunk_thumbnail_width, chunk_cell_side)) {
+                return false;
+            }
+
+            if (i > 0 && (chunk_thumbnail_width != thumbnail_width || chunk_cell_side != cell_side)) {
+                report_error("Invalid compressed data - the thumbnails of the chunks differ in their width or scale");
+                return false;
             }
+
+            thumbnail_width = chunk_thumbnail_width;
+            cell_side = chunk_cell_side;
         }
 
-        std::uint8_t shorten_block_width = block_width - 1;
+        return true;
+    }
 
-        // Serialize shortened rows
-        for (std::uint8_t i = num_of_orig_width_rows; i < block_height; i++) {
-            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
-            std::uint16_t serialized_block_offset = i * shorten_block_width;
+    if (!(header.flags & FLAG_THUMBNAIL)) {
+        report_error("The compressed data contain no thumbnail");
+        return false;
+    }
 
-            for (std::uint8_t j = 0; j < shorten_block_width; j++) {
-                serialized_block[j + serialized_block_offset] = deserialized_block[j + deserialized_block_offset];
-            }
-        }
+    std::span<const std::uint8_t> compressed_thumbnail;
+    StreamHeader thumbnail_header;
+    std::vector<std::uint8_t> decompressed_thumbnail;
+
+    if (!split_thumbnail(content, cell_side, compressed_thumbnail)) {
+        return false;
+    }
+
+    // The channel count of the multi-channel data is the first byte of their descriptor following the thumbnail (and the descriptor of the quantization)
+    const std::uint64_t channel_count_offset = header.flags & FLAG_NEAR_LOSSLESS ? NEAR_LOSSLESS_DESCRIPTOR_SIZE : 0;
+    const std::uint64_t channel_count = header.flags & FLAG_CHANNELS ? (content.size() <= channel_count_offset ? 0 : content[channel_count_offset]) : 1;
+    const std::uint64_t pixel_size = channel_count * (get_sample_bits(header) > MAX_BYTE_SAMPLE_BITS ? 2 : 1);
+
+    if (pixel_size == 0 || !read_thumbnail_header(compressed_thumbnail, header, pixel_size, cell_side, thumbnail_header) 
+        || !decompress_data(compressed_thumbnail, decompressed_thumbnail, 1, NULL)) {
+        return false;
     }
+
+    thumbnail.insert(thumbnail.end(), decompressed_thumbnail.begin(), decompressed_thumbnail.end());
+    thumbnail_width = thumbnail_header.width;
+    return true;
 }
 
 
-/**
- * @brief Deserialize the data block.
- * 
- * @param serialized_block The serialized data (image) block
- * @param is_transposed Indicates whether the deserialized data block is transposed
- * @param block_val_count The number of values (bytes) in the data block
- * @param block_width The deserialized data block width
- * @param block_height The deserialized data block height
- * @param deserialized_block The resulting deserialized data block
- */
-void deserialize_block(
-    const std::vector<std::uint8_t> &serialized_block, 
-    const bool is_transposed, 
-    const std::uint16_t block_val_count, 
-    const std::uint8_t block_width, 
-    const std::uint8_t block_height, 
-    std::vector<std::uint8_t> &deserialized_block
-) {
-    if (!is_transposed) {
-        for (std::uint8_t i = 0; i < block_height; i++) {
-            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
-            std::uint16_t serialized_block_offset = i * block_width;
+bool verify_data(std::span<const std::uint8_t> compressed_data, const unsigned thread_count, const HuffmanDictionary *dictionary) {
+    StreamHeader header;
+    std::span<const std::uint8_t> payload;
+    std::uint32_t checksum = 0;
+    unsigned max_error;
+    std::uint16_t max_sample;
 
-            for (std::uint8_t j = 0; j < block_width; j++) {
-                // Stop when all the values are processed (for the case when the data does not fill the whole block)
-                if (j + serialized_block_offset >= block_val_count) {
-                    break;
-                }
+    if (!read_bounded_header(compressed_data, header) || !get_payload(compressed_data, header, dictionary, payload, checksum) 
+        || !split_near_lossless_descriptor(payload, header, max_error, max_sample)) {
+        return false;
+    }
 
-                deserialized_block[j + deserialized_block_offset] = serialized_block[j + serialized_block_offset];
-            }
+    // The thumbnail is verified as the compressed data of its own
+    if ((header.flags & FLAG_THUMBNAIL) && !(header.flags & FLAG_CHUNKED)) {
+        std::vector<std::uint8_t> thumbnail;
+        std::uint64_t thumbnail_width;
+        unsigned cell_side;
+
+        if (!decompress_thumbnail(compressed_data, thumbnail, thumbnail_width, cell_side)) {
+            return false;
         }
     }
-    else {
-        // The number of block unshortened rows (in the case when the data does not fill the whole block the transposed block may have the last few rows 1 value shorter)
-        std::uint8_t num_of_orig_width_rows = block_val_count % block_height;
 
-        if (num_of_orig_width_rows == 0) {
-            num_of_orig_width_rows = block_height;
+    // The chunks are independent, so they are checked in parallel
+    if (header.flags & FLAG_CHUNKED) {
+        std::vector<std::span<const std::uint8_t>> chunks;
+        std::uint64_t decompressed_data_size = 0;
+
+        if (!split_chunks(payload, chunks)) {
+            return false;
         }
 
-        // Deserialize unshortened lines
-        for (std::uint8_t i = 0; i < num_of_orig_width_rows; i++) {
-            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
-            std::uint16_t serialized_block_offset = i * block_width;
+        for (const auto &chunk: chunks) {
+            StreamHeader chunk_header;
 
-            for (std::uint8_t j = 0; j < block_width; j++) {
-                deserialized_block[j + deserialized_block_offset] = serialized_block[j + serialized_block_offset];
+            if (!read_chunk_header(chunk, header.original_size - decompressed_data_size, chunk_header)) {
+                return false;
             }
+
+            decompressed_data_size += chunk_header.original_size;
         }
 
-        std::uint8_t shorten_block_width = block_width - 1;
+        if (decompressed_data_size != header.original_size) {
+            report_error("Invalid compressed data - the size of the decompressed chunks is lower than the size specified in the compressed data header");
+            return false;
+        }
 
-        // deserialize shortened lines
-        for (std::uint8_t i = num_of_orig_width_rows; i < block_height; i++) {
-            std::uint16_t deserialized_block_offset = i * BLOCK_SIDE_SIZE;
-            std::uint16_t serialized_block_offset = i * shorten_block_width;
+        return process_in_parallel(chunks.size(), thread_count, [&](const std::uint64_t begin, const std::uint64_t end) {
+            for (std::uint64_t i = begin; i < end; i++) {
+                if (!verify_data(chunks[i], 1, dictionary)) {
+                    return false;
+                }
+            }
 
-            for (std::uint8_t j = 0; j < shorten_block_width; j++) {
-                deserialized_block[j + deserialized_block_offset] = serialized_block[j + serialized_block_offset];
+            return true;
+        });
+    }
+
+    // The blocks with the checksums are separable without decoding, so their checksums are checked and they are decoded in parallel
+    if ((header.flags & FLAG_ADAPTIVE) && (header.flags & FLAG_CHECKSUM) && !(header.flags & FLAG_CHANNELS) && header.original_size > 0) {
+        std::vector<BlockRecord> block_records;
+        std::vector<std::uint8_t> decompressed_data(header.original_size);
+        std::atomic<std::uint64_t> decompressed_val_count = 0;
+
+        if (!split_block_records(payload, block_records)) {
+            return false;
+        }
+
+        const bool is_successful = process_in_parallel(block_records.size(), thread_count, [&](const std::uint64_t begin, const std::uint64_t end) {
+            std::uint64_t range_val_count;
+
+            if (!with_sample_type(get_sample_bits(header), [&](auto sample) {
+                return decompress_block_records<decltype(sample)>(
+                    std::span<const BlockRecord>(block_records).subspan(begin, end - begin), 
+                    begin, 
+                    decompressed_data, 
+                    header.width, 
+                    header.flags & FLAG_MODEL, 
+                    header.flags & FLAG_RLE, 
+                    dictionary, 
+                    range_val_count
+                );
+            })) {
+                return false;
             }
+
+            decompressed_val_count += range_val_count;
+            return true;
+        });
+
+        if (!is_successful) {
+            return false;
+        }
+
+        if (decompressed_val_count * (get_sample_bits(header) > MAX_BYTE_SAMPLE_BITS ? 2 : 1) != header.original_size) {
+            report_error("Invalid compressed data - the size of the decompressed data differs from the size specified in the compressed data header");
+            return false;
         }
+
+        return check_data_checksum(decompressed_data, header, checksum);
     }
+
+    std::vector<std::uint8_t> decompressed_data;
+    return decompress_data(compressed_data, decompressed_data, thread_count, dictionary);
 }
 
 
-void compress_adaptively(
-    const std::vector<std::uint8_t> &data, 
-    std::vector<std::uint8_t> &compressed_data, 
+/**
+ * @brief Re-encode the blocks of the adaptively scanned samples with the checksums intersecting the region by its new samples.
+ * 
+ * @param compressed_data The compressed blocks each of which is preceded by its size and its checksum
+ * @param region The new samples of the region row by row (the 16-bit samples are stored in little endian)
+ * @param original_data_size The number of the samples of the whole data
+ * @param data_width The width of data (2D image) in samples
+ * @param region_horizontal_offset The horizontal position of the region in the data
+ * @param region_vertical_offset The vertical position of the region in the data
+ * @param region_width The width of the region
+ * @param region_height The height of the region
+ * @param use_model Indicates whether the adjacent value difference model is used for each data block preprocessing
+ * @param use_rle Indicates whether the RLE is used for each data block preprocessing
+ * @param effort_level The effort level of the encoder search
+ * @param dictionary The dictionary of the code tables the blocks are encoded by (NULL if there is none)
+ * @param thumbnail_cell_side The side of the cells summarized by the thumbnail of the data (0 if there is none)
+ * @param updated_data Buffer to which the compressed blocks with the re-encoded ones are appended
+ * @param original_region Buffer to which the original samples of the region are appended (in the layout of the new samples)
+ * @param region_thumbnail Buffer to which the new mean samples of the cells intersecting the region are appended row by row
+ * (if the data have the thumbnail)
+ * 
+ * @return True if the re-encoded blocks are successfully decompressed, false otherwise.
+ */
+template<typename Sample>
+bool update_sample_blocks(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<const std::uint8_t> region, 
+    const std::uint64_t original_data_size, 
     const std::uint64_t data_width, 
+    const std::uint64_t region_horizontal_offset, 
+    const std::uint64_t region_vertical_offset, 
+    const std::uint64_t region_width, 
+    const std::uint64_t region_height, 
     const bool use_model, 
-    const bool use_rle
+    const bool use_rle, 
+    const unsigned effort_level, 
+    const HuffmanDictionary *dictionary, 
+    const unsigned thumbnail_cell_side, 
+    std::vector<std::uint8_t> &updated_data, 
+    std::vector<std::uint8_t> &original_region, 
+    std::vector<std::uint8_t> &region_thumbnail
 ) {
-    const std::uint64_t original_data_size = data.size();
-    compressed_data.resize(16);
-
-    // Store the original data size and its width to the beginning of the compressed data
-    for (std::uint8_t i = 0; i < 8; i++) {
-        compressed_data[i] = original_data_size >> i * BYTE_BIT_LENGTH;
-        compressed_data[i + 8] = data_width >> i * BYTE_BIT_LENGTH;
-    }
-
     const std::uint64_t data_height = original_data_size / data_width + (original_data_size % data_width != 0 ? 1 : 0);
-    std::vector<std::uint8_t> deserialized_block(BLOCK_SIZE);
-    std::vector<std::uint8_t> serialized_block, compressed_block_h, compressed_block_v;
-    std::uint64_t data_horizontal_offset = 0;
-    std::uint64_t data_vertical_offset = 0;
-    std::uint64_t remaining_decompressed_data_size = original_data_size;
-    auto huffman_encoder = HuffmanEncoder();
-
-    while (remaining_decompressed_data_size > 0) {
-        std::uint64_t data_block_offset = data_horizontal_offset + data_vertical_offset * data_width;
-        std::uint8_t block_width = std::min(static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), data_width - data_horizontal_offset);
-        std::uint8_t block_height = std::min(static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), data_height - data_vertical_offset);
-        std::uint16_t block_val_count = block_height * block_width;
+    const std::uint64_t blocks_per_row = data_width / BLOCK_SIDE_SIZE + (data_width % BLOCK_SIDE_SIZE != 0 ? 1 : 0);
+    const std::uint64_t region_horizontal_end = region_horizontal_offset + region_width;
+    const std::uint64_t region_vertical_end = region_vertical_offset + region_height;
+    const SearchParams &search_params = get_search_params(effort_level);
+    std::vector<BlockRecord> block_records;
+    std::vector<Sample> region_samples;
+    std::vector<Sample> original_region_samples;
+    std::vector<Sample> serialized_block;
+    std::vector<Sample> deserialized_block(BLOCK_SIZE);
+    auto buffers = BlockBuffers<Sample>();
+    auto huffman_decoder = HuffmanDecoder();
+    auto dictionary_encoders = copy_dictionary_encoders(dictionary);
+    auto dictionary_decoders = copy_dictionary_decoders(dictionary);
+    // The data with the checksums are never a sequence of frames, so no block is predicted from another frame
+    bool is_temporal;
+    // The blocks outside the region are copied unchanged (with their sizes and checksums) up to this offset
+    std::uint64_t copied_size = 0;
+    // The cells are aligned to the blocks, so the cells intersecting the region lie in the re-encoded blocks
+    const std::uint64_t cell_side = std::max(thumbnail_cell_side, 1u);
+    const std::uint64_t cell_horizontal_offset = region_horizontal_offset / cell_side * cell_side;
+    const std::uint64_t cell_vertical_offset = region_vertical_offset / cell_side * cell_side;
+    const std::uint64_t cell_horizontal_end = std::min((region_horizontal_end - 1) / cell_side * cell_side + cell_side, data_width);
+    const std::uint64_t cell_vertical_end = (region_vertical_end - 1) / cell_side * cell_side + cell_side;
+    const std::uint64_t region_thumbnail_width = (cell_horizontal_end - cell_horizontal_offset - 1) / cell_side + 1;
+    const std::uint64_t region_thumbnail_height = (cell_vertical_end - cell_vertical_offset) / cell_side;
+    std::vector<std::uint64_t> cell_sums(thumbnail_cell_side != 0 ? region_thumbnail_width * region_thumbnail_height : 0);
+    std::vector<std::uint64_t> cell_counts(cell_sums.size());
+
+    if (!split_block_records(compressed_data, block_records)) {
+        return false;
+    }
 
-        // Extract deserialized data block from the original data
-        for (std::uint8_t i = 0; i < block_height; i++) {
-            std::uint16_t block_offset = i * BLOCK_SIDE_SIZE;
-            std::uint64_t data_offset = i * data_width + data_block_offset;
+    load_samples(region, region_samples);
+    original_region_samples.resize(region_samples.size());
 
-            for (std::uint8_t j = 0; j < block_width; j++) {
-                if (j + data_offset >= original_data_size) {
-                    block_val_count += j - block_width;
-                    break;
-                }
+    for (std::uint64_t data_vertical_offset = region_vertical_offset / BLOCK_SIDE_SIZE * BLOCK_SIDE_SIZE; data_vertical_offset < region_vertical_end; 
+        data_vertical_offset += BLOCK_SIDE_SIZE) {
+        for (std::uint64_t data_horizontal_offset = region_horizontal_offset / BLOCK_SIDE_SIZE * BLOCK_SIDE_SIZE; data_horizontal_offset < region_horizontal_end; 
+            data_horizontal_offset += BLOCK_SIDE_SIZE) {
+            const std::uint64_t block_index = data_vertical_offset / BLOCK_SIDE_SIZE * blocks_per_row + data_horizontal_offset / BLOCK_SIDE_SIZE;
 
-                deserialized_block[j + block_offset] = data[j + data_offset];
+            if (block_index >= block_records.size()) {
+                report_error("Invalid compressed data - missing block " + std::to_string(block_index));
+                return false;
             }
-        }
 
-        data_horizontal_offset += BLOCK_SIDE_SIZE;
+            const BlockRecord &block_record = block_records[block_index];
 
-        if (data_horizontal_offset >= data_width) {
-            data_horizontal_offset = 0;
-            data_vertical_offset += BLOCK_SIDE_SIZE;
-        }
+            if (crc32c(block_record.data) != block_record.checksum) {
+                report_error("Invalid compressed data - checksum mismatch of the block " + std::to_string(block_index));
+                return false;
+            }
 
-        // Serialize the extracted deseriaized data block and compress it
-        serialized_block.resize(block_val_count);
-        serialize_block(deserialized_block, false, block_val_count, block_width, block_height, serialized_block);
-        compressed_block_h.clear();
-        compress(serialized_block, huffman_encoder, compressed_block_h, use_model, use_rle);
+            huffman_decoder.set_source(block_record.data);
+
+            if (!decode_block(
+                huffman_decoder, 
+                dictionary_decoders, 
+                original_data_size, 
+                data_width, 
+                data_horizontal_offset, 
+                data_vertical_offset, 
+                use_model, 
+                use_rle, 
+                false, 
+                is_temporal, 
+                serialized_block, 
+                deserialized_block
+            )) {
+                return false;
+            }
 
-        if (use_model || use_rle) {
-            transpose_block_in_place(deserialized_block);
-            serialize_block(deserialized_block, true, block_val_count, block_height, block_width, serialized_block);
-            compressed_block_v.clear();
-            compress(serialized_block, huffman_encoder, compressed_block_v, use_model, use_rle);
+            if (!huffman_decoder.is_source_proccessed()) {
+                report_error("Invalid compressed data - the block " + std::to_string(block_index) + " is longer than its compressed content");
+                return false;
+            }
 
-            if (compressed_block_h.size() > compressed_block_v.size()) {
-                compressed_data.push_back(VERTICAL_SCAN);
-                compressed_data.insert(compressed_data.end(), compressed_block_v.begin(), compressed_block_v.end());
+            // Replace the samples of the block inside the region by the new ones and keep the original ones
+            for (std::uint64_t i = std::max(data_vertical_offset, region_vertical_offset); i < std::min(data_vertical_offset + BLOCK_SIDE_SIZE, region_vertical_end); i++) {
+                for (std::uint64_t j = std::max(data_horizontal_offset, region_horizontal_offset); j < std::min(data_horizontal_offset + BLOCK_SIDE_SIZE, region_horizontal_end); j++) {
+                    const std::uint64_t region_offset = (i - region_vertical_offset) * region_width + j - region_horizontal_offset;
+                    Sample &sample = deserialized_block[(i - data_vertical_offset) * BLOCK_SIDE_SIZE + j - data_horizontal_offset];
+                    original_region_samples[region_offset] = sample;
+                    sample = region_samples[region_offset];
+                }
             }
-            else {
-                compressed_data.push_back(HORIZONTAL_SCAN);
-                compressed_data.insert(compressed_data.end(), compressed_block_h.begin(), compressed_block_h.end());
+
+            // Sum the new samples of the block in the cells intersecting the region (before the block is transposed by its compression)
+            if (thumbnail_cell_side != 0) {
+                for (std::uint64_t i = std::max(data_vertical_offset, cell_vertical_offset); i < std::min(data_vertical_offset + BLOCK_SIDE_SIZE, cell_vertical_end); i++) {
+                    for (std::uint64_t j = std::max(data_horizontal_offset, cell_horizontal_offset); 
+                        j < std::min(data_horizontal_offset + BLOCK_SIDE_SIZE, cell_horizontal_end) && i * data_width + j < original_data_size; j++) {
+                        const std::uint64_t cell_index = (i - cell_vertical_offset) / cell_side * region_thumbnail_width + (j - cell_horizontal_offset) / cell_side;
+                        cell_sums[cell_index] += deserialized_block[(i - data_vertical_offset) * BLOCK_SIDE_SIZE + j - data_horizontal_offset];
+                        cell_counts[cell_index]++;
+                    }
+                }
             }
+
+            // The updated blocks never reuse the code tables, so that they stay decodable independently of each other
+            const std::uint8_t mode = compress_block<Sample>(
+                deserialized_block, 
+                serialized_block.size(), 
+                std::min(static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), data_width - data_horizontal_offset), 
+                get_block_height(data_height, original_data_size % data_width, data_horizontal_offset, data_vertical_offset), 
+                use_model, 
+                use_rle, 
+                search_params, 
+                NULL, 
+                dictionary_encoders, 
+                NULL, 
+                buffers
+            );
+
+            const std::uint64_t block_record_offset = block_record.data.data() - compressed_data.data() - BLOCK_RECORD_SIZE;
+            updated_data.insert(updated_data.end(), compressed_data.begin() + copied_size, compressed_data.begin() + block_record_offset);
+            append_block(updated_data, mode, buffers.best_block, true);
+            copied_size = block_record_offset + BLOCK_RECORD_SIZE + block_record.data.size();
         }
-        else {
-            compressed_data.push_back(HORIZONTAL_SCAN);
-            compressed_data.insert(compressed_data.end(), compressed_block_h.begin(), compressed_block_h.end());
-        }
+    }
+
+    updated_data.insert(updated_data.end(), compressed_data.begin() + copied_size, compressed_data.end());
+    append_samples(original_region, std::span<const Sample>(original_region_samples));
+
+    // Each cell intersecting the region contains at least one sample
+    std::vector<Sample> cell_means(cell_sums.size());
 
-        remaining_decompressed_data_size -= block_val_count;
+    for (std::uint64_t i = 0; i < cell_sums.size(); i++) {
+        cell_means[i] = get_cell_mean(cell_sums[i], cell_counts[i]);
     }
+
+    append_samples(region_thumbnail, std::span<const Sample>(cell_means));
+    return true;
 }
 
 
-bool decompress_adaptively(
-    std::vector<std::uint8_t>::const_iterator first, 
-    std::vector<std::uint8_t>::const_iterator last, 
-    std::vector<std::uint8_t> &decompressed_data, 
-    const bool use_model, 
-    const bool use_rle
+bool update_data(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<const std::uint8_t> region, 
+    const std::uint64_t region_horizontal_offset, 
+    const std::uint64_t region_vertical_offset, 
+    const std::uint64_t region_width, 
+    const std::uint64_t region_height, 
+    const unsigned effort_level, 
+    const HuffmanDictionary *dictionary, 
+    std::vector<std::uint8_t> &updated_data
 ) {
-    if (std::distance(first, last) < 16) {
-        std::cerr << "Invalid compressed data - incomplete size or width of the decompressed data" << std::endl;
+    StreamHeader header;
+    std::span<const std::uint8_t> payload;
+    std::uint32_t checksum = 0;
+    std::vector<std::uint8_t> updated_payload;
+    std::vector<std::uint8_t> original_region;
+    std::vector<std::uint8_t> region_thumbnail;
+    unsigned cell_side = 0;
+    std::span<const std::uint8_t> compressed_thumbnail;
+
+    if (!read_bounded_header(compressed_data, header) || !get_payload(compressed_data, header, dictionary, payload, checksum)) {
         return false;
     }
 
-    std::uint64_t original_data_size = 0;
-    std::uint64_t data_width = 0;
-
-    // Get the original data size and its width
-    for (std::uint8_t i = 0; i < 8; i++) {
-        original_data_size |= static_cast<uint64_t>(*first) << i * BYTE_BIT_LENGTH;
-        data_width |= static_cast<uint64_t>(*(first++ + 8)) << i * BYTE_BIT_LENGTH;
-    }
+    // The header and the hash of the dictionary stay unchanged
+    const std::uint64_t content_offset = HEADER_SIZE + (header.flags & FLAG_DICTIONARY ? DICTIONARY_HASH_BYTE_COUNT : 0);
+    updated_data.insert(updated_data.end(), compressed_data.begin(), compressed_data.begin() + content_offset);
 
-    const std::uint64_t data_height = original_data_size / data_width + (original_data_size % data_width != 0 ? 1 : 0);
-    decompressed_data.resize(original_data_size);
-    std::vector<std::uint8_t> serialized_block;
-    std::vector<std::uint8_t> deserialized_block(BLOCK_SIZE);
-    std::uint64_t data_horizontal_offset = 0;
-    std::uint64_t data_vertical_offset = 0;
-    std::uint64_t remaining_decompressed_data_size = original_data_size;
-    auto huffman_decoder = HuffmanDecoder();
-    huffman_decoder.set_source(first + 8, last);
-    const std::uint64_t unaligned_data_remainder = original_data_size % data_width;
+    if (header.flags & FLAG_THUMBNAIL) {
+        auto content = compressed_data.subspan(content_offset);
+        StreamHeader thumbnail_header;
 
-    while (remaining_decompressed_data_size > 0) {
-        if (huffman_decoder.is_source_proccessed()) {
-            std::cerr << "Invalid compressed data - the size of the decompressed data is lower than the size specified in the compressed data header" << std::endl;
+        if (!split_thumbnail(content, cell_side, compressed_thumbnail) 
+            || !read_thumbnail_header(compressed_thumbnail, header, get_sample_bits(header) > MAX_BYTE_SAMPLE_BITS ? 2 : 1, cell_side, thumbnail_header)) {
             return false;
         }
 
-        bool is_transposed = *huffman_decoder.get_current_source_it() == VERTICAL_SCAN;
-        huffman_decoder.advance_source();
+        if (!(thumbnail_header.flags & FLAG_CHECKSUM)) {
+            report_error("Invalid compressed data - the compressed thumbnail has no checksums");
+            return false;
+        }
+    }
 
-        std::uint8_t block_width = std::min(static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), data_width - data_horizontal_offset);
-        std::uint8_t block_height = std::min(
-            static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), 
-            data_height - data_vertical_offset 
-                - (unaligned_data_remainder == 0 || data_height - data_vertical_offset > BLOCK_SIDE_SIZE || data_horizontal_offset < unaligned_data_remainder ? 0 : 1)
+    if (!with_sample_type(get_sample_bits(header), [&](auto sample) {
+        return update_sample_blocks<decltype(sample)>(
+            payload, 
+            region, 
+            header.original_size / sizeof(sample), 
+            header.width, 
+            region_horizontal_offset, 
+            region_vertical_offset, 
+            region_width, 
+            region_height, 
+            header.flags & FLAG_MODEL, 
+            header.flags & FLAG_RLE, 
+            effort_level, 
+            header.flags & FLAG_DICTIONARY ? dictionary : NULL, 
+            cell_side, 
+            updated_payload, 
+            original_region, 
+            region_thumbnail
         );
-        std::uint64_t data_block_offset = data_horizontal_offset + data_vertical_offset * data_width;
-        std::uint64_t data_block_end_offset = data_block_offset + block_width + (block_height - 1) * data_width;
+    })) {
+        return false;
+    }
 
-        // Decompress the serialized data block and deserialize it
-        if (!decompress(
-            serialized_block, 
-            huffman_decoder, 
-            use_model, 
-            use_rle, 
-            block_height * block_width - (data_block_end_offset > original_data_size ? data_block_end_offset - original_data_size : 0)
+    // The thumbnail is updated in place by the new means of the cells intersecting the region as well
+    if (header.flags & FLAG_THUMBNAIL) {
+        std::vector<std::uint8_t> updated_thumbnail;
+        const std::uint64_t thumbnail_horizontal_offset = region_horizontal_offset / cell_side;
+        const std::uint64_t thumbnail_vertical_offset = region_vertical_offset / cell_side;
+
+        if (!update_data(
+            compressed_thumbnail, 
+            region_thumbnail, 
+            thumbnail_horizontal_offset, 
+            thumbnail_vertical_offset, 
+            (region_horizontal_offset + region_width - 1) / cell_side - thumbnail_horizontal_offset + 1, 
+            (region_vertical_offset + region_height - 1) / cell_side - thumbnail_vertical_offset + 1, 
+            effort_level, 
+            NULL, 
+            updated_thumbnail
         )) {
             return false;
         }
 
-        if (remaining_decompressed_data_size < serialized_block.size()) {
-            std::cerr << "Invalid compressed data - the size of the decompressed data is greater than the size specified in the compressed data header" << std::endl;
-            return false;
-        }
-
-        if (!is_transposed) {
-            deserialize_block(serialized_block, is_transposed, serialized_block.size(), block_width, block_height, deserialized_block);
-        }
-        else {
-            deserialize_block(serialized_block, is_transposed, serialized_block.size(), block_height, block_width, deserialized_block);
-            transpose_block_in_place(deserialized_block);
-        }
-
-        // Put the deserialized data block to its original position in the original data
-        for (std::uint8_t i = 0; i < block_height; i++) {
-            std::uint16_t block_offset = i * BLOCK_SIDE_SIZE;
-            std::uint64_t data_offset = i * data_width + data_block_offset;
-
-            for (std::uint8_t j = 0; j < block_width; j++) {
-                if (j + data_offset >= original_data_size) {
-                    break;
-                }
+        updated_data.push_back(cell_side);
+        append_number(updated_data, updated_thumbnail.size(), CHUNK_SIZE_BYTE_COUNT);
+        updated_data.insert(updated_data.end(), updated_thumbnail.begin(), updated_thumbnail.end());
+    }
 
-                decompressed_data[j + data_offset] = deserialized_block[j + block_offset];
-            }
-        }
+    updated_data.insert(updated_data.end(), updated_payload.begin(), updated_payload.end());
 
-        remaining_decompressed_data_size -= serialized_block.size();
-        data_horizontal_offset += BLOCK_SIDE_SIZE;
+    // The checksum of the whole original data is updated by the rows of the region only
+    const std::uint64_t sample_size = get_sample_bits(header) > MAX_BYTE_SAMPLE_BITS ? 2 : 1;
+    const std::uint64_t row_size = region_width * sample_size;
 
-        if (data_horizontal_offset >= data_width) {
-            data_horizontal_offset = 0;
-            data_vertical_offset += BLOCK_SIDE_SIZE;
-        }
+    for (std::uint64_t i = 0; i < region_height; i++) {
+        checksum = update_crc32c(
+            checksum, 
+            header.original_size, 
+            ((region_vertical_offset + i) * header.width + region_horizontal_offset) * sample_size, 
+            std::span<const std::uint8_t>(original_region).subspan(i * row_size, row_size), 
+            region.subspan(i * row_size, row_size)
+        );
     }
 
+    append_number(updated_data, checksum, CRC_BYTE_COUNT);
     return true;
 }
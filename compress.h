@@ -13,76 +13,402 @@
 
 
 #include <vector>
+#include <span>
 #include <cstdint>
 
+#include "dictionary.h"
+#include "channels.h"
+
+
+// The side size of the square blocks the image is decomposed into by the adaptive scanning
+#define BLOCK_SIDE_SIZE 32
+
+// The effort levels of the encoder search for the smallest compressed data (the decompression is equally fast for all of them)
+#define MIN_EFFORT_LEVEL 1
+#define MAX_EFFORT_LEVEL 9
+#define DEFAULT_EFFORT_LEVEL 6
+
+// The size (in bytes of the original data) of the chunks of the statically scanned data decodable by more threads at the same time
+#define STATIC_CHUNK_SIZE (1 << 20)
+
+// The samples are stored either in 1 byte (MAX_BYTE_SAMPLE_BITS bits) or in 2 bytes (MAX_SAMPLE_BITS bits, in little endian)
+#define MAX_BYTE_SAMPLE_BITS 8
+#define MAX_SAMPLE_BITS 16
+
+// The maximum absolute error of the samples of the near-lossless compression (0 for the lossless compression)
+#define MAX_SAMPLE_ERROR 255
+
+
+/**
+ * @brief The options of the compression.
+ */
+struct CompressOptions {
+    std::uint64_t width_value = 0;                      // The width of data (2D image) in pixels, used only with the adaptive scanning
+    unsigned sample_bits = MAX_BYTE_SAMPLE_BITS;        // The width of the samples (in bits), the size of the data of 16-bit samples has to be even
+    unsigned channel_count = 1;                         // The number of channels (from 2 to MAX_CHANNEL_COUNT for the multi-channel data)
+    bool is_planar = false;                             // Indicates whether the channels are stored one after another instead of pixel by pixel
+    unsigned color_transform = COLOR_TRANSFORM_NONE;    // The color transform applied to the channels before their compression (see channels.h)
+    bool adapt_scan = false;                            // Indicates whether the adaptive scanning should be used
+    bool use_model = false;                             // Indicates whether the adjacent value difference model should be used for data preprocessing
+    bool use_rle = false;                               // Indicates whether the RLE should be used for data preprocessing
+    bool use_checksum = false;                          // Indicates whether the CRC32C checksums of the blocks and of the whole original data should be stored
+    unsigned effort_level = DEFAULT_EFFORT_LEVEL;       // The effort level of the encoder search (from MIN_EFFORT_LEVEL to MAX_EFFORT_LEVEL)
+    bool use_static_chunks = false;                     // Indicates whether the statically scanned data should be split into the chunks sharing one code table
+    unsigned thumbnail_cell_side = 0;                   // The side of the cells of the image summarized by the stored thumbnail (0 if no thumbnail should be stored)
+    std::uint64_t frame_height = 0;                     // The height of the frames (in rows) of the sequence of frames (0 if the data are a single image)
+    unsigned max_error = 0;                             // The maximum absolute error of the decompressed samples (0 for the lossless compression)
+};
+
+
+/**
+ * @brief Compress the data to the self-describing format, i.e. the header with the mode flags, the original data size and width followed by the compressed data.
+ * 
+ * @param data The data to be compressed
+ * @param compressed_data Buffer to which the resulting compressed data are appended
+ * @param options The options of the compression (the options of the channels are not used, the width is given in samples)
+ * @param dictionary The dictionary of the code tables the blocks may be encoded by (NULL if there is none), the compressed data store its hash
+ * and they can be decompressed only with the same dictionary
+ * 
+ * @note The chunks of the statically scanned data (with use_static_chunks) have STATIC_CHUNK_SIZE bytes, so that they can be decompressed
+ * by more threads at the same time. The thumbnail is stored only with the adaptive scanning and the frames are used only with the adaptive
+ * scanning without the checksums.
+ *
+ * @note From the effort level with the preprocessing search, the model and the RLE are only allowed, i.e. the static scanning
+ * uses the combination of them giving the smallest compressed data and the adaptive scanning chooses it for each block.
+ * 
+ * @note The frames of the sequence of frames are decomposed into the blocks separately and each block is compressed either by itself
+ * or as its difference from the co-located block of the previous frame, whichever is smaller. The blocks of the static parts of the scene
+ * are thus compressed to a few bytes and the code tables are reused across the frames.
+ *
+ * @note The near-lossless compression quantizes the samples to the bins of 2 * max_error + 1 values before the model, so the differences
+ * of the adjacent samples are the quantized prediction residuals (as in JPEG-LS) with the alphabet and the noise reduced by the size
+ * of the bins. The decompression reconstructs each sample by the center of its bin. The following stages stay lossless, so the checksums
+ * cover the quantized samples.
+ */
+void compress_data(
+    std::span<const std::uint8_t> data, 
+    std::vector<std::uint8_t> &compressed_data, 
+    const CompressOptions &options, 
+    const HuffmanDictionary *dictionary
+);
+
+/**
+ * @brief Compress the multi-channel data to the self-describing format, i.e. the header followed by the descriptor of the channels
+ * and by the planes of the transformed channels each of which is compressed separately (with its own header).
+ *
+ * @note The channels are compressed by more threads at the same time (one thread per channel). With the adaptive scanning,
+ * the blocks of each channel cover the same pixels. The thumbnail summarizes the untransformed channels, the checksums cover the channels
+ * as well and the frames are predicted from each other in each channel. The untransformed samples of the near-lossless compression
+ * are quantized, so that the error of each channel is bounded regardless of the color transform.
+ *
+ * @param data The data to be compressed (their size has to be a multiple of the size of one pixel)
+ * @param compressed_data Buffer to which the resulting compressed data are appended
+ * @param options The options of the compression
+ * @param dictionary The dictionary of the code tables the blocks of the channels may be encoded by (NULL if there is none)
+ */
+void compress_channels(
+    std::span<const std::uint8_t> data,
+    std::vector<std::uint8_t> &compressed_data,
+    const CompressOptions &options,
+    const HuffmanDictionary *dictionary
+);
+
+/**
+ * @brief Get the size of the compressed data once they are decompressed (from the header of the compressed data).
+ * 
+ * @param compressed_data The compressed data
+ * @param decompressed_data_size The resulting size of the decompressed data
+ * 
+ * @return True if the size is successfully obtained, false otherwise (also if the compressed data cannot hold the data of the size in the header).
+ */
+bool get_decompressed_size(std::span<const std::uint8_t> compressed_data, std::uint64_t &decompressed_data_size);
+
+/**
+ * @brief Decompress the data in the self-describing format, the mode is determined by the header of the compressed data.
+ * 
+ * @param compressed_data The data to be decompressed
+ * @param decompressed_data The resulting decompressed data
+ * @param thread_count The maximum number of threads decompressing the chunks sharing the code table of the statically scanned data
+ * @param dictionary The dictionary of the code tables the data were compressed with (NULL if there is none)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+bool decompress_data(
+    std::span<const std::uint8_t> compressed_data, 
+    std::vector<std::uint8_t> &decompressed_data, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+);
+
+/**
+ * @brief Decompress the data in the self-describing format to the memory provided by the caller, the mode is determined by the header of the compressed data.
+ * 
+ * @note The size of the provided memory has to be equal to the size obtained by get_decompressed_size.
+ * 
+ * @param compressed_data The data to be decompressed
+ * @param decompressed_data The memory for the resulting decompressed data
+ * @param thread_count The maximum number of threads decompressing the chunks sharing the code table of the statically scanned data
+ * @param dictionary The dictionary of the code tables the data were compressed with (NULL if there is none)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+bool decompress_data(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<std::uint8_t> decompressed_data, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+);
+
+/**
+ * @brief Decompress only the thumbnail stored in the data in the self-describing format without decoding any block of the data.
+ * 
+ * @note The thumbnails of the chunks of the chunked data are joined, since the chunks are the strips of whole rows of the cells.
+ * 
+ * @param compressed_data The compressed data with the thumbnail
+ * @param thumbnail Buffer to which the resulting thumbnail is appended (in the layout of the channels of the data)
+ * @param thumbnail_width The resulting width of the thumbnail (in pixels)
+ * @param cell_side The resulting side of the cells of the data summarized by one pixel of the thumbnail
+ * 
+ * @return True if the data contain the thumbnail and it is successfully decompressed, false otherwise.
+ */
+bool decompress_thumbnail(
+    std::span<const std::uint8_t> compressed_data, 
+    std::vector<std::uint8_t> &thumbnail, 
+    std::uint64_t &thumbnail_width, 
+    unsigned &cell_side
+);
+
+/**
+ * @brief Check the integrity of the data in the self-describing format by decompressing them (without keeping the result) and checking their checksums.
+ * 
+ * @note The chunks of the chunked data and the blocks of the adaptively scanned data with the checksums are checked by more threads at the same time.
+ * 
+ * @param compressed_data The data to be checked
+ * @param thread_count The maximum number of threads checking the data
+ * @param dictionary The dictionary of the code tables the data were compressed with (NULL if there is none)
+ * 
+ * @return True if the data are valid (and their checksums, if stored, match), false otherwise.
+ */
+bool verify_data(std::span<const std::uint8_t> compressed_data, const unsigned thread_count, const HuffmanDictionary *dictionary);
+
+/**
+ * @brief Update the rectangular region of the adaptively scanned data with the checksums in the self-describing format by re-encoding
+ * only the blocks intersecting the region.
+ * 
+ * @note The blocks with the checksums are preceded by their sizes and they never reuse the code tables, so the other blocks are copied
+ * without decoding them and the checksum of the whole original data is updated by the changed rows only. The compressed data have to be
+ * adaptively scanned with the checksums (without the chunks, the channels and the quantization) and the region has to lie inside the data.
+ * The stored thumbnail is updated in the same way by the new means of the cells intersecting the region.
+ * 
+ * @param compressed_data The data to be updated
+ * @param region The new samples of the region row by row (the 16-bit samples are stored in little endian)
+ * @param region_horizontal_offset The horizontal position of the region in the data (in samples)
+ * @param region_vertical_offset The vertical position of the region in the data (in rows)
+ * @param region_width The width of the region (in samples)
+ * @param region_height The height of the region (in rows)
+ * @param effort_level The effort level of the encoder search of the re-encoded blocks
+ * @param dictionary The dictionary of the code tables the data were compressed with (NULL if there is none)
+ * @param updated_data Buffer to which the resulting updated compressed data are appended
+ * 
+ * @return True if the data are successfully updated, false otherwise (in case of invalid compressed data).
+ */
+bool update_data(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<const std::uint8_t> region, 
+    const std::uint64_t region_horizontal_offset, 
+    const std::uint64_t region_vertical_offset, 
+    const std::uint64_t region_width, 
+    const std::uint64_t region_height, 
+    const unsigned effort_level, 
+    const HuffmanDictionary *dictionary, 
+    std::vector<std::uint8_t> &updated_data
+);
+
+/**
+ * @brief Collect the histograms of the symbols the entropy coders encode for the data, e.g. to train the dictionary of the code tables on them.
+ * 
+ * @note With the adaptive scanning, one histogram of each horizontally scanned block is collected, otherwise one histogram of the whole data.
+ * 
+ * @param data The data
+ * @param width_value The width of data (2D image) in samples, used only with the adaptive scanning
+ * @param sample_bits The width of the samples (in bits)
+ * @param adapt_scan Indicates whether the adaptive scanning is used
+ * @param use_model Indicates whether the adjacent value difference model is used for data preprocessing
+ * @param use_rle Indicates whether the RLE is used for data preprocessing
+ * @param block_freqs Buffer to which the resulting histograms are appended
+ */
+void collect_block_freqs(
+    std::span<const std::uint8_t> data, 
+    const std::uint64_t width_value, 
+    const unsigned sample_bits, 
+    const bool adapt_scan, 
+    const bool use_model, 
+    const bool use_rle, 
+    std::vector<std::vector<std::uint64_t>> &block_freqs
+);
+
+/**
+ * @brief Transpose the block (of BLOCK_SIDE_SIZE x BLOCK_SIDE_SIZE values) in place.
+ * 
+ * @note The block functions are provided for the 8-bit (std::uint8_t) and the 16-bit (std::uint16_t) samples.
+ * 
+ * @param block The block to be transposed
+ */
+template<typename Sample>
+void transpose_block_in_place(std::vector<Sample> &block);
+
+/**
+ * @brief Serialize the data block, i.e. take its values row by row without the unused parts of the rows.
+ * 
+ * @param deserialized_block The deserialized data (image) block (of BLOCK_SIDE_SIZE x BLOCK_SIDE_SIZE values)
+ * @param is_transposed Indicates whether the deserialized data block is transposed
+ * @param block_val_count The number of values (bytes) in the data block
+ * @param block_width The deserialized data block width
+ * @param block_height The deserialized data block height
+ * @param serialized_block The resulting serialized data block (of block_val_count values)
+ */
+template<typename Sample>
+void serialize_block(
+    const std::vector<Sample> &deserialized_block, 
+    const bool is_transposed, 
+    const std::uint16_t block_val_count, 
+    const std::uint8_t block_width, 
+    const std::uint8_t block_height, 
+    std::vector<Sample> &serialized_block
+);
+
+/**
+ * @brief Deserialize the data block, i.e. put its values back to the rows of the block.
+ * 
+ * @param serialized_block The serialized data (image) block
+ * @param is_transposed Indicates whether the deserialized data block is transposed
+ * @param block_val_count The number of values (bytes) in the data block
+ * @param block_width The deserialized data block width
+ * @param block_height The deserialized data block height
+ * @param deserialized_block The resulting deserialized data block (of BLOCK_SIDE_SIZE x BLOCK_SIDE_SIZE values)
+ */
+template<typename Sample>
+void deserialize_block(
+    const std::vector<Sample> &serialized_block, 
+    const bool is_transposed, 
+    const std::uint16_t block_val_count, 
+    const std::uint8_t block_width, 
+    const std::uint8_t block_height, 
+    std::vector<Sample> &deserialized_block
+);
 
 /**
- * @brief Compress the data using canonical Huffman encoding with static scanning.
+ * @brief Compress the data using canonical Huffman encoding with static scanning (without the header).
  * 
- * @note The data are scanned horizontally and they are treated as one continuous data block.
+ * @note The data are scanned horizontally and they are treated as one continuous data block. With the chunks, the data larger than
+ * STATIC_CHUNK_SIZE bytes are split into the chunks compressed independently (each of them with the model and the RLE restarted),
+ * preceded by the code table shared by them and by their sizes, so that each chunk is decompressed by its own thread.
  * 
  * @param data The data to be compressed
- * @param decompressed_data The resulting compressed data
- * @param use_model Indicates whether the adjacent value difference model should be used for original data preprocessing
- * @param use_rle Indicates whether the RLE should be used for original data preprocessing
+ * @param compressed_data Buffer to which the resulting compressed data are appended
+ * @param options The options of the compression (only the width of the samples, the preprocessing, the effort level and the chunks are used)
+ * @param dictionary The dictionary of the code tables the data may be encoded by (NULL if there is none)
  */
-void compress_statically(const std::vector<std::uint8_t> &data, std::vector<std::uint8_t> &compressed_data, const bool use_model, const bool use_rle);
+void compress_statically(
+    std::span<const std::uint8_t> data, 
+    std::vector<std::uint8_t> &compressed_data, 
+    const CompressOptions &options, 
+    const HuffmanDictionary *dictionary
+);
 
 /**
- * @brief Decompress the data compressed using canonical Huffman encoding with static scanning.
+ * @brief Decompress the data compressed using canonical Huffman encoding with static scanning (without the header).
  * 
- * @param first Iterator pointing to the first element to be decoded
- * @param last Iterator pointing to the end of the range (one past the last element to be decoded)
+ * @param compressed_data The data to be decompressed
  * @param decompressed_data The resulting decompressed data
+ * @param original_data_size The size of the original data (in bytes)
+ * @param sample_bits The width of the samples (in bits)
  * @param use_model Indicates whether the adjacent value difference model was used for original data preprocessing
  * @param use_rle Indicates whether the RLE was used for original data preprocessing
+ * @param thread_count The maximum number of threads decompressing the chunks sharing the code table
+ * @param dictionary The dictionary of the code tables the data were compressed with (NULL if there is none)
  * 
  * @return True in case of successful decompression, false otherwise.
  */
 bool decompress_statically(
-    std::vector<std::uint8_t>::const_iterator first, 
-    std::vector<std::uint8_t>::const_iterator last, 
+    std::span<const std::uint8_t> compressed_data, 
     std::vector<std::uint8_t> &decompressed_data, 
+    const std::uint64_t original_data_size, 
+    const unsigned sample_bits, 
+    const bool use_model, 
+    const bool use_rle, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
+);
+
+/**
+ * @brief Decompress the data compressed using canonical Huffman encoding with static scanning (without the header) to the memory provided by the caller.
+ * 
+ * @note The chunks sharing the code table are decoded directly to the provided memory, the other data are copied to it.
+ * 
+ * @param compressed_data The data to be decompressed
+ * @param decompressed_data The memory for the resulting decompressed data (its size is the size of the original data)
+ * @param sample_bits The width of the samples (in bits)
+ * @param use_model Indicates whether the adjacent value difference model was used for original data preprocessing
+ * @param use_rle Indicates whether the RLE was used for original data preprocessing
+ * @param thread_count The maximum number of threads decompressing the chunks sharing the code table
+ * @param dictionary The dictionary of the code tables the data were compressed with (NULL if there is none)
+ * 
+ * @return True in case of successful decompression, false otherwise.
+ */
+bool decompress_statically(
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<std::uint8_t> decompressed_data, 
+    const unsigned sample_bits, 
     const bool use_model, 
-    const bool use_rle
+    const bool use_rle, 
+    const unsigned thread_count, 
+    const HuffmanDictionary *dictionary
 );
 
 /**
- * @brief Compress the data using canonical Huffman encoding with adaptive scanning.
+ * @brief Compress the data using canonical Huffman encoding with adaptive scanning (without the header).
  * 
  * @note The data (of 2D image) are decomposed into smaller blocks each of which is compressed independantely using horizontal or vertical scanning depending on the best compression ratio.
  * 
  * @param data The data to be compressed
- * @param decompressed_data The resulting compressed data
- * @param width_value The width of data (2D image)
- * @param use_model Indicates whether the adjacent value difference model should be used for each data block preprocessing
- * @param use_rle Indicates whether the RLE should be used for each original data block preprocessing
+ * @param compressed_data Buffer to which the resulting compressed data are appended
+ * @param options The options of the compression (the options of the channels, of the thumbnail and of the near-lossless compression are not used,
+ * the width is given in samples and the frame height lower than the data is stored before the blocks, 0 if the data are a single image)
+ * @param dictionary The dictionary of the code tables the blocks may be encoded by (NULL if there is none)
  */
 void compress_adaptively(
-    const std::vector<std::uint8_t> &data, 
+    std::span<const std::uint8_t> data, 
     std::vector<std::uint8_t> &compressed_data, 
-    const std::uint64_t width_value, 
-    const bool use_model, 
-    const bool use_rle
+    const CompressOptions &options, 
+    const HuffmanDictionary *dictionary
 );
 
 /**
- * @brief Decompress the data compressed using canonical Huffman encoding with adaptive scanning.
+ * @brief Decompress the data compressed using canonical Huffman encoding with adaptive scanning (without the header) to the memory provided by the caller.
  * 
- * @param first Iterator pointing to the first element to be decoded
- * @param last Iterator pointing to the end of the range (one past the last element to be decoded)
- * @param decompressed_data The resulting decompressed data
+ * @param compressed_data The data to be decompressed
+ * @param decompressed_data The memory for the resulting decompressed data (its size is the size of the original data)
+ * @param width_value The width of data (2D image) in samples
+ * @param sample_bits The width of the samples (in bits)
+ * @param use_frames Indicates whether the data are the sequence of frames whose height precedes the blocks
  * @param use_model Indicates whether the adjacent value difference model was used for each original data block preprocessing
  * @param use_rle Indicates whether the RLE was used for each original data block preprocessing
+ * @param use_checksum Indicates whether each block is preceded by its size and its CRC32C checksum
+ * @param dictionary The dictionary of the code tables the data were compressed with (NULL if there is none)
  * 
  * @return True in case of successful decompression, false otherwise.
  */
 bool decompress_adaptively(
-    std::vector<std::uint8_t>::const_iterator first, 
-    std::vector<std::uint8_t>::const_iterator last, 
-    std::vector<std::uint8_t> &decompressed_data, 
+    std::span<const std::uint8_t> compressed_data, 
+    std::span<std::uint8_t> decompressed_data, 
+    const std::uint64_t width_value, 
+    const unsigned sample_bits, 
+    const bool use_frames, 
     const bool use_model, 
-    const bool use_rle
+    const bool use_rle, 
+    const bool use_checksum, 
+    const HuffmanDictionary *dictionary
 );
 
 
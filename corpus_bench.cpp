@@ -0,0 +1,584 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief End-to-end corpus benchmark of the codec with the throughput and compression ratio regression gate
+ */
+
+
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <getopt.h>
+#include <spawn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "io.h"
+
+
+#define DEFAULT_REPETITION_COUNT 10
+#define DEFAULT_WIDTH 512
+#define MIN_CORPUS_SIZE (16 << 20)          // The minimum size of the concatenated corpus timed as a whole (in bytes)
+#define COMPARED_BLOCK_SIZE (1 << 20)       // The size of the blocks of the compared files (in bytes)
+#define DEFAULT_THROUGHPUT_TOLERANCE 10.0   // The allowed throughput drop (in percent)
+#define DEFAULT_SIZE_TOLERANCE 0.5          // The allowed compressed size growth (in percent)
+
+#define TOTAL_ROW_NAME "TOTAL"
+
+
+extern char **environ;
+
+
+/**
+ * @brief Mode of the codec given by its command line flags.
+ */
+struct BenchMode {
+    std::string name;                   // The name of the mode used in the reports
+    std::vector<std::string> flags;     // The compression flags
+};
+
+/**
+ * @brief Result of the benchmark of one file (or of the whole corpus) in one mode.
+ */
+struct BenchResult {
+    std::string file;                   // The name of the file (TOTAL_ROW_NAME for the concatenated corpus)
+    std::string mode;                   // The name of the mode
+    std::uint64_t original_size = 0;    // The size of the original data
+    std::uint64_t compressed_size = 0;  // The size of the compressed data
+    double compress_time = 0;           // The minimum compression time (in seconds)
+    double decompress_time = 0;         // The minimum decompression time (in seconds)
+    long peak_rss = 0;                  // The peak resident set size of the codec process (in KiB)
+
+    double bits_per_symbol() const {
+        return original_size > 0 ? compressed_size * 8.0 / original_size : 0;
+    }
+
+    double compress_throughput() const {
+        return compress_time > 0 ? original_size / compress_time / 1e6 : 0;
+    }
+
+    double decompress_throughput() const {
+        return decompress_time > 0 ? original_size / decompress_time / 1e6 : 0;
+    }
+};
+
+
+/**
+ * @brief Run the codec as a child process and wait for it.
+ *
+ * @param arguments The command line arguments of the codec (including the name of the codec binary)
+ * @param time The resulting wall-clock time of the run (in seconds)
+ * @param peak_rss The resulting peak resident set size of the codec process (in KiB)
+ *
+ * @return True if the codec succeeds, false otherwise.
+ */
+bool run_codec(const std::vector<std::string> &arguments, double &time, long &peak_rss) {
+    std::vector<char *> argv;
+
+    for (const auto &argument: arguments) {
+        argv.push_back(const_cast<char *>(argument.c_str()));
+    }
+
+    argv.push_back(NULL);
+
+    // The codec prints nothing in the normal operation, but its optional statistics must not mix with the report
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    pid_t pid;
+    const int spawn_result = posix_spawn(&pid, argv[0], &file_actions, NULL, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&file_actions);
+
+    if (spawn_result != 0) {
+        std::cerr << "Cannot run the codec '" << arguments[0] << "'" << std::endl;
+        return false;
+    }
+
+    int status;
+    struct rusage usage;
+
+    if (wait4(pid, &status, 0, &usage) == -1) {
+        std::cerr << "Cannot wait for the codec '" << arguments[0] << "'" << std::endl;
+        return false;
+    }
+
+    time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    peak_rss = usage.ru_maxrss;
+    return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+
+/**
+ * @brief Compare the contents of the files.
+ *
+ * @note The files are compared block by block, since the codec processes spawned later inherit the peak resident set size of this process.
+ *
+ * @param first_filename The name of the first file
+ * @param second_filename The name of the second file
+ *
+ * @return True if both the files are readable and their contents are equal, false otherwise.
+ */
+bool are_files_equal(const std::string &first_filename, const std::string &second_filename) {
+    std::ifstream first_file(first_filename, std::ios::binary);
+    std::ifstream second_file(second_filename, std::ios::binary);
+    std::vector<char> first_block(COMPARED_BLOCK_SIZE), second_block(COMPARED_BLOCK_SIZE);
+
+    if (!first_file || !second_file) {
+        return false;
+    }
+
+    while (first_file && second_file) {
+        first_file.read(first_block.data(), first_block.size());
+        second_file.read(second_block.data(), second_block.size());
+
+        if (first_file.gcount() != second_file.gcount() || !std::equal(first_block.begin(), first_block.begin() + first_file.gcount(), second_block.begin())) {
+            return false;
+        }
+    }
+
+    return first_file.eof() && second_file.eof();
+}
+
+
+/**
+ * @brief Compress and decompress the file repeatedly and check that the decompressed file equals the original one.
+ *
+ * @note The minimum times of the runs are used, since the other processes and the start of the codec only add to the time of each run.
+ *
+ * @param codec The name of the codec binary
+ * @param filename The name of the file
+ * @param mode The mode of the codec
+ * @param width The image width passed to the codec
+ * @param repetition_count The number of the measured compressions and decompressions
+ * @param work_path The prefix of the temporary files
+ * @param result The resulting measurement
+ *
+ * @return True in case of successful measurement, false otherwise.
+ */
+bool bench_file(
+    const std::string &codec,
+    const std::string &filename,
+    const BenchMode &mode,
+    const std::uint64_t width,
+    const unsigned repetition_count,
+    const std::string &work_path,
+    BenchResult &result
+) {
+    const std::string compressed_filename = work_path + ".c";
+    const std::string decompressed_filename = work_path + ".d";
+    std::vector<std::string> compress_arguments = {codec, "-c", "-i", filename, "-o", compressed_filename, "-w", std::to_string(width)};
+    const std::vector<std::string> decompress_arguments = {codec, "-d", "-i", compressed_filename, "-o", decompressed_filename};
+    compress_arguments.insert(compress_arguments.end(), mode.flags.begin(), mode.flags.end());
+
+    std::vector<double> compress_times(repetition_count), decompress_times(repetition_count);
+    long peak_rss;
+
+    for (unsigned i = 0; i < repetition_count; i++) {
+        if (!run_codec(compress_arguments, compress_times[i], peak_rss)) {
+            std::cerr << "The compression of the file '" << filename << "' in the mode " << mode.name << " failed" << std::endl;
+            return false;
+        }
+
+        result.peak_rss = std::max(result.peak_rss, peak_rss);
+
+        if (!run_codec(decompress_arguments, decompress_times[i], peak_rss)) {
+            std::cerr << "The decompression of the file '" << filename << "' in the mode " << mode.name << " failed" << std::endl;
+            return false;
+        }
+
+        result.peak_rss = std::max(result.peak_rss, peak_rss);
+    }
+
+    if (!are_files_equal(filename, decompressed_filename)) {
+        std::cerr << "The decompressed file '" << filename << "' differs from the original one in the mode " << mode.name << std::endl;
+        return false;
+    }
+
+    result.original_size = std::filesystem::file_size(filename);
+    result.compressed_size = std::filesystem::file_size(compressed_filename);
+    result.compress_time = *std::min_element(compress_times.begin(), compress_times.end());
+    result.decompress_time = *std::min_element(decompress_times.begin(), decompress_times.end());
+    return true;
+}
+
+
+/**
+ * @brief Concatenate the files of the corpus (repeatedly) to one file timed as a whole.
+ *
+ * @note The corpus is repeated up to MIN_CORPUS_SIZE bytes, so that the start of the codec process is negligible against its work.
+ *
+ * @param filenames The names of the files of the corpus
+ * @param corpus_filename The name of the resulting concatenated corpus
+ *
+ * @return True if the corpus is successfully written, false otherwise.
+ */
+bool write_corpus_file(const std::vector<std::string> &filenames, const std::string &corpus_filename) {
+    std::vector<std::uint8_t> files, data;
+    std::ofstream corpus_file(corpus_filename, std::ios::binary);
+
+    if (!corpus_file) {
+        std::cerr << "Cannot write the corpus '" << corpus_filename << "'" << std::endl;
+        return false;
+    }
+
+
+    for (const auto &filename: filenames) {
+        if (!read_bin_file(filename, data)) {
+            return false;
+        }
+
+        files.insert(files.end(), data.begin(), data.end());
+    }
+
+    if (files.empty()) {
+        std::cerr << "The corpus is empty" << std::endl;
+        return false;
+    }
+
+    // The corpus is written repeatedly instead of being kept whole, as the compared files are
+    for (std::uint64_t corpus_size = 0; corpus_size < MIN_CORPUS_SIZE; corpus_size += files.size()) {
+        corpus_file.write(reinterpret_cast<const char *>(files.data()), files.size());
+    }
+
+    if (!corpus_file) {
+        std::cerr << "Cannot write the corpus '" << corpus_filename << "'" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Write the results to the CSV file.
+ *
+ * @param filename The name of the CSV file
+ * @param results The results
+ *
+ * @return True if the file is successfully written, false otherwise.
+ */
+bool write_csv_report(const std::string &filename, const std::vector<BenchResult> &results) {
+    std::ofstream file(filename);
+
+    if (!file) {
+        std::cerr << "Cannot write the report '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    file << "file,mode,original_size,compressed_size,bits_per_symbol,compress_mb_s,decompress_mb_s,peak_rss_kib" << std::endl;
+
+    for (const auto &result: results) {
+        file << result.file << "," << result.mode << "," << result.original_size << "," << result.compressed_size << ","
+            << std::fixed << std::setprecision(4) << result.bits_per_symbol() << ","
+            << std::setprecision(2) << result.compress_throughput() << "," << result.decompress_throughput() << ","
+            << result.peak_rss << std::endl;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Write the results to the JSON file.
+ *
+ * @param filename The name of the JSON file
+ * @param results The results
+ * @param repetition_count The number of the measured runs of each case
+ *
+ * @return True if the file is successfully written, false otherwise.
+ */
+bool write_json_report(const std::string &filename, const std::vector<BenchResult> &results, const unsigned repetition_count) {
+    std::ofstream file(filename);
+
+    if (!file) {
+        std::cerr << "Cannot write the report '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    file << "{" << std::endl << "  \"repetitions\": " << repetition_count << "," << std::endl << "  \"results\": [" << std::endl;
+
+    for (std::uint64_t i = 0; i < results.size(); i++) {
+        const auto &result = results[i];
+        file << "    {\"file\": \"" << result.file << "\", \"mode\": \"" << result.mode << "\", "
+            << "\"original_size\": " << result.original_size << ", \"compressed_size\": " << result.compressed_size << ", "
+            << std::fixed << std::setprecision(4) << "\"bits_per_symbol\": " << result.bits_per_symbol() << ", "
+            << std::setprecision(2) << "\"compress_mb_s\": " << result.compress_throughput() << ", "
+            << "\"decompress_mb_s\": " << result.decompress_throughput() << ", "
+            << "\"peak_rss_kib\": " << result.peak_rss << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+
+    file << "  ]" << std::endl << "}" << std::endl;
+    return true;
+}
+
+
+/**
+ * @brief Load the baseline results stored in the CSV format of the report.
+ *
+ * @param filename The name of the baseline file
+ * @param baseline The resulting baseline results indexed by the file and the mode
+ *
+ * @return True if the baseline is successfully loaded, false otherwise.
+ */
+bool load_baseline(const std::string &filename, std::map<std::pair<std::string, std::string>, BenchResult> &baseline) {
+    std::ifstream file(filename);
+
+    if (!file) {
+        std::cerr << "Cannot open the baseline '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    std::string line;
+
+    // Skip the column names
+    std::getline(file, line);
+
+    while (std::getline(file, line)) {
+        std::istringstream line_stream(line);
+        std::vector<std::string> fields;
+        std::string field;
+
+        while (std::getline(line_stream, field, ',')) {
+            fields.push_back(field);
+        }
+
+        if (fields.size() != 8) {
+            continue;
+        }
+
+        // The throughputs are stored instead of the times, so they are converted back
+        BenchResult result;
+        result.file = fields[0];
+        result.mode = fields[1];
+        result.original_size = std::stoull(fields[2]);
+        result.compressed_size = std::stoull(fields[3]);
+        const double compress_throughput = std::stod(fields[5]);
+        const double decompress_throughput = std::stod(fields[6]);
+        result.compress_time = compress_throughput > 0 ? result.original_size / compress_throughput / 1e6 : 0;
+        result.decompress_time = decompress_throughput > 0 ? result.original_size / decompress_throughput / 1e6 : 0;
+        result.peak_rss = std::stol(fields[7]);
+        baseline[{result.file, result.mode}] = result;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Compare the results with the baseline.
+ *
+ * @note The compressed size is compared for each file, the throughput only for the concatenated corpus of each mode (the times of
+ * the individual small files are dominated by the start of the codec process).
+ *
+ * @param results The results
+ * @param baseline The baseline results
+ * @param throughput_tolerance The allowed throughput drop (in percent)
+ * @param size_tolerance The allowed compressed size growth (in percent)
+ *
+ * @return True if no regression is found, false otherwise.
+ */
+bool check_regressions(
+    const std::vector<BenchResult> &results,
+    const std::map<std::pair<std::string, std::string>, BenchResult> &baseline,
+    const double throughput_tolerance,
+    const double size_tolerance
+) {
+    bool is_successful = true;
+
+    for (const auto &result: results) {
+        const auto baseline_it = baseline.find({result.file, result.mode});
+
+        if (baseline_it == baseline.end()) {
+            continue;
+        }
+
+        const auto &baseline_result = baseline_it->second;
+
+        if (result.compressed_size > baseline_result.compressed_size * (1 + size_tolerance / 100)) {
+            std::cerr << "Regression: " << result.file << " (" << result.mode << ") compressed size " << result.compressed_size
+                << " B, baseline " << baseline_result.compressed_size << " B" << std::endl;
+            is_successful = false;
+        }
+
+        if (result.file != TOTAL_ROW_NAME) {
+            continue;
+        }
+
+        const std::pair<const char *, std::pair<double, double>> throughputs[] = {
+            {"compression", {result.compress_throughput(), baseline_result.compress_throughput()}},
+            {"decompression", {result.decompress_throughput(), baseline_result.decompress_throughput()}}
+        };
+
+        for (const auto &[name, values]: throughputs) {
+            if (values.first < values.second * (1 - throughput_tolerance / 100)) {
+                std::cerr << "Regression: " << result.mode << " " << name << " throughput " << std::fixed << std::setprecision(2)
+                    << values.first << " MB/s, baseline " << values.second << " MB/s" << std::endl;
+                is_successful = false;
+            }
+        }
+    }
+
+    return is_successful;
+}
+
+
+/**
+ * @brief Print the usage of the program to the standard output.
+ *
+ * @param program The name of the program
+ */
+void print_usage(const char *program) {
+    std::cout << "Usage: " << program << " [-x <codec>] [-o <report_prefix>] [-b <baseline_csv>] [-r <repetition_count>] [-w <width_value>]" << std::endl;
+    std::cout << "       [-t <throughput_tolerance>] [-s <size_tolerance>] file..." << std::endl;
+    std::cout << std::endl;
+    std::cout << "  -x <codec>                  the codec binary (./huff_codec by default)" << std::endl;
+    std::cout << "  -o <report_prefix>          write the report to <report_prefix>.csv and <report_prefix>.json" << std::endl;
+    std::cout << "  -b <baseline_csv>           compare the results with the baseline (a CSV report of an earlier run)" << std::endl;
+    std::cout << "  -r <repetition_count>       the number of runs of each case, the minimum time is used (" << DEFAULT_REPETITION_COUNT << " by default)" << std::endl;
+    std::cout << "  -w <width_value>            the image width used with the adaptive image scanning (" << DEFAULT_WIDTH << " by default)" << std::endl;
+    std::cout << "  -t <throughput_tolerance>   the allowed throughput drop in percent (" << DEFAULT_THROUGHPUT_TOLERANCE << " by default)" << std::endl;
+    std::cout << "  -s <size_tolerance>         the allowed compressed size growth in percent (" << DEFAULT_SIZE_TOLERANCE << " by default)" << std::endl;
+}
+
+
+/**
+ * @brief Benchmark the compression and the decompression of all the files in all the modes, write the report and check the regressions.
+ *
+ * @param argc The number of command line arguments
+ * @param argv Values of command line arguments
+ *
+ * @return 0 in case of success without regressions, 1 otherwise.
+ */
+int main(int argc, char *argv[]) {
+    std::string codec = "./huff_codec";
+    std::string report_prefix;
+    std::string baseline_filename;
+    unsigned repetition_count = DEFAULT_REPETITION_COUNT;
+    std::uint64_t width = DEFAULT_WIDTH;
+    double throughput_tolerance = DEFAULT_THROUGHPUT_TOLERANCE;
+    double size_tolerance = DEFAULT_SIZE_TOLERANCE;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "x:o:b:r:w:t:s:h")) != -1) {
+        switch (opt) {
+            case 'x':
+                codec = optarg;
+                break;
+            case 'o':
+                report_prefix = optarg;
+                break;
+            case 'b':
+                baseline_filename = optarg;
+                break;
+            case 'r':
+                repetition_count = std::max(1, std::atoi(optarg));
+                break;
+            case 'w':
+                width = std::max(1ll, std::atoll(optarg));
+                break;
+            case 't':
+                throughput_tolerance = std::atof(optarg);
+                break;
+            case 's':
+                size_tolerance = std::atof(optarg);
+                break;
+            default:
+                print_usage(argv[0]);
+                return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<BenchMode> modes = {{"plain", {}}, {"m", {"-m"}}, {"a", {"-a"}}, {"ma", {"-m", "-a"}}};
+    const std::string work_path = (std::filesystem::temp_directory_path() / ("huff_corpus_bench_" + std::to_string(getpid()))).string();
+    const std::string corpus_filename = work_path + ".corpus";
+    std::vector<BenchResult> results;
+    bool is_successful = true;
+
+    if (!write_corpus_file(std::vector<std::string>(argv + optind, argv + argc), corpus_filename)) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::left << std::setw(16) << "file" << std::setw(8) << "mode" << std::right << std::setw(12) << "bits/symbol"
+        << std::setw(14) << "comp MB/s" << std::setw(14) << "decomp MB/s" << std::setw(12) << "RSS KiB" << std::endl;
+
+    for (const auto &mode: modes) {
+        for (int i = optind; i < argc; i++) {
+            BenchResult result;
+            result.file = std::filesystem::path(argv[i]).filename().string();
+            result.mode = mode.name;
+
+            if (!bench_file(codec, argv[i], mode, width, repetition_count, work_path, result)) {
+                is_successful = false;
+                continue;
+            }
+
+            results.push_back(result);
+        }
+
+        // The whole corpus is timed by the runs of the codec on the concatenated corpus
+        BenchResult total;
+        total.file = TOTAL_ROW_NAME;
+        total.mode = mode.name;
+
+        if (!bench_file(codec, corpus_filename, mode, width, repetition_count, work_path, total)) {
+            is_successful = false;
+            continue;
+        }
+
+        results.push_back(total);
+    }
+
+    std::filesystem::remove(work_path + ".c");
+    std::filesystem::remove(work_path + ".d");
+    std::filesystem::remove(corpus_filename);
+
+    for (const auto &result: results) {
+        std::cout << std::left << std::setw(16) << result.file << std::setw(8) << result.mode << std::right << std::fixed
+            << std::setprecision(4) << std::setw(12) << result.bits_per_symbol() << std::setprecision(2)
+            << std::setw(14) << result.compress_throughput() << std::setw(14) << result.decompress_throughput()
+            << std::setw(12) << result.peak_rss << std::endl;
+    }
+
+    if (!report_prefix.empty()) {
+        is_successful &= write_csv_report(report_prefix + ".csv", results);
+        is_successful &= write_json_report(report_prefix + ".json", results, repetition_count);
+    }
+
+    if (!baseline_filename.empty()) {
+        std::map<std::pair<std::string, std::string>, BenchResult> baseline;
+
+        if (!load_baseline(baseline_filename, baseline)) {
+            return EXIT_FAILURE;
+        }
+
+        if (check_regressions(results, baseline, throughput_tolerance, size_tolerance)) {
+            std::cout << "No regression against the baseline '" << baseline_filename << "'" << std::endl;
+        }
+        else {
+            is_successful = false;
+        }
+    }
+
+    return is_successful ? EXIT_SUCCESS : EXIT_FAILURE;
+}
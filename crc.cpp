@@ -0,0 +1,215 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief CRC32C (Castagnoli) checksum module
+ */
+
+
+#include <array>
+#include <cstring>
+
+#include "crc.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define HAS_CRC_INSTRUCTION
+#endif
+
+
+// The reversed Castagnoli polynomial
+#define CRC32C_POLYNOMIAL 0x82f63b78u
+
+#define SLICE_COUNT 8
+
+// The polynomial 1 in the reversed representation (the most significant bit is the coefficient of x^0)
+#define CRC32C_ONE 0x80000000u
+
+// The number of the precomputed powers x^(8 * 2^k), i.e. of the shifts by 2^k zero bytes
+#define ZERO_SHIFT_COUNT 64
+
+
+/**
+ * @brief Generate the tables of the slicing-by-8 computation.
+ *
+ * @return The tables, the first of them is the classic byte-wise table.
+ */
+constexpr std::array<std::array<std::uint32_t, 256>, SLICE_COUNT> generate_crc_tables() {
+    std::array<std::array<std::uint32_t, 256>, SLICE_COUNT> tables{};
+
+    for (std::uint32_t i = 0; i < 256; i++) {
+        std::uint32_t crc = i;
+
+        for (std::uint8_t j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (crc & 1 ? CRC32C_POLYNOMIAL : 0);
+        }
+
+        tables[0][i] = crc;
+    }
+
+    for (std::uint32_t i = 0; i < 256; i++) {
+        for (std::uint8_t j = 1; j < SLICE_COUNT; j++) {
+            tables[j][i] = (tables[j - 1][i] >> 8) ^ tables[0][tables[j - 1][i] & 0xff];
+        }
+    }
+
+    return tables;
+}
+
+
+constexpr auto CRC_TABLES = generate_crc_tables();
+
+
+/**
+ * @brief Multiply two polynomials modulo the Castagnoli polynomial (in the reversed representation).
+ *
+ * @param a The first polynomial
+ * @param b The second polynomial
+ *
+ * @return The product modulo the Castagnoli polynomial.
+ */
+constexpr std::uint32_t multiply_modulo_polynomial(std::uint32_t a, std::uint32_t b) {
+    std::uint32_t product = 0;
+
+    for (std::uint32_t mask = CRC32C_ONE; mask != 0; mask >>= 1) {
+        if (a & mask) {
+            product ^= b;
+        }
+
+        // Multiply b by x
+        b = (b >> 1) ^ (b & 1 ? CRC32C_POLYNOMIAL : 0);
+    }
+
+    return product;
+}
+
+
+/**
+ * @brief Generate the powers x^(8 * 2^k) modulo the Castagnoli polynomial shifting the checksum over 2^k zero bytes.
+ *
+ * @return The powers indexed by k.
+ */
+constexpr std::array<std::uint32_t, ZERO_SHIFT_COUNT> generate_zero_shifts() {
+    std::array<std::uint32_t, ZERO_SHIFT_COUNT> shifts{};
+    shifts[0] = CRC32C_ONE >> 8;
+
+    for (std::uint8_t i = 1; i < ZERO_SHIFT_COUNT; i++) {
+        shifts[i] = multiply_modulo_polynomial(shifts[i - 1], shifts[i - 1]);
+    }
+
+    return shifts;
+}
+
+
+constexpr auto ZERO_SHIFTS = generate_zero_shifts();
+
+
+/**
+ * @brief Update the (inverted) checksum by the data using the tables.
+ *
+ * @param data The data
+ * @param crc The inverted checksum of the preceding data
+ *
+ * @return The inverted checksum including the data.
+ */
+std::uint32_t update_crc_by_table(std::span<const std::uint8_t> data, std::uint32_t crc) {
+    const std::uint8_t *it = data.data();
+    std::uint64_t remaining_size = data.size();
+
+    while (remaining_size >= SLICE_COUNT) {
+        // The bytes are combined in little endian so that the computation does not depend on the byte order of the platform
+        const std::uint32_t low = crc ^ (it[0] | it[1] << 8 | it[2] << 16 | static_cast<std::uint32_t>(it[3]) << 24);
+        crc = CRC_TABLES[7][low & 0xff] ^ CRC_TABLES[6][(low >> 8) & 0xff] ^ CRC_TABLES[5][(low >> 16) & 0xff] ^ CRC_TABLES[4][low >> 24]
+            ^ CRC_TABLES[3][it[4]] ^ CRC_TABLES[2][it[5]] ^ CRC_TABLES[1][it[6]] ^ CRC_TABLES[0][it[7]];
+        it += SLICE_COUNT;
+        remaining_size -= SLICE_COUNT;
+    }
+
+    while (remaining_size-- > 0) {
+        crc = (crc >> 8) ^ CRC_TABLES[0][(crc ^ *it++) & 0xff];
+    }
+
+    return crc;
+}
+
+
+#ifdef HAS_CRC_INSTRUCTION
+/**
+ * @brief Update the (inverted) checksum by the data using the SSE4.2 crc32 instruction.
+ *
+ * @param data The data
+ * @param crc The inverted checksum of the preceding data
+ *
+ * @return The inverted checksum including the data.
+ */
+__attribute__((target("sse4.2"))) std::uint32_t update_crc_by_instruction(std::span<const std::uint8_t> data, std::uint32_t crc) {
+    const std::uint8_t *it = data.data();
+    std::uint64_t remaining_size = data.size();
+    std::uint64_t crc64 = crc;
+
+    while (remaining_size >= sizeof(std::uint64_t)) {
+        std::uint64_t value;
+        std::memcpy(&value, it, sizeof(value));
+        crc64 = _mm_crc32_u64(crc64, value);
+        it += sizeof(value);
+        remaining_size -= sizeof(value);
+    }
+
+    crc = crc64;
+
+    while (remaining_size-- > 0) {
+        crc = _mm_crc32_u8(crc, *it++);
+    }
+
+    return crc;
+}
+#endif
+
+
+/**
+ * @brief Update the (inverted) checksum by the data using the fastest computation supported by the processor.
+ *
+ * @param data The data
+ * @param crc The inverted checksum of the preceding data
+ *
+ * @return The inverted checksum including the data.
+ */
+std::uint32_t update_crc(std::span<const std::uint8_t> data, std::uint32_t crc) {
+#ifdef HAS_CRC_INSTRUCTION
+    static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+
+    if (has_sse42) {
+        return update_crc_by_instruction(data, crc);
+    }
+#endif
+
+    return update_crc_by_table(data, crc);
+}
+
+
+std::uint32_t crc32c(std::span<const std::uint8_t> data, std::uint32_t crc) {
+    return ~update_crc(data, ~crc);
+}
+
+
+std::uint32_t update_crc32c(
+    std::uint32_t crc,
+    const std::uint64_t data_size,
+    const std::uint64_t part_offset,
+    std::span<const std::uint8_t> original_part,
+    std::span<const std::uint8_t> changed_part
+) {
+    // The zeros preceding the difference do not change the zero checksum, so the checksum of the difference starts at the changed part
+    std::uint32_t difference_crc = update_crc(original_part, 0) ^ update_crc(changed_part, 0);
+    std::uint64_t zero_count = data_size - part_offset - changed_part.size();
+
+    for (std::uint8_t i = 0; zero_count > 0; i++, zero_count >>= 1) {
+        if (zero_count & 1) {
+            difference_crc = multiply_modulo_polynomial(ZERO_SHIFTS[i], difference_crc);
+        }
+    }
+
+    return crc ^ difference_crc;
+}
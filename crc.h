@@ -0,0 +1,58 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief CRC32C (Castagnoli) checksum interface
+ */
+
+
+#ifndef CRC_H
+#define CRC_H
+
+
+#include <span>
+#include <cstdint>
+
+
+// The number of bytes of the stored checksum
+#define CRC_BYTE_COUNT 4
+
+
+/**
+ * @brief Compute (or continue computing) the CRC32C checksum of the data.
+ *
+ * @note The SSE4.2 crc32 instruction is used if the processor supports it, the table-driven (slicing-by-8) computation otherwise.
+ *
+ * @param data The data
+ * @param crc The checksum of the preceding data (0 for the beginning of the data)
+ *
+ * @return The checksum of the preceding data followed by the data.
+ */
+std::uint32_t crc32c(std::span<const std::uint8_t> data, std::uint32_t crc = 0);
+
+/**
+ * @brief Update the CRC32C checksum of the data by the change of their part without processing the rest of the data.
+ *
+ * @note The checksums of two equally long data differ by the checksum (without the initial and the final inversion) of their difference,
+ * which is nonzero only at the changed part, so the zeros following the changed part are skipped in logarithmic time.
+ *
+ * @param crc The checksum of the data before the change
+ * @param data_size The size of the data
+ * @param part_offset The offset of the changed part in the data
+ * @param original_part The changed part before the change
+ * @param changed_part The changed part after the change (of the same size as before the change)
+ *
+ * @return The checksum of the data after the change.
+ */
+std::uint32_t update_crc32c(
+    std::uint32_t crc,
+    const std::uint64_t data_size,
+    const std::uint64_t part_offset,
+    std::span<const std::uint8_t> original_part,
+    std::span<const std::uint8_t> changed_part
+);
+
+
+#endif
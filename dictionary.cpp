@@ -0,0 +1,199 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Dictionary of the pretrained canonical Huffman code tables shared by the compressed data module
+ */
+
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <string>
+
+#include "dictionary.h"
+#include "crc.h"
+#include "error.h"
+
+
+#define BYTE_VALUE_COUNT 256
+
+// The clustering of the blocks usually settles within a few iterations
+#define TRAINING_ITERATION_COUNT 16
+
+// The maximum number of the blocks the tables are trained on
+#define MAX_TRAINING_BLOCK_COUNT 65536
+
+
+bool HuffmanDictionary::load(std::span<const std::uint8_t> dictionary_data) {
+    const std::uint8_t magic[DICTIONARY_MAGIC_SIZE] = DICTIONARY_MAGIC;
+    std::vector<HuffmanEncoder> loaded_encoders;
+    std::vector<HuffmanDecoder> loaded_decoders;
+
+    if (dictionary_data.size() < DICTIONARY_MAGIC_SIZE + 2 || !std::equal(magic, magic + DICTIONARY_MAGIC_SIZE, dictionary_data.begin())) {
+        report_error("Invalid dictionary - missing magic number");
+        return false;
+    }
+
+    if (dictionary_data[DICTIONARY_MAGIC_SIZE] != DICTIONARY_VERSION) {
+        report_error("Invalid dictionary - unsupported version: " + std::to_string(dictionary_data[DICTIONARY_MAGIC_SIZE]));
+        return false;
+    }
+
+    const unsigned table_count = dictionary_data[DICTIONARY_MAGIC_SIZE + 1];
+    auto tables = dictionary_data.subspan(DICTIONARY_MAGIC_SIZE + 2);
+
+    if (table_count == 0) {
+        report_error("Invalid dictionary - no code tables");
+        return false;
+    }
+
+    for (unsigned i = 0; i < table_count; i++) {
+        auto encoder = HuffmanEncoder();
+        auto decoder = HuffmanDecoder();
+        const std::uint64_t codebook_size = encoder.load_codebook(tables);
+
+        // The decoder accepts any codebook accepted by the encoder
+        if (codebook_size == 0) {
+            report_error("Invalid dictionary - invalid code table " + std::to_string(i));
+            return false;
+        }
+
+        decoder.set_source(tables);
+        decoder.initialize_decoding();
+        loaded_encoders.push_back(std::move(encoder));
+        loaded_decoders.push_back(std::move(decoder));
+        tables = tables.subspan(codebook_size);
+    }
+
+    if (!tables.empty()) {
+        report_error("Invalid dictionary - unexpected data after the code tables");
+        return false;
+    }
+
+    data.assign(dictionary_data.begin(), dictionary_data.end());
+    encoders = std::move(loaded_encoders);
+    decoders = std::move(loaded_decoders);
+    hash = crc32c(data);
+    return true;
+}
+
+
+void HuffmanDictionary::train(const std::vector<std::vector<std::uint64_t>> &corpus_block_freqs, const unsigned table_count) {
+    // The large corpora are represented by the evenly spaced blocks
+    const std::uint64_t block_count = std::min(corpus_block_freqs.size(), static_cast<std::size_t>(MAX_TRAINING_BLOCK_COUNT));
+    auto get_block_freqs = [&](const std::uint64_t block_index) -> const std::vector<std::uint64_t> & {
+        return corpus_block_freqs[block_index * corpus_block_freqs.size() / block_count];
+    };
+
+    const unsigned cluster_count = std::clamp(table_count, 1u, static_cast<unsigned>(std::min(block_count, static_cast<std::uint64_t>(MAX_DICTIONARY_TABLE_COUNT))));
+    std::vector<unsigned> assignment(block_count);
+    std::vector<HuffmanEncoder> cluster_encoders;
+    std::vector<std::uint8_t> codebooks;
+
+    // Build the table of each cluster from the summed histograms of its blocks, every symbol counted at least once
+    auto build_tables = [&]() {
+        std::vector<std::vector<std::uint64_t>> cluster_freqs(cluster_count, std::vector<std::uint64_t>(BYTE_VALUE_COUNT, 1));
+        std::vector<bool> is_used_cluster(cluster_count);
+
+        for (std::uint64_t i = 0; i < block_count; i++) {
+            is_used_cluster[assignment[i]] = true;
+
+            for (std::uint16_t j = 0; j < get_block_freqs(i).size() && j < BYTE_VALUE_COUNT; j++) {
+                cluster_freqs[assignment[i]][j] += get_block_freqs(i)[j];
+            }
+        }
+
+        cluster_encoders.clear();
+        codebooks.clear();
+
+        // The empty clusters are dropped
+        for (unsigned i = 0; i < cluster_count; i++) {
+            if (is_used_cluster[i]) {
+                cluster_encoders.emplace_back();
+                cluster_encoders.back().initialize_encoding(cluster_freqs[i], codebooks);
+            }
+        }
+    };
+
+    // The initial clusters split the blocks sorted by their size encoded by the table of the whole corpus into equal parts
+    std::vector<std::uint64_t> block_order(block_count);
+    std::vector<double> block_costs(block_count);
+    build_tables();
+
+    for (std::uint64_t i = 0; i < block_count; i++) {
+        const std::uint64_t symbol_count = std::accumulate(get_block_freqs(i).begin(), get_block_freqs(i).end(), static_cast<std::uint64_t>(0));
+        block_costs[i] = static_cast<double>(cluster_encoders.front().get_reused_encoded_size(get_block_freqs(i))) / std::max(symbol_count, static_cast<std::uint64_t>(1));
+    }
+
+    std::iota(block_order.begin(), block_order.end(), 0);
+    std::stable_sort(block_order.begin(), block_order.end(), [&](const std::uint64_t a, const std::uint64_t b) {
+        return block_costs[a] < block_costs[b];
+    });
+
+    for (std::uint64_t i = 0; i < block_count; i++) {
+        assignment[block_order[i]] = i * cluster_count / block_count;
+    }
+
+    for (unsigned iteration = 0; iteration < TRAINING_ITERATION_COUNT; iteration++) {
+        build_tables();
+        bool is_changed = false;
+
+        for (std::uint64_t i = 0; i < block_count; i++) {
+            unsigned best_table = 0;
+            std::uint64_t best_size = cluster_encoders.front().get_reused_encoded_size(get_block_freqs(i));
+
+            for (unsigned j = 1; j < cluster_encoders.size(); j++) {
+                const std::uint64_t size = cluster_encoders[j].get_reused_encoded_size(get_block_freqs(i));
+
+                if (size < best_size) {
+                    best_size = size;
+                    best_table = j;
+                }
+            }
+
+            is_changed |= best_table != assignment[i];
+            assignment[i] = best_table;
+        }
+
+        if (!is_changed) {
+            break;
+        }
+    }
+
+    build_tables();
+
+    const std::uint8_t magic[DICTIONARY_MAGIC_SIZE] = DICTIONARY_MAGIC;
+    std::vector<std::uint8_t> dictionary_data(magic, magic + DICTIONARY_MAGIC_SIZE);
+    dictionary_data.push_back(DICTIONARY_VERSION);
+    dictionary_data.push_back(cluster_encoders.size());
+    dictionary_data.insert(dictionary_data.end(), codebooks.begin(), codebooks.end());
+    load(dictionary_data);
+}
+
+
+const std::vector<std::uint8_t> &HuffmanDictionary::get_data() const {
+    return data;
+}
+
+
+std::uint32_t HuffmanDictionary::get_hash() const {
+    return hash;
+}
+
+
+unsigned HuffmanDictionary::get_table_count() const {
+    return encoders.size();
+}
+
+
+const std::vector<HuffmanEncoder> &HuffmanDictionary::get_encoders() const {
+    return encoders;
+}
+
+
+const std::vector<HuffmanDecoder> &HuffmanDictionary::get_decoders() const {
+    return decoders;
+}
@@ -0,0 +1,106 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Dictionary of the pretrained canonical Huffman code tables shared by the compressed data interface
+ */
+
+
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+#include "huffman.h"
+
+
+#define DICTIONARY_MAGIC {'H', 'U', 'F', 'D'}
+#define DICTIONARY_MAGIC_SIZE 4
+#define DICTIONARY_VERSION 1
+
+// The tables are referred to by their 1-byte indices
+#define MAX_DICTIONARY_TABLE_COUNT 255
+#define DEFAULT_DICTIONARY_TABLE_COUNT 8
+
+// The compressed data using the dictionary start with the CRC32C checksum of the whole dictionary file identifying it
+#define DICTIONARY_HASH_BYTE_COUNT 4
+
+
+/**
+ * @class Dictionary of the canonical Huffman code tables (with the end-of-block symbol) trained on a corpus of similar data
+ *
+ * @note The dictionary file consists of the magic number, the format version (1 byte), the number of the tables (1 byte)
+ * and the codebooks of the tables in the format stored by HuffmanEncoder::initialize_encoding.
+ */
+class HuffmanDictionary {
+    private:
+        std::vector<std::uint8_t> data;
+        std::vector<HuffmanEncoder> encoders;
+        std::vector<HuffmanDecoder> decoders;
+        std::uint32_t hash = 0;
+
+    public:
+        /**
+         * @brief Load the dictionary from the dictionary file data.
+         *
+         * @param dictionary_data The content of the dictionary file
+         *
+         * @return True if the dictionary is valid, false otherwise.
+         */
+        bool load(std::span<const std::uint8_t> dictionary_data);
+
+        /**
+         * @brief Train the tables on the histograms of the blocks of the corpus.
+         *
+         * @note The blocks are clustered by the k-means algorithm with the size of the encoded block as the distance,
+         * i.e. each block is assigned to the table encoding it to the fewest bytes and each table is rebuilt from its blocks.
+         * Each table codes all the symbols, so it can encode any block. The large corpora are subsampled.
+         *
+         * @param corpus_block_freqs The histograms of the symbols of the blocks (at least one)
+         * @param table_count The maximum number of the tables (from 1 to MAX_DICTIONARY_TABLE_COUNT)
+         */
+        void train(const std::vector<std::vector<std::uint64_t>> &corpus_block_freqs, const unsigned table_count);
+
+        /**
+         * @brief Get the content of the dictionary file.
+         *
+         * @return The dictionary file data (empty if no dictionary is loaded).
+         */
+        const std::vector<std::uint8_t> &get_data() const;
+
+        /**
+         * @brief Get the hash identifying the dictionary in the compressed data.
+         *
+         * @return The CRC32C checksum of the dictionary file.
+         */
+        std::uint32_t get_hash() const;
+
+        /**
+         * @brief Get the number of the tables.
+         *
+         * @return The number of the tables (0 if no dictionary is loaded).
+         */
+        unsigned get_table_count() const;
+
+        /**
+         * @brief Get the encoders with the loaded tables (to be copied by each compression using them).
+         *
+         * @return The encoders indexed by the table IDs.
+         */
+        const std::vector<HuffmanEncoder> &get_encoders() const;
+
+        /**
+         * @brief Get the decoders with the loaded tables (to be copied by each decompression using them).
+         *
+         * @return The decoders indexed by the table IDs.
+         */
+        const std::vector<HuffmanDecoder> &get_decoders() const;
+};
+
+
+#endif
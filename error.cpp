@@ -0,0 +1,24 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ * 
+ * @brief Codec error reporting module
+ */
+
+
+#include "error.h"
+
+
+thread_local std::string last_error;
+
+
+void report_error(const std::string &message) {
+    last_error = message;
+}
+
+
+const std::string &get_last_error() {
+    return last_error;
+}
@@ -0,0 +1,36 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ * 
+ * @brief Codec error reporting interface
+ */
+
+
+#ifndef ERROR_H
+#define ERROR_H
+
+
+#include <string>
+
+
+/**
+ * @brief Store the description of the error that occurred in the codec.
+ * 
+ * @note The description is stored separately for each thread, so the codec never writes to the standard error output itself
+ * and concurrent (de)compressions in different threads do not overwrite the descriptions of each other.
+ * 
+ * @param message The description of the error
+ */
+void report_error(const std::string &message);
+
+/**
+ * @brief Get the description of the last error that occurred in the codec in the current thread.
+ * 
+ * @return The description of the last error (empty if no error occurred).
+ */
+const std::string &get_last_error();
+
+
+#endif
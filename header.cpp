@@ -0,0 +1,107 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ * 
+ * @brief Self-describing header of the compressed data module
+ */
+
+
+#include <algorithm>
+#include <string>
+
+#include "header.h"
+#include "error.h"
+
+
+#define BYTE_BIT_LENGTH 8
+
+
+void append_number(std::vector<std::uint8_t> &data, const std::uint64_t value, const std::uint8_t byte_count) {
+    for (std::uint8_t i = 0; i < byte_count; i++) {
+        data.push_back(value >> i * BYTE_BIT_LENGTH);
+    }
+}
+
+
+void store_number(std::uint8_t *data, const std::uint64_t value, const std::uint8_t byte_count) {
+    for (std::uint8_t i = 0; i < byte_count; i++) {
+        data[i] = value >> i * BYTE_BIT_LENGTH;
+    }
+}
+
+
+std::uint64_t load_number(const std::uint8_t *data, const std::uint8_t byte_count) {
+    std::uint64_t value = 0;
+
+    for (std::uint8_t i = 0; i < byte_count; i++) {
+        value |= static_cast<std::uint64_t>(data[i]) << i * BYTE_BIT_LENGTH;
+    }
+
+    return value;
+}
+
+
+void write_header(const StreamHeader &header, std::vector<std::uint8_t> &compressed_data) {
+    compressed_data.insert(compressed_data.end(), HEADER_MAGIC);
+    compressed_data.push_back(FORMAT_VERSION);
+    append_number(compressed_data, header.flags, 2);
+    append_number(compressed_data, header.original_size, 8);
+    append_number(compressed_data, header.width, 8);
+}
+
+
+bool read_header(std::span<const std::uint8_t> compressed_data, StreamHeader &header) {
+    const std::uint8_t magic[] = HEADER_MAGIC;
+
+    if (compressed_data.size() < HEADER_SIZE || !std::equal(magic, magic + HEADER_MAGIC_SIZE, compressed_data.begin())) {
+        report_error("Invalid compressed data - missing header of the compressed data");
+        return false;
+    }
+
+    const std::uint8_t *field = compressed_data.data() + HEADER_MAGIC_SIZE;
+
+    if (*field != FORMAT_VERSION) {
+        report_error("Unsupported version of the compressed data format: " + std::to_string(*field));
+        return false;
+    }
+
+    header.flags = load_number(field + 1, 2);
+    header.original_size = load_number(field + 3, 8);
+    header.width = load_number(field + 11, 8);
+
+    if (header.flags & ~KNOWN_FLAGS) {
+        report_error("Unsupported mode flags of the compressed data");
+        return false;
+    }
+
+    if ((header.flags & FLAG_ADAPTIVE) && header.width == 0) {
+        report_error("Invalid compressed data - zero width of the decompressed data");
+        return false;
+    }
+
+    if ((header.flags & FLAG_CHUNKED) && (header.flags & FLAG_CHANNELS)) {
+        report_error("Invalid compressed data - the chunked data cannot be the multi-channel data at the same time");
+        return false;
+    }
+
+    // The blocks with the checksums are decodable independently of each other, so they cannot be predicted from the previous frame
+    if ((header.flags & FLAG_FRAMES) && (!(header.flags & FLAG_ADAPTIVE) || (header.flags & (FLAG_CHECKSUM | FLAG_CHUNKED | FLAG_CHANNELS)))) {
+        report_error("Invalid compressed data - the sequence of frames requires the adaptive scanning without the checksums");
+        return false;
+    }
+
+    // The chunks of the chunked data are quantized by themselves
+    if ((header.flags & FLAG_NEAR_LOSSLESS) && (header.flags & FLAG_CHUNKED)) {
+        report_error("Invalid compressed data - the chunked data cannot be quantized as a whole");
+        return false;
+    }
+
+    if ((header.flags & FLAG_SAMPLES_16) && header.original_size % 2 != 0) {
+        report_error("Invalid compressed data - odd size of the decompressed data of 16-bit samples");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,118 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ * 
+ * @brief Self-describing header of the compressed data interface
+ */
+
+
+#ifndef HEADER_H
+#define HEADER_H
+
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+
+#define HEADER_MAGIC {'H', 'U', 'F', 'C'}
+#define HEADER_MAGIC_SIZE 4
+#define HEADER_SIZE (HEADER_MAGIC_SIZE + 1 + 2 + 8 + 8)
+
+#define FORMAT_VERSION 1
+
+// Mode flags stored in the header
+#define FLAG_MODEL 0x0001       // The adjacent value difference model is used
+#define FLAG_RLE 0x0002         // The RLE is used
+#define FLAG_ADAPTIVE 0x0004    // The adaptive scanning is used
+#define FLAG_CHUNKED 0x0008     // The data are split into independently compressed chunks (each of them with its own header)
+#define FLAG_CHECKSUM 0x0010    // The blocks and the whole original data are protected by CRC32C checksums
+#define FLAG_RANS 0x0020        // The blocks may be encoded by rANS instead of Huffman encoding
+#define FLAG_SAMPLES_16 0x0040  // The data consist of 16-bit samples (in little endian), the width is given in samples
+#define FLAG_CHANNELS 0x0080    // The data consist of more channels compressed separately (each of them with its own header), the width is given in pixels
+#define FLAG_DICTIONARY 0x0100  // The blocks may be encoded by the code tables of the dictionary whose hash precedes the compressed content
+#define FLAG_THUMBNAIL 0x0200   // The compressed thumbnail of the image precedes the compressed content (following the hash of the dictionary)
+#define FLAG_FRAMES 0x0400      // The adaptively scanned data are a sequence of frames whose blocks may be predicted from the previous frame
+#define FLAG_NEAR_LOSSLESS 0x0800 // The samples are quantized with a bounded error, the parameters of their reconstruction precede the compressed content (following the thumbnail)
+
+#define KNOWN_FLAGS (FLAG_MODEL | FLAG_RLE | FLAG_ADAPTIVE | FLAG_CHUNKED | FLAG_CHECKSUM | FLAG_RANS | FLAG_SAMPLES_16 | FLAG_CHANNELS | FLAG_DICTIONARY | FLAG_THUMBNAIL | FLAG_FRAMES \
+    | FLAG_NEAR_LOSSLESS)
+
+// Each chunk of the chunked data (and each channel of the multi-channel data) is preceded by its size
+#define CHUNK_SIZE_BYTE_COUNT 8
+
+// The channels of the multi-channel data are preceded by the channel count, the layout (0 interleaved, 1 planar) and the color transform (1 byte each)
+#define CHANNEL_DESCRIPTOR_SIZE 3
+
+// The compressed thumbnail is preceded by the side of the cells it summarizes (1 byte) and by its size
+#define THUMBNAIL_DESCRIPTOR_SIZE (1 + CHUNK_SIZE_BYTE_COUNT)
+
+// The blocks of the sequence of frames are preceded by the height of the frames (in rows)
+#define FRAME_HEIGHT_BYTE_COUNT 8
+
+// The compressed quantized samples are preceded by the maximum error of the samples (1 byte) and by the maximum original sample (2 bytes)
+#define NEAR_LOSSLESS_DESCRIPTOR_SIZE 3
+
+
+/**
+ * @brief Header stored at the beginning of the compressed data.
+ * 
+ * @note The header consists of the magic number, the format version (1 byte), the mode flags (2 bytes), the original data size (8 bytes) 
+ * and the original data width (8 bytes, 0 when the adaptive scanning is not used). The numbers are stored in little endian.
+ */
+struct StreamHeader {
+    std::uint16_t flags = 0;            // Mode flags
+    std::uint64_t original_size = 0;    // The size of the original (decompressed) data
+    std::uint64_t width = 0;            // The width of the original data (2D image)
+};
+
+/**
+ * @brief Append the number to the data in little endian.
+ * 
+ * @param data Buffer to which the number is appended
+ * @param value The number to be appended
+ * @param byte_count The number of bytes of the stored number
+ */
+void append_number(std::vector<std::uint8_t> &data, const std::uint64_t value, const std::uint8_t byte_count);
+
+/**
+ * @brief Store the number to the already allocated place in little endian.
+ * 
+ * @param data The beginning of the place for the number
+ * @param value The number to be stored
+ * @param byte_count The number of bytes of the stored number
+ */
+void store_number(std::uint8_t *data, const std::uint64_t value, const std::uint8_t byte_count);
+
+/**
+ * @brief Load the number stored in little endian.
+ * 
+ * @param data The beginning of the stored number
+ * @param byte_count The number of bytes of the stored number
+ * 
+ * @return The loaded number.
+ */
+std::uint64_t load_number(const std::uint8_t *data, const std::uint8_t byte_count);
+
+/**
+ * @brief Append the header to the compressed data.
+ * 
+ * @param header The header to be stored
+ * @param compressed_data Buffer to which the header is appended
+ */
+void write_header(const StreamHeader &header, std::vector<std::uint8_t> &compressed_data);
+
+/**
+ * @brief Read and validate the header at the beginning of the compressed data.
+ * 
+ * @param compressed_data The compressed data
+ * @param header The resulting header
+ * 
+ * @return True if the compressed data start with a valid header, false otherwise.
+ */
+bool read_header(std::span<const std::uint8_t> compressed_data, StreamHeader &header);
+
+
+#endif
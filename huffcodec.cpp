@@ -0,0 +1,663 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Public C/C++ interface of the libhuffcodec library module
+ */
+
+
+#include <vector>
+#include <string>
+#include <span>
+#include <new>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#include "huffcodec.h"
+#include "compress.h"
+#include "dictionary.h"
+#include "channels.h"
+#include "thumbnail.h"
+#include "header.h"
+#include "crc.h"
+#include "error.h"
+
+
+/**
+ * @brief (De)compression context.
+ */
+struct hc_context {
+    std::vector<std::uint8_t> output;   // The output buffer reused by all the operations
+    std::string error;                  // The description of the last error
+    HuffmanDictionary dictionary;       // The dictionary of the code tables (without any tables if it is not loaded)
+};
+
+
+/**
+ * @brief Store the description of the error to the context.
+ *
+ * @param context The context
+ * @param status The reason of the failure
+ * @param message The description of the error
+ *
+ * @return The reason of the failure.
+ */
+hc_status set_context_error(hc_context *context, const hc_status status, const std::string &message) {
+    context->error = message;
+    return status;
+}
+
+
+/**
+ * @brief Pass the result kept in the output buffer of the context to the caller's buffer (if provided).
+ *
+ * @note The result is copied, so the results built in the output buffer (all but the decompressed data) occupy the memory twice
+ * with the caller's buffer.
+ *
+ * @param context The context
+ * @param dst The caller's buffer (or NULL)
+ * @param dst_capacity The capacity of the caller's buffer
+ * @param dst_size The resulting size of the result
+ *
+ * @return HC_OK in case of success, HC_ERROR_OUTPUT_TOO_SMALL if the result does not fit into the caller's buffer.
+ */
+hc_status pass_output(hc_context *context, std::uint8_t *dst, const std::size_t dst_capacity, std::size_t *dst_size) {
+    *dst_size = context->output.size();
+
+    if (dst == NULL) {
+        return HC_OK;
+    }
+
+    if (dst_capacity < context->output.size()) {
+        return set_context_error(context, HC_ERROR_OUTPUT_TOO_SMALL, "The output buffer is too small");
+    }
+
+    std::copy(context->output.begin(), context->output.end(), dst);
+    return HC_OK;
+}
+
+
+/**
+ * @brief Get the dictionary of the context to be used by the operations.
+ *
+ * @param context The context
+ *
+ * @return The dictionary or NULL if no dictionary is loaded.
+ */
+const HuffmanDictionary *get_dictionary(const hc_context *context) {
+    return context->dictionary.get_table_count() > 0 ? &context->dictionary : NULL;
+}
+
+
+/**
+ * @brief Check the mode flags and the width of the data to be compressed.
+ *
+ * @param context The context
+ * @param src_size The size of the data to be compressed
+ * @param mode The mode flags
+ * @param width The width of data (2D image)
+ *
+ * @return HC_OK if the data can be compressed in the mode, HC_ERROR_INVALID_ARGUMENT otherwise.
+ */
+hc_status check_mode(hc_context *context, const std::size_t src_size, const unsigned mode, const std::uint64_t width) {
+    if ((mode & HC_MODE_ADAPTIVE) && width == 0) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The image width must be greater than 0 for the adaptive scanning");
+    }
+
+    if ((mode & HC_MODE_SAMPLES_16) && src_size % 2 != 0) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The size of the data of 16-bit samples must be even");
+    }
+
+    const unsigned effort_level = (mode & HC_MODE_LEVEL_MASK) >> 8;
+
+    if (effort_level > MAX_EFFORT_LEVEL) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The effort level must be from 1 to 9 (or 0 for the default level)");
+    }
+
+    const unsigned channel_count = std::max((mode & HC_MODE_CHANNELS_MASK) >> 12, 1u);
+
+    if (channel_count > MAX_CHANNEL_COUNT) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The number of channels must be from 1 to 4 (or 0 for one channel)");
+    }
+
+    if ((mode & HC_MODE_YCOCG_R) && (mode & HC_MODE_SUBTRACT_GREEN)) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Only one color transform can be used");
+    }
+
+    if ((mode & HC_MODE_THUMBNAIL) && (mode & HC_MODE_MOSAIC)) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Only one scale of the thumbnail can be used");
+    }
+
+    if ((mode & (HC_MODE_THUMBNAIL | HC_MODE_MOSAIC)) && !(mode & HC_MODE_ADAPTIVE)) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The thumbnail requires the adaptive scanning");
+    }
+
+    if ((mode & HC_MODE_STATIC_CHUNKS) && (mode & HC_MODE_ADAPTIVE)) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The static chunks cannot be used with the adaptive scanning");
+    }
+
+    if ((mode & (HC_MODE_YCOCG_R | HC_MODE_SUBTRACT_GREEN)) && channel_count < COLOR_TRANSFORM_CHANNEL_COUNT) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The color transforms require at least 3 channels");
+    }
+
+    if (src_size % (channel_count * (mode & HC_MODE_SAMPLES_16 ? 2 : 1)) != 0) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The size of the multi-channel data must be a multiple of the size of one pixel");
+    }
+
+    return HC_OK;
+}
+
+
+/**
+ * @brief Get the color transform of the channels selected by the mode flags.
+ *
+ * @param mode The mode flags
+ *
+ * @return The color transform (see channels.h).
+ */
+unsigned get_color_transform(const unsigned mode) {
+    return mode & HC_MODE_YCOCG_R ? COLOR_TRANSFORM_YCOCG_R : (mode & HC_MODE_SUBTRACT_GREEN ? COLOR_TRANSFORM_SUBTRACT_GREEN : COLOR_TRANSFORM_NONE);
+}
+
+
+/**
+ * @brief Get the side of the cells summarized by the thumbnail selected by the mode flags.
+ *
+ * @param mode The mode flags
+ *
+ * @return The side of the cells (0 if no thumbnail is selected).
+ */
+unsigned get_thumbnail_cell_side(const unsigned mode) {
+    return mode & HC_MODE_MOSAIC ? THUMBNAIL_MOSAIC_CELL_SIDE : (mode & HC_MODE_THUMBNAIL ? THUMBNAIL_BLOCK_CELL_SIDE : 0);
+}
+
+
+hc_context *hc_context_create(void) {
+    return new (std::nothrow) hc_context();
+}
+
+
+void hc_context_destroy(hc_context *context) {
+    delete context;
+}
+
+
+std::size_t hc_compress_bound(std::size_t src_size, unsigned mode, std::uint64_t width) {
+    return hc_compress_frames_bound(src_size, mode, width, 0);
+}
+
+
+std::size_t hc_compress_frames_bound(std::size_t src_size, unsigned mode, std::uint64_t width, std::uint64_t frame_height) {
+    const std::size_t checksum_size = mode & HC_MODE_CHECKSUM ? CRC_BYTE_COUNT : 0;
+    const unsigned channel_count = (mode & HC_MODE_CHANNELS_MASK) >> 12;
+
+    if (src_size == 0) {
+        return HEADER_SIZE + checksum_size;
+    }
+
+    const unsigned thumbnail_modes = HC_MODE_THUMBNAIL | HC_MODE_MOSAIC;
+    const unsigned cell_side = get_thumbnail_cell_side(mode);
+    std::size_t thumbnail_bound = 0;
+
+    // The thumbnail is compressed as the lossless data of its own (with the same channels)
+    if (cell_side != 0 && (mode & HC_MODE_ADAPTIVE)) {
+        const std::uint64_t pixel_size = std::max(channel_count, 1u) * (mode & HC_MODE_SAMPLES_16 ? 2 : 1);
+        const std::uint64_t thumbnail_size = get_thumbnail_pixel_count(src_size / pixel_size, std::max(width, static_cast<std::uint64_t>(1)), cell_side) * pixel_size;
+        thumbnail_bound = THUMBNAIL_DESCRIPTOR_SIZE 
+            + hc_compress_bound(thumbnail_size, mode & ~(thumbnail_modes | HC_MODE_MAX_ERROR_MASK), get_thumbnail_width(width, cell_side));
+    }
+
+    // The quantized samples are preceded by the descriptor of the quantization
+    const std::size_t near_lossless_size = mode & HC_MODE_MAX_ERROR_MASK ? NEAR_LOSSLESS_DESCRIPTOR_SIZE : 0;
+
+    // Each channel is compressed separately with its own header and its size (and without any thumbnail and quantization)
+    if (channel_count > 1) {
+        const std::size_t channel_bound = hc_compress_frames_bound(
+            src_size / channel_count, mode & ~(HC_MODE_CHANNELS_MASK | thumbnail_modes | HC_MODE_MAX_ERROR_MASK), width, frame_height
+        );
+        return HEADER_SIZE + thumbnail_bound + near_lossless_size + CHANNEL_DESCRIPTOR_SIZE + channel_count * (CHUNK_SIZE_BYTE_COUNT + channel_bound) 
+            + checksum_size;
+    }
+
+    // The hash of the dictionary is counted in case the compression uses a dictionary
+    const std::size_t header_size = HEADER_SIZE + DICTIONARY_HASH_BYTE_COUNT + near_lossless_size;
+
+    // Each block that cannot be compressed is kept uncompressed with its compression flag
+    if (!(mode & HC_MODE_ADAPTIVE)) {
+        return header_size + src_size + 1 + checksum_size;
+    }
+
+    const std::uint64_t sample_count = mode & HC_MODE_SAMPLES_16 ? src_size / 2 : src_size;
+    width = std::max(width, static_cast<std::uint64_t>(1));
+    const std::uint64_t height = sample_count / width + (sample_count % width != 0 ? 1 : 0);
+    // Each frame of the sequence of frames is decomposed into the blocks separately
+    const std::uint64_t frame_count = frame_height != 0 ? (height + frame_height - 1) / frame_height : 1;
+    const std::uint64_t block_rows_per_frame = ((frame_height != 0 ? std::min(frame_height, height) : height) + BLOCK_SIDE_SIZE - 1) / BLOCK_SIDE_SIZE;
+    const std::uint64_t block_count = std::min(
+        sample_count,
+        ((width + BLOCK_SIDE_SIZE - 1) / BLOCK_SIDE_SIZE) * block_rows_per_frame * frame_count
+    );
+    const std::size_t frame_height_size = frame_height != 0 ? FRAME_HEIGHT_BYTE_COUNT : 0;
+
+    // The header, the scan direction and the compression flag of each block (and the size and the checksum of each block)
+    return header_size + thumbnail_bound + frame_height_size + src_size + (checksum_size > 0 ? 8 : 2) * block_count + checksum_size;
+}
+
+
+hc_status hc_compress(
+    hc_context *context,
+    const std::uint8_t *src,
+    std::size_t src_size,
+    std::uint8_t *dst,
+    std::size_t dst_capacity,
+    std::size_t *dst_size,
+    unsigned mode,
+    std::uint64_t width
+) {
+    return hc_compress_frames(context, src, src_size, dst, dst_capacity, dst_size, mode, width, 0);
+}
+
+
+hc_status hc_compress_frames(
+    hc_context *context,
+    const std::uint8_t *src,
+    std::size_t src_size,
+    std::uint8_t *dst,
+    std::size_t dst_capacity,
+    std::size_t *dst_size,
+    unsigned mode,
+    std::uint64_t width,
+    std::uint64_t frame_height
+) {
+    if (context == NULL || dst_size == NULL) {
+        return HC_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (src == NULL && src_size > 0) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Missing data to be compressed");
+    }
+
+    if (frame_height != 0 && (!(mode & HC_MODE_ADAPTIVE) || (mode & HC_MODE_CHECKSUM))) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The sequence of frames requires the adaptive scanning without the checksums");
+    }
+
+    const hc_status mode_status = check_mode(context, src_size, mode, width);
+
+    if (mode_status != HC_OK) {
+        return mode_status;
+    }
+
+    const unsigned effort_level = (mode & HC_MODE_LEVEL_MASK) >> 8;
+    CompressOptions options;
+    options.width_value = width;
+    options.sample_bits = mode & HC_MODE_SAMPLES_16 ? MAX_SAMPLE_BITS : MAX_BYTE_SAMPLE_BITS;
+    options.channel_count = std::max((mode & HC_MODE_CHANNELS_MASK) >> 12, 1u);
+    options.is_planar = mode & HC_MODE_PLANAR;
+    options.color_transform = get_color_transform(mode);
+    options.adapt_scan = mode & HC_MODE_ADAPTIVE;
+    options.use_model = mode & HC_MODE_MODEL;
+    options.use_rle = mode & HC_MODE_RLE;
+    options.use_checksum = mode & HC_MODE_CHECKSUM;
+    options.effort_level = effort_level == 0 ? DEFAULT_EFFORT_LEVEL : effort_level;
+    options.use_static_chunks = mode & HC_MODE_STATIC_CHUNKS;
+    options.thumbnail_cell_side = get_thumbnail_cell_side(mode);
+    options.frame_height = frame_height;
+    options.max_error = (mode & HC_MODE_MAX_ERROR_MASK) >> 20;
+
+    try {
+        const std::span<const std::uint8_t> data(src, src_size);
+        context->output.clear();
+
+        if (options.channel_count > 1) {
+            compress_channels(data, context->output, options, get_dictionary(context));
+        }
+        else {
+            compress_data(data, context->output, options, get_dictionary(context));
+        }
+    }
+    catch (const std::bad_alloc &) {
+        return set_context_error(context, HC_ERROR_OUT_OF_MEMORY, "Cannot allocate the memory for the compression");
+    }
+
+    return pass_output(context, dst, dst_capacity, dst_size);
+}
+
+
+hc_status hc_get_decompressed_size(const std::uint8_t *src, std::size_t src_size, std::uint64_t *decompressed_size) {
+    if ((src == NULL && src_size > 0) || decompressed_size == NULL) {
+        return HC_ERROR_INVALID_ARGUMENT;
+    }
+
+    return get_decompressed_size(std::span<const std::uint8_t>(src, src_size), *decompressed_size) ? HC_OK : HC_ERROR_INVALID_DATA;
+}
+
+
+hc_status hc_decompress(
+    hc_context *context,
+    const std::uint8_t *src,
+    std::size_t src_size,
+    std::uint8_t *dst,
+    std::size_t dst_capacity,
+    std::size_t *dst_size,
+    unsigned thread_count
+) {
+    if (context == NULL || dst_size == NULL) {
+        return HC_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (src == NULL && src_size > 0) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Missing data to be decompressed");
+    }
+
+    const std::span<const std::uint8_t> data(src, src_size);
+    context->output.clear();
+
+    try {
+        std::uint64_t decompressed_size;
+
+        if (!get_decompressed_size(data, decompressed_size)) {
+            return set_context_error(context, HC_ERROR_INVALID_DATA, get_last_error());
+        }
+
+        *dst_size = decompressed_size;
+
+        // The size is known in advance, so decompress straight to the caller's buffer
+        if (dst != NULL) {
+            if (dst_capacity < decompressed_size) {
+                return set_context_error(context, HC_ERROR_OUTPUT_TOO_SMALL, "The output buffer is too small");
+            }
+
+            if (!decompress_data(data, std::span<std::uint8_t>(dst, decompressed_size), std::max(thread_count, 1u), get_dictionary(context))) {
+                return set_context_error(context, HC_ERROR_INVALID_DATA, get_last_error());
+            }
+
+            return HC_OK;
+        }
+
+        if (!decompress_data(data, context->output, std::max(thread_count, 1u), get_dictionary(context))) {
+            return set_context_error(context, HC_ERROR_INVALID_DATA, get_last_error());
+        }
+    }
+    catch (const std::bad_alloc &) {
+        return set_context_error(context, HC_ERROR_OUT_OF_MEMORY, "Cannot allocate the memory for the decompression");
+    }
+    catch (const std::length_error &) {
+        // Corrupted headers or run lengths may ask for impossibly large data
+        return set_context_error(context, HC_ERROR_INVALID_DATA, "Invalid compressed data - the size of the decompressed data is too large");
+    }
+
+    return pass_output(context, dst, dst_capacity, dst_size);
+}
+
+
+hc_status hc_decompress_thumbnail(
+    hc_context *context,
+    const std::uint8_t *src,
+    std::size_t src_size,
+    std::uint8_t *dst,
+    std::size_t dst_capacity,
+    std::size_t *dst_size,
+    std::uint64_t *width,
+    unsigned *scale
+) {
+    if (context == NULL || dst_size == NULL || width == NULL || scale == NULL) {
+        return HC_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (src == NULL && src_size > 0) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Missing data to be decompressed");
+    }
+
+    try {
+        context->output.clear();
+
+        if (!decompress_thumbnail(std::span<const std::uint8_t>(src, src_size), context->output, *width, *scale)) {
+            return set_context_error(context, HC_ERROR_INVALID_DATA, get_last_error());
+        }
+    }
+    catch (const std::bad_alloc &) {
+        return set_context_error(context, HC_ERROR_OUT_OF_MEMORY, "Cannot allocate the memory for the decompression of the thumbnail");
+    }
+    catch (const std::length_error &) {
+        return set_context_error(context, HC_ERROR_INVALID_DATA, "Invalid compressed data - the size of the decompressed thumbnail is too large");
+    }
+
+    return pass_output(context, dst, dst_capacity, dst_size);
+}
+
+
+hc_status hc_verify(hc_context *context, const std::uint8_t *src, std::size_t src_size, unsigned thread_count) {
+    if (context == NULL) {
+        return HC_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (src == NULL && src_size > 0) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Missing data to be checked");
+    }
+
+    try {
+        if (!verify_data(std::span<const std::uint8_t>(src, src_size), std::max(thread_count, 1u), get_dictionary(context))) {
+            return set_context_error(context, HC_ERROR_INVALID_DATA, get_last_error());
+        }
+    }
+    catch (const std::bad_alloc &) {
+        return set_context_error(context, HC_ERROR_OUT_OF_MEMORY, "Cannot allocate the memory for the check");
+    }
+    catch (const std::length_error &) {
+        return set_context_error(context, HC_ERROR_INVALID_DATA, "Invalid compressed data - the size of the decompressed data is too large");
+    }
+
+    return HC_OK;
+}
+
+
+hc_status hc_update(
+    hc_context *context,
+    const std::uint8_t *src,
+    std::size_t src_size,
+    const std::uint8_t *region,
+    std::size_t region_size,
+    std::uint64_t x,
+    std::uint64_t y,
+    std::uint64_t region_width,
+    std::uint64_t region_height,
+    std::uint8_t *dst,
+    std::size_t dst_capacity,
+    std::size_t *dst_size,
+    unsigned mode
+) {
+    if (context == NULL || dst_size == NULL) {
+        return HC_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((src == NULL && src_size > 0) || (region == NULL && region_size > 0)) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Missing data to be updated");
+    }
+
+    const unsigned effort_level = (mode & HC_MODE_LEVEL_MASK) >> 8;
+
+    if (effort_level > MAX_EFFORT_LEVEL) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The effort level must be from 1 to 9 (or 0 for the default level)");
+    }
+
+    const std::span<const std::uint8_t> data(src, src_size);
+    StreamHeader header;
+
+    if (!read_header(data, header)) {
+        return set_context_error(context, HC_ERROR_INVALID_DATA, get_last_error());
+    }
+
+    // The blocks of the near-lossless data consist of the quantized samples, which the new samples of the region are not
+    if (!(header.flags & FLAG_ADAPTIVE) || !(header.flags & FLAG_CHECKSUM) || (header.flags & (FLAG_CHUNKED | FLAG_CHANNELS | FLAG_NEAR_LOSSLESS))) {
+        return set_context_error(
+            context, HC_ERROR_INVALID_ARGUMENT,
+            "Only the lossless data compressed with the adaptive scanning and the checksums (with one channel and without the chunks) can be updated"
+        );
+    }
+
+    const std::uint64_t sample_size = header.flags & FLAG_SAMPLES_16 ? 2 : 1;
+    const std::uint64_t sample_count = header.original_size / sample_size;
+    const std::uint64_t height = sample_count / header.width + (sample_count % header.width != 0 ? 1 : 0);
+
+    // The region has to lie inside the image including its incomplete last row
+    if (region_width == 0 || region_height == 0 || region_width > header.width || x > header.width - region_width || region_height > height 
+        || y > height - region_height || (y + region_height - 1) * header.width + x + region_width > sample_count) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The region must be nonempty and it must lie inside the image");
+    }
+
+    if (region_size != region_width * region_height * sample_size) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The size of the new samples must match the size of the region");
+    }
+
+    try {
+        context->output.clear();
+
+        if (!update_data(
+            data, std::span<const std::uint8_t>(region, region_size), x, y, region_width, region_height, 
+            effort_level == 0 ? DEFAULT_EFFORT_LEVEL : effort_level, get_dictionary(context), context->output
+        )) {
+            return set_context_error(context, HC_ERROR_INVALID_DATA, get_last_error());
+        }
+    }
+    catch (const std::bad_alloc &) {
+        return set_context_error(context, HC_ERROR_OUT_OF_MEMORY, "Cannot allocate the memory for the update");
+    }
+
+    return pass_output(context, dst, dst_capacity, dst_size);
+}
+
+
+hc_status hc_context_load_dictionary(hc_context *context, const std::uint8_t *dict, std::size_t dict_size) {
+    if (context == NULL) {
+        return HC_ERROR_INVALID_ARGUMENT;
+    }
+
+    try {
+        if (dict == NULL) {
+            context->dictionary = HuffmanDictionary();
+            return HC_OK;
+        }
+
+        if (!context->dictionary.load(std::span<const std::uint8_t>(dict, dict_size))) {
+            return set_context_error(context, HC_ERROR_INVALID_DATA, get_last_error());
+        }
+    }
+    catch (const std::bad_alloc &) {
+        return set_context_error(context, HC_ERROR_OUT_OF_MEMORY, "Cannot allocate the memory for the dictionary");
+    }
+
+    return HC_OK;
+}
+
+
+hc_status hc_train_dictionary(
+    hc_context *context,
+    const std::uint8_t *const *srcs,
+    const std::size_t *src_sizes,
+    std::size_t src_count,
+    std::uint8_t *dst,
+    std::size_t dst_capacity,
+    std::size_t *dst_size,
+    unsigned mode,
+    std::uint64_t width,
+    unsigned table_count
+) {
+    if (context == NULL || dst_size == NULL) {
+        return HC_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (src_count > 0 && (srcs == NULL || src_sizes == NULL)) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Missing data of the corpus");
+    }
+
+    if (table_count > MAX_DICTIONARY_TABLE_COUNT) {
+        return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The number of the tables must be from 1 to 255 (or 0 for the default number)");
+    }
+
+    for (std::size_t i = 0; i < src_count; i++) {
+        if (srcs[i] == NULL && src_sizes[i] > 0) {
+            return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "Missing data of the corpus");
+        }
+
+        const hc_status mode_status = check_mode(context, src_sizes[i], mode, width);
+
+        if (mode_status != HC_OK) {
+            return mode_status;
+        }
+    }
+
+    try {
+        const unsigned sample_bits = mode & HC_MODE_SAMPLES_16 ? MAX_SAMPLE_BITS : MAX_BYTE_SAMPLE_BITS;
+        const unsigned channel_count = std::max((mode & HC_MODE_CHANNELS_MASK) >> 12, 1u);
+        std::vector<std::vector<std::uint64_t>> block_freqs;
+        std::vector<std::vector<std::uint8_t>> planes;
+
+        for (std::size_t i = 0; i < src_count; i++) {
+            const std::span<const std::uint8_t> data(srcs[i], src_sizes[i]);
+
+            if (data.empty()) {
+                continue;
+            }
+
+            // The channels are compressed separately, so the tables are trained on their transformed planes
+            if (channel_count > 1) {
+                split_channels(data, sample_bits, channel_count, mode & HC_MODE_PLANAR, get_color_transform(mode), planes);
+
+                for (const auto &plane: planes) {
+                    collect_block_freqs(plane, width, sample_bits, mode & HC_MODE_ADAPTIVE, mode & HC_MODE_MODEL, mode & HC_MODE_RLE, block_freqs);
+                }
+            }
+            else {
+                collect_block_freqs(data, width, sample_bits, mode & HC_MODE_ADAPTIVE, mode & HC_MODE_MODEL, mode & HC_MODE_RLE, block_freqs);
+            }
+        }
+
+        if (block_freqs.empty()) {
+            return set_context_error(context, HC_ERROR_INVALID_ARGUMENT, "The corpus contains no data to train the dictionary on");
+        }
+
+        auto dictionary = HuffmanDictionary();
+        dictionary.train(block_freqs, table_count == 0 ? DEFAULT_DICTIONARY_TABLE_COUNT : table_count);
+        context->output = dictionary.get_data();
+    }
+    catch (const std::bad_alloc &) {
+        return set_context_error(context, HC_ERROR_OUT_OF_MEMORY, "Cannot allocate the memory for the training of the dictionary");
+    }
+
+    return pass_output(context, dst, dst_capacity, dst_size);
+}
+
+
+const std::uint8_t *hc_context_output(const hc_context *context, std::size_t *size) {
+    if (size != NULL) {
+        *size = context->output.size();
+    }
+
+    return context->output.data();
+}
+
+
+const char *hc_context_error(const hc_context *context) {
+    return context->error.c_str();
+}
+
+
+const char *hc_status_string(hc_status status) {
+    switch (status) {
+        case HC_OK:
+            return "OK";
+        case HC_ERROR_INVALID_ARGUMENT:
+            return "Invalid argument";
+        case HC_ERROR_INVALID_DATA:
+            return "Invalid compressed data";
+        case HC_ERROR_OUTPUT_TOO_SMALL:
+            return "Output buffer too small";
+        case HC_ERROR_OUT_OF_MEMORY:
+            return "Out of memory";
+    }
+
+    return "Unknown status";
+}
@@ -0,0 +1,391 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Public C/C++ interface of the libhuffcodec library (buffer-to-buffer compression and decompression)
+ *
+ * @note All the state of the (de)compression is kept in a context object. Different contexts can be used by different threads
+ * at the same time, one context must not be used by more threads at the same time. No function writes to the standard output
+ * or the standard error output, the failures are reported by the returned status and by the error description of the context.
+ */
+
+
+#ifndef HUFFCODEC_H
+#define HUFFCODEC_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#if defined(__GNUC__)
+#define HC_API __attribute__((visibility("default")))
+#else
+#define HC_API
+#endif
+
+
+// Mode flags (combinable by bitwise or)
+#define HC_MODE_MODEL 0x01      // Adjacent value difference model
+#define HC_MODE_RLE 0x02        // RLE
+#define HC_MODE_ADAPTIVE 0x04   // Adaptive scanning (the image is decomposed into blocks)
+#define HC_MODE_CHECKSUM 0x08   // CRC32C checksums of the blocks and of the whole data
+#define HC_MODE_SAMPLES_16 0x10 // 16-bit samples in little endian (for 9 to 16-bit data), the width is given in samples
+#define HC_MODE_PLANAR 0x20     // Planar layout of the channels (one channel after another) instead of the interleaved layout
+#define HC_MODE_SUBTRACT_GREEN 0x40 // Subtract-green color transform of the first three channels (R, G, B)
+#define HC_MODE_YCOCG_R 0x80    // YCoCg-R color transform of the first three channels (R, G, B)
+
+// Effort level of the compression (1 to 9, 0 selects the default level) combinable with the mode flags
+#define HC_MODE_LEVEL(level) ((unsigned)(level) << 8)
+#define HC_MODE_LEVEL_MASK 0xf00
+
+// The number of channels of the image (1 to 4, 0 selects one channel) combinable with the mode flags, the channels are compressed
+// separately and the width is given in pixels
+#define HC_MODE_CHANNELS(count) ((unsigned)(count) << 12)
+#define HC_MODE_CHANNELS_MASK 0xf000
+
+// Thumbnail of the image stored before its blocks (only with the adaptive scanning), decompressible by hc_decompress_thumbnail
+// without decoding the blocks, each pixel of which is the mean of one block (1/32 scale) or of one 8x8 cell (1/8 scale)
+#define HC_MODE_THUMBNAIL 0x10000
+#define HC_MODE_MOSAIC 0x20000
+
+// Statically scanned data split into the chunks of 1 MiB sharing one code table (only without the adaptive scanning),
+// so that the chunks are decompressed by more threads at the same time
+#define HC_MODE_STATIC_CHUNKS 0x40000
+
+// Near-lossless compression with the maximum absolute error of the decompressed samples (1 to 255, 0 selects the lossless compression)
+// combinable with the mode flags, the samples are quantized to the bins of 2 * max_error + 1 values before the model
+#define HC_MODE_MAX_ERROR(max_error) ((unsigned)(max_error) << 20)
+#define HC_MODE_MAX_ERROR_MASK 0xff00000
+
+
+/**
+ * @brief Results of the library functions.
+ */
+typedef enum hc_status {
+    HC_OK = 0,
+    HC_ERROR_INVALID_ARGUMENT,  // Invalid combination of the function arguments
+    HC_ERROR_INVALID_DATA,      // The compressed data are corrupted (or they are not produced by the library)
+    HC_ERROR_OUTPUT_TOO_SMALL,  // The capacity of the provided output buffer is lower than the size of the result
+    HC_ERROR_OUT_OF_MEMORY      // Allocation of the working memory failed
+} hc_status;
+
+/**
+ * @brief Opaque (de)compression context keeping the working buffers reused by all the operations performed with it.
+ */
+typedef struct hc_context hc_context;
+
+/**
+ * @brief Create a new (de)compression context.
+ *
+ * @return The new context or NULL if it cannot be allocated.
+ */
+HC_API hc_context *hc_context_create(void);
+
+/**
+ * @brief Destroy the context and release all its memory.
+ *
+ * @param context The context to be destroyed (may be NULL)
+ */
+HC_API void hc_context_destroy(hc_context *context);
+
+/**
+ * @brief Get the upper bound of the size of the compressed data.
+ *
+ * @param src_size The size of the data to be compressed
+ * @param mode The mode flags
+ * @param width The width of data (2D image), used only with the adaptive scanning
+ *
+ * @return The maximum size of the compressed data.
+ */
+HC_API size_t hc_compress_bound(size_t src_size, unsigned mode, uint64_t width);
+
+/**
+ * @brief Compress the data.
+ *
+ * @note The compressed data start with a header describing the mode, the size and the width of the data, so they can be decompressed
+ * without knowing the mode. If dst is NULL, the result is kept in the output buffer of the context (see hc_context_output).
+ *
+ * @note The compressed data are always built in the output buffer of the context (their size is known only at the end) and then copied
+ * to dst, so the compression to dst needs the memory for the compressed data twice. Passing NULL and reading the result
+ * by hc_context_output avoids the copy.
+ *
+ * @param context The context
+ * @param src The data to be compressed
+ * @param src_size The size of the data to be compressed
+ * @param dst The buffer for the compressed data (or NULL)
+ * @param dst_capacity The capacity of the buffer for the compressed data
+ * @param dst_size The resulting size of the compressed data (set also in case of HC_ERROR_OUTPUT_TOO_SMALL)
+ * @param mode The mode flags
+ * @param width The width of data (2D image), required with the adaptive scanning
+ *
+ * @return HC_OK in case of success, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_compress(
+    hc_context *context,
+    const uint8_t *src,
+    size_t src_size,
+    uint8_t *dst,
+    size_t dst_capacity,
+    size_t *dst_size,
+    unsigned mode,
+    uint64_t width
+);
+
+/**
+ * @brief Get the upper bound of the size of the compressed sequence of frames.
+ *
+ * @param src_size The size of the sequence of frames to be compressed
+ * @param mode The mode flags
+ * @param width The width of the frames, used only with the adaptive scanning
+ * @param frame_height The height of the frames (in rows)
+ *
+ * @return The maximum size of the compressed data.
+ */
+HC_API size_t hc_compress_frames_bound(size_t src_size, unsigned mode, uint64_t width, uint64_t frame_height);
+
+/**
+ * @brief Compress the sequence of same-sized frames (e.g. of a fixed camera) stored one after another.
+ *
+ * @note The frames are compressed by the adaptive scanning, each block of a frame is compressed either by itself or as its difference
+ * from the co-located block of the previous frame, and the code tables are reused across the frames. The sequence is decompressed
+ * by hc_decompress as any other compressed data. The checksums are not supported, as the blocks depend on the previous frame.
+ * As with hc_compress, the compressed data are copied to dst from the output buffer of the context.
+ *
+ * @param context The context
+ * @param src The frames to be compressed (the last one may be incomplete)
+ * @param src_size The size of the frames to be compressed
+ * @param dst The buffer for the compressed data (or NULL)
+ * @param dst_capacity The capacity of the buffer for the compressed data
+ * @param dst_size The resulting size of the compressed data (set also in case of HC_ERROR_OUTPUT_TOO_SMALL)
+ * @param mode The mode flags (with HC_MODE_ADAPTIVE and without HC_MODE_CHECKSUM)
+ * @param width The width of the frames
+ * @param frame_height The height of the frames (in rows, 0 compresses the data as a single image)
+ *
+ * @return HC_OK in case of success, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_compress_frames(
+    hc_context *context,
+    const uint8_t *src,
+    size_t src_size,
+    uint8_t *dst,
+    size_t dst_capacity,
+    size_t *dst_size,
+    unsigned mode,
+    uint64_t width,
+    uint64_t frame_height
+);
+
+/**
+ * @brief Get the size of the compressed data once they are decompressed.
+ *
+ * @param src The compressed data
+ * @param src_size The size of the compressed data
+ * @param decompressed_size The resulting size of the decompressed data
+ *
+ * @return HC_OK in case of success, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_get_decompressed_size(const uint8_t *src, size_t src_size, uint64_t *decompressed_size);
+
+/**
+ * @brief Decompress the data.
+ *
+ * @note The mode is read from the header of the compressed data. The chunks sharing the code table of the statically scanned data
+ * are decompressed by more threads at the same time. If dst is NULL, the result is kept in the output buffer of the context
+ * (see hc_context_output).
+ *
+ * @param context The context
+ * @param src The data to be decompressed
+ * @param src_size The size of the data to be decompressed
+ * @param dst The buffer for the decompressed data (or NULL)
+ * @param dst_capacity The capacity of the buffer for the decompressed data
+ * @param dst_size The resulting size of the decompressed data (set also in case of HC_ERROR_OUTPUT_TOO_SMALL)
+ * @param thread_count The maximum number of threads decompressing the data
+ *
+ * @return HC_OK in case of success, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_decompress(
+    hc_context *context,
+    const uint8_t *src,
+    size_t src_size,
+    uint8_t *dst,
+    size_t dst_capacity,
+    size_t *dst_size,
+    unsigned thread_count
+);
+
+/**
+ * @brief Decompress only the thumbnail stored in the compressed data (with HC_MODE_THUMBNAIL or HC_MODE_MOSAIC) without decoding the image.
+ *
+ * @note The thumbnail has the same samples and layout of the channels as the image, its last row is incomplete if the last row of the image is.
+ * The thumbnail needs no dictionary even if the image was compressed with one. If dst is NULL, the result is kept in the output buffer
+ * of the context (see hc_context_output).
+ *
+ * @param context The context
+ * @param src The compressed data
+ * @param src_size The size of the compressed data
+ * @param dst The buffer for the thumbnail (or NULL)
+ * @param dst_capacity The capacity of the buffer for the thumbnail
+ * @param dst_size The resulting size of the thumbnail (set also in case of HC_ERROR_OUTPUT_TOO_SMALL)
+ * @param width The resulting width of the thumbnail (in pixels)
+ * @param scale The resulting side of the cells of the image summarized by one pixel of the thumbnail (32 or 8)
+ *
+ * @return HC_OK in case of success, HC_ERROR_INVALID_DATA also if the data contain no thumbnail, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_decompress_thumbnail(
+    hc_context *context,
+    const uint8_t *src,
+    size_t src_size,
+    uint8_t *dst,
+    size_t dst_capacity,
+    size_t *dst_size,
+    uint64_t *width,
+    unsigned *scale
+);
+
+/**
+ * @brief Check the integrity of the compressed data by decompressing them without keeping the result and by checking their checksums.
+ *
+ * @note The chunks of the data and the blocks of the adaptively scanned data with the checksums are checked by more threads at the same time.
+ *
+ * @param context The context
+ * @param src The data to be checked
+ * @param src_size The size of the data to be checked
+ * @param thread_count The maximum number of threads checking the data
+ *
+ * @return HC_OK if the data are valid, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_verify(hc_context *context, const uint8_t *src, size_t src_size, unsigned thread_count);
+
+/**
+ * @brief Update a rectangular region of the compressed image by re-encoding only the blocks intersecting it.
+ *
+ * @note Only the data compressed with the adaptive scanning and the checksums (HC_MODE_ADAPTIVE | HC_MODE_CHECKSUM) with one channel
+ * and without the chunks can be updated, their blocks are independent of each other and their sizes are stored, so the cost of the update
+ * depends on the size of the region rather than on the size of the image. The data compressed with a dictionary require the context
+ * with the same dictionary. If dst is NULL, the updated data are kept in the output buffer of the context (see hc_context_output).
+ *
+ * @param context The context
+ * @param src The compressed data to be updated
+ * @param src_size The size of the compressed data to be updated
+ * @param region The new samples of the region row by row (the 16-bit samples in little endian)
+ * @param region_size The size of the new samples of the region
+ * @param x The horizontal position of the region in the image (in samples)
+ * @param y The vertical position of the region in the image (in rows)
+ * @param region_width The width of the region (in samples)
+ * @param region_height The height of the region (in rows)
+ * @param dst The buffer for the updated compressed data (or NULL)
+ * @param dst_capacity The capacity of the buffer for the updated compressed data
+ * @param dst_size The resulting size of the updated compressed data (set also in case of HC_ERROR_OUTPUT_TOO_SMALL)
+ * @param mode The effort level of the re-encoded blocks (see HC_MODE_LEVEL), the other mode flags are read from the compressed data
+ *
+ * @return HC_OK in case of success, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_update(
+    hc_context *context,
+    const uint8_t *src,
+    size_t src_size,
+    const uint8_t *region,
+    size_t region_size,
+    uint64_t x,
+    uint64_t y,
+    uint64_t region_width,
+    uint64_t region_height,
+    uint8_t *dst,
+    size_t dst_capacity,
+    size_t *dst_size,
+    unsigned mode
+);
+
+/**
+ * @brief Load the dictionary of the Huffman code tables shared by the compressed data (e.g. created by hc_train_dictionary) to the context.
+ *
+ * @note The compression with the context may encode the blocks by the tables of the dictionary instead of storing their own tables
+ * and the compressed data refer to the dictionary by its hash, so their decompression (and check) requires the context with the same dictionary.
+ * The dictionary is copied to the context.
+ *
+ * @param context The context
+ * @param dict The content of the dictionary file (or NULL to remove the dictionary from the context)
+ * @param dict_size The size of the content of the dictionary file
+ *
+ * @return HC_OK in case of success, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_context_load_dictionary(hc_context *context, const uint8_t *dict, size_t dict_size);
+
+/**
+ * @brief Train the dictionary of the Huffman code tables on a corpus of similar data compressed in the same mode.
+ *
+ * @note The tables are trained on the symbols of the blocks of the data (or of the whole data with the static scanning)
+ * after the preprocessing of the mode. If dst is NULL, the resulting dictionary file is kept in the output buffer of the context
+ * (see hc_context_output). The dictionary is not loaded to the context.
+ *
+ * @param context The context
+ * @param srcs The data of the corpus
+ * @param src_sizes The sizes of the data of the corpus
+ * @param src_count The number of the data of the corpus
+ * @param dst The buffer for the dictionary file (or NULL)
+ * @param dst_capacity The capacity of the buffer for the dictionary file
+ * @param dst_size The resulting size of the dictionary file (set also in case of HC_ERROR_OUTPUT_TOO_SMALL)
+ * @param mode The mode flags of the compression (the effort level and the checksums are not used)
+ * @param width The width of the data (2D images), required with the adaptive scanning
+ * @param table_count The maximum number of the tables (from 1 to 255, or 0 for the default number of 8)
+ *
+ * @return HC_OK in case of success, the reason of the failure otherwise.
+ */
+HC_API hc_status hc_train_dictionary(
+    hc_context *context,
+    const uint8_t *const *srcs,
+    const size_t *src_sizes,
+    size_t src_count,
+    uint8_t *dst,
+    size_t dst_capacity,
+    size_t *dst_size,
+    unsigned mode,
+    uint64_t width,
+    unsigned table_count
+);
+
+/**
+ * @brief Get the output buffer of the context holding the result of the last operation performed with dst equal to NULL.
+ *
+ * @note The buffer is valid until the next operation performed with the context.
+ *
+ * @param context The context
+ * @param size The resulting size of the data in the output buffer
+ *
+ * @return The beginning of the output buffer.
+ */
+HC_API const uint8_t *hc_context_output(const hc_context *context, size_t *size);
+
+/**
+ * @brief Get the description of the last error that occurred in the context.
+ *
+ * @param context The context
+ *
+ * @return The description of the last error (empty if no error occurred).
+ */
+HC_API const char *hc_context_error(const hc_context *context);
+
+/**
+ * @brief Get the textual name of the status.
+ *
+ * @param status The status
+ *
+ * @return The name of the status.
+ */
+HC_API const char *hc_status_string(hc_status status);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
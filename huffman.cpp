@@ -10,70 +10,432 @@
 
 #include <algorithm>
 #include <utility>
-#include <iostream>
 #include <numeric>
+#include <limits>
+#include <array>
+#include <bit>
+#include <cstring>
 
 #include "huffman.h"
+#include "error.h"
 
 
 #define BYTE_VALUE_COUNT 256
 #define FIRST_CODE 0
 #define BYTE_BIT_LENGTH 8
 
+// The codes of the loaded codebooks have to fit into the 64-bit code values
+#define MAX_LOADED_CODE_BITLEN 63
 
-std::vector<std::uint64_t> get_freqs(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last) {
+// The codes of all 256 symbols of the compact codebooks have to fit into the 64-bit numbers of the codes of the longest bit length
+#define MAX_COMPACT_CODE_BITLEN 55
+
+// The frequencies are sorted together with the symbols (up to 2^16 of them) in the low bits of the keys
+#define SORT_KEY_SYMBOL_BIT_LENGTH 16
+#define SORT_KEY_SYMBOL_MASK 0xffff
+
+// The first byte of the compact codebook is the longest code bit length with the highest bit set (the listed codebooks have at most 127 code bit lengths there)
+#define COMPACT_CODEBOOK_FLAG 0x80
+#define COMPACT_CODEBOOK_SYMBOL_COUNT_BIT_LENGTH 8
+
+// The Exp-Golomb codes of the gaps between the symbols (below 256) and of the code bit length differences (below 55) have at most 8 leading zeros
+#define MAX_EXP_GOLOMB_ZERO_COUNT 8
+
+// The codebook is read through a 64-bit buffer refilled to at least 56 bits before the Exp-Golomb codes of each symbol (at most 2 * 17 bits)
+#define BIT_BUFFER_BYTE_COUNT 8
+#define MIN_BIT_BUFFER_LENGTH 56
+
+// The Exp-Golomb codes of up to two symbols fitting into the leading bits of the buffer are decoded by a single lookup
+#define CODE_PAIR_TABLE_BIT_LENGTH 12
+#define CODE_PAIR_VALUE_BIT_LENGTH 6
+#define CODE_PAIR_VALUE_MASK 0x3f
+#define CODE_PAIR_BITLEN_BIT_LENGTH 4
+#define CODE_PAIR_BITLEN_MASK 0xf
+
+
+std::vector<std::uint64_t> get_freqs(std::span<const std::uint8_t> data) {
     std::vector<std::uint64_t> freqs(BYTE_VALUE_COUNT);
 
-    while (first < last) {
-        freqs[*first++]++;
+    for (const auto &val: data) {
+        freqs[val]++;
     }
 
     return freqs;
 }
 
 
+/**
+ * @brief Get the symbol at the specified position of the order of the symbols in the compact codebook (0, 255, 1, 254, ...).
+ * 
+ * @param position The position of the symbol (from 0 to 255)
+ * 
+ * @return The symbol at the position.
+ */
+inline std::uint8_t get_compact_codebook_symbol(const std::uint16_t position) {
+    return position % 2 == 0 ? position / 2 : UINT8_MAX - position / 2;
+}
+
+
+/**
+ * @brief Get the size of the Exp-Golomb code (of order 0) of the value.
+ * 
+ * @param value The non-negative value
+ * 
+ * @return The bit length of the code.
+ */
+inline std::uint64_t get_exp_golomb_bitlen(const std::uint64_t value) {
+    return 2 * std::bit_width(value + 1) - 1;
+}
+
+
+/**
+ * @brief Map the signed difference to the non-negative value by the zigzag mapping (0, -1, 1, -2, 2, ...).
+ * 
+ * @param difference The signed difference
+ * 
+ * @return The zigzag value of the difference.
+ */
+inline std::uint64_t get_zigzag_value(const std::int64_t difference) {
+    return difference >= 0 ? 2 * difference : -2 * difference - 1;
+}
+
+
+/**
+ * @brief Generate the table decoding the Exp-Golomb codes (of order 0) of the symbols of the compact codebook by their leading bits.
+ * 
+ * @return The table indexed by the leading CODE_PAIR_TABLE_BIT_LENGTH bits, each entry consists of the bit length of the codes of the first symbol,
+ * the bit length of the codes of both symbols (0 if the second one does not fit) and the values of the codes (by CODE_PAIR_VALUE_BIT_LENGTH bits).
+ * The entry is 0 if even the codes of the first symbol do not fit into the leading bits.
+ */
+constexpr std::array<std::uint32_t, 1 << CODE_PAIR_TABLE_BIT_LENGTH> generate_code_pair_table() {
+    std::array<std::uint32_t, 1 << CODE_PAIR_TABLE_BIT_LENGTH> table{};
+
+    for (std::uint32_t i = 0; i < table.size(); i++) {
+        // The bits are aligned to the highest bit of the 32-bit value
+        std::uint32_t bits = i << (32 - CODE_PAIR_TABLE_BIT_LENGTH);
+        std::uint8_t bit_count = 0;
+        std::uint32_t values = 0;
+        std::uint32_t bitlens = 0;
+
+        for (std::uint8_t j = 0; j < 4; j++) {
+            const std::uint8_t code_bitlen = 2 * std::countl_zero(bits) + 1;
+
+            if (bit_count + code_bitlen > CODE_PAIR_TABLE_BIT_LENGTH) {
+                break;
+            }
+
+            bit_count += code_bitlen;
+            values |= ((bits >> (32 - code_bitlen)) - 1) << (3 - j) * CODE_PAIR_VALUE_BIT_LENGTH;
+            bits <<= code_bitlen;
+
+            // The bit lengths are stored after the both codes of a symbol
+            if (j % 2 == 1) {
+                bitlens |= bit_count << (j == 1 ? 1 : 0) * CODE_PAIR_BITLEN_BIT_LENGTH;
+            }
+        }
+
+        if (bitlens != 0) {
+            table[i] = bitlens << 4 * CODE_PAIR_VALUE_BIT_LENGTH | values;
+        }
+    }
+
+    return table;
+}
+
+
+constexpr auto CODE_PAIR_TABLE = generate_code_pair_table();
+
+
+/**
+ * @brief Append the Exp-Golomb code (of order 0) of the value to the bits stored to the encoded data by whole bytes.
+ * 
+ * @param value The non-negative value (below 2^16)
+ * @param bit_buffer The buffer of the bits not stored yet (in its lowest bits)
+ * @param bit_buffer_length The number of the bits not stored yet (below 8)
+ * @param encoded_data Buffer for storing encoded data
+ */
+void append_exp_golomb(const std::uint64_t value, std::uint64_t &bit_buffer, std::uint8_t &bit_buffer_length, std::vector<std::uint8_t> &encoded_data) {
+    // The code is the value incremented by one preceded by one zero less than its bit length
+    const std::uint8_t code_bitlen = get_exp_golomb_bitlen(value);
+    bit_buffer = bit_buffer << code_bitlen | (value + 1);
+    bit_buffer_length += code_bitlen;
+
+    while (bit_buffer_length >= BYTE_BIT_LENGTH) {
+        bit_buffer_length -= BYTE_BIT_LENGTH;
+        encoded_data.push_back(bit_buffer >> bit_buffer_length);
+    }
+}
+
+
+/**
+ * @brief Read the Exp-Golomb code (of order 0) from the buffer of the bits.
+ * 
+ * @param bit_buffer The bits starting with the code aligned to the highest bit, shifted by the read code
+ * @param bit_buffer_length The number of the valid bits in the buffer, decremented by the bit length of the read code
+ * @param value The resulting value
+ * 
+ * @return True if the code has at most MAX_EXP_GOLOMB_ZERO_COUNT leading zeros, false otherwise.
+ */
+inline bool read_exp_golomb(std::uint64_t &bit_buffer, std::uint8_t &bit_buffer_length, std::uint64_t &value) {
+    const std::uint8_t zero_count = std::countl_zero(bit_buffer);
+
+    if (zero_count > MAX_EXP_GOLOMB_ZERO_COUNT) {
+        return false;
+    }
+
+    const std::uint8_t code_bitlen = 2 * zero_count + 1;
+    value = (bit_buffer >> (std::numeric_limits<std::uint64_t>::digits - code_bitlen)) - 1;
+    bit_buffer <<= code_bitlen;
+    bit_buffer_length -= code_bitlen;
+    return true;
+}
+
+
+/**
+ * @brief Refill the buffer of the bits of the data to at least 56 valid bits.
+ * 
+ * @note The next bytes are loaded at once and added behind the valid bits (the bits of the partially added byte are added again),
+ * so that the refill does not depend on the number of the bits consumed before (the bits past the end of the data are zero).
+ * 
+ * @param data The data
+ * @param byte_offset The offset of the first byte not added to the buffer entirely, advanced by the added bytes
+ * @param bit_buffer The valid bits aligned to the highest bit
+ * @param bit_buffer_length The number of the valid bits in the buffer (below 64)
+ */
+inline void refill_bit_buffer(std::span<const std::uint8_t> data, std::uint64_t &byte_offset, std::uint64_t &bit_buffer, std::uint8_t &bit_buffer_length) {
+    std::uint64_t bits = 0;
+
+    if (byte_offset + BIT_BUFFER_BYTE_COUNT <= data.size()) {
+        std::memcpy(&bits, data.data() + byte_offset, BIT_BUFFER_BYTE_COUNT);
+
+        if constexpr (std::endian::native == std::endian::little) {
+            bits = __builtin_bswap64(bits);
+        }
+    }
+    else {
+        for (std::uint64_t i = byte_offset; i < byte_offset + BIT_BUFFER_BYTE_COUNT; i++) {
+            bits = bits << BYTE_BIT_LENGTH | (i < data.size() ? data[i] : 0);
+        }
+    }
+
+    bit_buffer |= bits >> bit_buffer_length;
+    byte_offset += (std::numeric_limits<std::uint64_t>::digits - 1 - bit_buffer_length) / BYTE_BIT_LENGTH;
+    bit_buffer_length |= MIN_BIT_BUFFER_LENGTH;
+}
+
+
+/**
+ * @brief Code bit lengths of the used symbols read from a compact codebook.
+ */
+struct CompactCodebook {
+    std::uint8_t max_code_bitlen;                                           // The longest code bit length
+    std::uint16_t symbol_count;                                             // The number of the used symbols
+    std::array<std::uint8_t, BYTE_VALUE_COUNT> symbols;                     // The used symbols in the ascending order
+    std::array<std::uint8_t, BYTE_VALUE_COUNT> code_bitlens;                // The code bit lengths of the used symbols
+    std::array<std::uint16_t, MAX_COMPACT_CODE_BITLEN + 1> symbol_counts;   // The numbers of the used symbols of the individual code bit lengths
+    std::uint64_t unused_code_count;                                        // The number of the codes of the longest bit length left unused
+};
+
+
+/**
+ * @brief Read the code bit lengths of the used symbols from the compact codebook stored by HuffmanEncoder::initialize_encoding.
+ * 
+ * @param codebook The stored codebook (starting with its first byte with COMPACT_CODEBOOK_FLAG)
+ * @param add_end_of_block Indicates whether a code for the special end-of-block symbol is added
+ * @param compact_codebook The resulting code bit lengths of the used symbols
+ * 
+ * @return The size of the codebook (in bytes) if it is valid and its codes (with the end-of-block symbol) are not oversubscribed, 0 otherwise.
+ */
+std::uint64_t read_compact_codebook(std::span<const std::uint8_t> codebook, const bool add_end_of_block, CompactCodebook &compact_codebook) {
+    const std::uint8_t max_code_bitlen = codebook[0] & ~COMPACT_CODEBOOK_FLAG;
+
+    if (max_code_bitlen == 0 || max_code_bitlen > MAX_COMPACT_CODE_BITLEN) {
+        return 0;
+    }
+
+    const auto bits = codebook.subspan(1);
+    const std::uint16_t symbol_count = (bits.empty() ? 0 : bits[0]) + 1;
+    std::uint64_t byte_offset = COMPACT_CODEBOOK_SYMBOL_COUNT_BIT_LENGTH / BYTE_BIT_LENGTH;
+    std::uint64_t bit_buffer = 0;
+    std::uint8_t bit_buffer_length = 0;
+    std::uint64_t position = 0;
+    std::int64_t code_bitlen = 0;
+    // The symbols at the even positions are ascending and the symbols at the odd positions are descending, so they fill the ascending order from both ends
+    std::uint16_t low_symbol_index = 0;
+    std::uint16_t high_symbol_index = symbol_count;
+    compact_codebook.symbol_counts.fill(0);
+
+    // The codes are decoded first (mostly by two symbols at once), so that their validation does not delay the decoding of the next codes
+    std::array<std::uint16_t, BYTE_VALUE_COUNT + 1> gaps;
+    std::array<std::uint16_t, BYTE_VALUE_COUNT + 1> zigzag_differences;
+
+    for (std::uint16_t i = 0; i < symbol_count;) {
+        refill_bit_buffer(bits, byte_offset, bit_buffer, bit_buffer_length);
+        const std::uint32_t code_pairs = CODE_PAIR_TABLE[bit_buffer >> (std::numeric_limits<std::uint64_t>::digits - CODE_PAIR_TABLE_BIT_LENGTH)];
+
+        if (code_pairs == 0) {
+            std::uint64_t gap;
+            std::uint64_t zigzag_difference;
+
+            if (!read_exp_golomb(bit_buffer, bit_buffer_length, gap) || !read_exp_golomb(bit_buffer, bit_buffer_length, zigzag_difference)) {
+                return 0;
+            }
+
+            gaps[i] = gap;
+            zigzag_differences[i++] = zigzag_difference;
+            continue;
+        }
+
+        const std::uint8_t first_bitlen = code_pairs >> (4 * CODE_PAIR_VALUE_BIT_LENGTH + CODE_PAIR_BITLEN_BIT_LENGTH);
+        const std::uint8_t both_bitlen = code_pairs >> 4 * CODE_PAIR_VALUE_BIT_LENGTH & CODE_PAIR_BITLEN_MASK;
+        // The codes of the second symbol are stored even if they are not used, they are overwritten then
+        const bool has_second_symbol = both_bitlen != 0 && i + 1 < symbol_count;
+        const std::uint8_t code_pairs_bitlen = has_second_symbol ? both_bitlen : first_bitlen;
+        gaps[i] = code_pairs >> 3 * CODE_PAIR_VALUE_BIT_LENGTH & CODE_PAIR_VALUE_MASK;
+        zigzag_differences[i] = code_pairs >> 2 * CODE_PAIR_VALUE_BIT_LENGTH & CODE_PAIR_VALUE_MASK;
+        gaps[i + 1] = code_pairs >> CODE_PAIR_VALUE_BIT_LENGTH & CODE_PAIR_VALUE_MASK;
+        zigzag_differences[i + 1] = code_pairs & CODE_PAIR_VALUE_MASK;
+        bit_buffer <<= code_pairs_bitlen;
+        bit_buffer_length -= code_pairs_bitlen;
+        i += 1 + has_second_symbol;
+    }
+
+    for (std::uint16_t i = 0; i < symbol_count; i++) {
+        const std::uint64_t gap = gaps[i];
+        const std::uint64_t zigzag_difference = zigzag_differences[i];
+        position += gap;
+        code_bitlen += static_cast<std::int64_t>(zigzag_difference >> 1) ^ -static_cast<std::int64_t>(zigzag_difference & 1);
+
+        if (position >= BYTE_VALUE_COUNT || static_cast<std::uint64_t>(code_bitlen - 1) >= max_code_bitlen) {
+            return 0;
+        }
+
+        const bool is_high_symbol = position % 2 == 1;
+        const std::uint16_t symbol_index = is_high_symbol ? high_symbol_index - 1 : low_symbol_index;
+        low_symbol_index += !is_high_symbol;
+        high_symbol_index -= is_high_symbol;
+        compact_codebook.symbols[symbol_index] = get_compact_codebook_symbol(position++);
+        compact_codebook.code_bitlens[symbol_index] = code_bitlen;
+        compact_codebook.symbol_counts[code_bitlen]++;
+    }
+
+    // The bits of the partially consumed bytes are not counted in the buffer
+    const std::uint64_t bit_offset = byte_offset * BYTE_BIT_LENGTH - bit_buffer_length;
+
+    if (bit_offset > bits.size() * BYTE_BIT_LENGTH) {
+        return 0;
+    }
+
+    // The number of the codes of the longest bit length used by the symbols (according to Kraft's inequality)
+    std::uint64_t used_code_count = 0;
+
+    for (std::uint8_t i = 1; i <= max_code_bitlen; i++) {
+        used_code_count += static_cast<std::uint64_t>(compact_codebook.symbol_counts[i]) << (max_code_bitlen - i);
+    }
+
+    // The end-of-block symbol takes one more code
+    if (used_code_count + add_end_of_block > static_cast<std::uint64_t>(1) << max_code_bitlen) {
+        return 0;
+    }
+
+    compact_codebook.max_code_bitlen = max_code_bitlen;
+    compact_codebook.symbol_count = symbol_count;
+    compact_codebook.unused_code_count = (static_cast<std::uint64_t>(1) << max_code_bitlen) - add_end_of_block - used_code_count;
+    return 1 + (bit_offset + BYTE_BIT_LENGTH - 1) / BYTE_BIT_LENGTH;
+}
+
+
 std::vector<std::uint8_t> HuffmanEncoder::compute_code_bitlens(const std::vector<std::uint64_t> &freqs) {
-    std::uint16_t m = freqs.size();
-    std::vector<std::uint16_t> hr(2 * m);
-    std::vector<std::pair<std::uint64_t, std::uint16_t>> h(m);
+    const std::uint16_t m = freqs.size();
+    std::vector<std::uint8_t> code_bitlens(m, 1);
 
-    for (std::uint16_t i = 0; i < m; i++) {
-        h[i] = std::make_pair(freqs[i], m + i);
+    if (m < 2) {
+        return code_bitlens;
     }
 
-    std::make_heap(h.begin(), h.end(), std::greater<>{});
+    // The symbols are sorted by their frequencies (the ties by the symbols), the frequencies small enough are sorted with the symbols in single keys
+    std::vector<std::uint16_t> order(m);
+    std::vector<std::uint64_t> a(m);
 
-    // Perform Hirschberg-Sieminski algorithm
-    while (m > 1) {
-        std::pop_heap(h.begin(), h.end(), std::greater<>{});
-        auto a = h.back();
-        h.pop_back();
+    if (*std::max_element(freqs.begin(), freqs.end()) >> (std::numeric_limits<std::uint64_t>::digits - SORT_KEY_SYMBOL_BIT_LENGTH) == 0) {
+        for (std::uint16_t i = 0; i < m; i++) {
+            a[i] = freqs[i] << SORT_KEY_SYMBOL_BIT_LENGTH | i;
+        }
 
-        std::pop_heap(h.begin(), h.end(), std::greater<>{});
-        auto b = h.back();
-        h.pop_back();
+        std::sort(a.begin(), a.end());
 
-        m--;
-        hr[a.second] = m;
-        hr[b.second] = m;
+        for (std::uint16_t i = 0; i < m; i++) {
+            order[i] = a[i] & SORT_KEY_SYMBOL_MASK;
+            a[i] >>= SORT_KEY_SYMBOL_BIT_LENGTH;
+        }
+    }
+    else {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](const std::uint16_t a, const std::uint16_t b) {
+            return freqs[a] < freqs[b] || (freqs[a] == freqs[b] && a < b);
+        });
 
-        h.push_back(std::make_pair(a.first + b.first, m));
-        std::push_heap(h.begin(), h.end(), std::greater<>{});
+        for (std::uint16_t i = 0; i < m; i++) {
+            a[i] = freqs[order[i]];
+        }
     }
 
-    std::vector<std::uint8_t> code_bitlens(freqs.size());
+    // Perform in-place Moffat-Katajainen algorithm, the first pass merges the nodes from left to right (the leaves and the internal nodes
+    // form two sorted queues, the leaves are preferred in ties, so the longest code is the shortest possible) storing the parents of the internal nodes
+    std::uint16_t root = 0;
+    std::uint16_t leaf = 2;
+    a[0] += a[1];
 
-    // Determine code bit lengths
-    for (std::uint16_t i = 0; i < freqs.size(); i++) {
-        std::uint16_t j = hr[freqs.size() + i];
-        std::uint8_t l = 1;
+    for (std::uint16_t next = 1; next < m - 1; next++) {
+        if (leaf >= m || a[root] < a[leaf]) {
+            a[next] = a[root];
+            a[root++] = next;
+        }
+        else {
+            a[next] = a[leaf++];
+        }
+
+        if (leaf >= m || (root < next && a[root] < a[leaf])) {
+            a[next] += a[root];
+            a[root++] = next;
+        }
+        else {
+            a[next] += a[leaf++];
+        }
+    }
 
-        while (j > 1) {
-            j = hr[j];
-            l++;
+    // The second pass from right to left converts the parents of the internal nodes to their depths
+    a[m - 2] = 0;
+
+    for (std::int32_t next = m - 3; next >= 0; next--) {
+        a[next] = a[a[next]] + 1;
+    }
+
+    // The third pass from right to left assigns the depths to the leaves by the numbers of the internal nodes at each depth
+    std::int32_t available = 1;
+    std::int32_t used = 0;
+    std::uint64_t depth = 0;
+    std::int32_t internal = m - 2;
+    std::int32_t next = m - 1;
+
+    while (available > 0) {
+        while (internal >= 0 && a[internal] == depth) {
+            used++;
+            internal--;
+        }
+
+        while (available > used) {
+            a[next--] = depth;
+            available--;
         }
 
-        code_bitlens[i] = l;
+        available = 2 * used;
+        depth++;
+        used = 0;
+    }
+
+    for (std::uint16_t i = 0; i < m; i++) {
+        code_bitlens[order[i]] = a[i];
     }
 
     return code_bitlens;
@@ -100,34 +462,117 @@ void HuffmanEncoder::compute_codes(const std::vector<std::uint64_t> &freqs) {
 
         const auto code_bitlens = compute_code_bitlens(used_symbol_freqs);
         std::vector<std::pair<uint8_t, uint16_t>> code_bitlens_and_used_symbols(code_bitlens.size());
+        std::vector<std::uint16_t> bitlen_offsets(*std::max_element(code_bitlens.begin(), code_bitlens.end()) + 2);
+
+        // The used symbols are ascending, so counting sort by the code bit lengths orders them by the code bit lengths and the symbols
+        for (const std::uint8_t code_bitlen: code_bitlens) {
+            bitlen_offsets[code_bitlen + 1]++;
+        }
+
+        std::partial_sum(bitlen_offsets.begin(), bitlen_offsets.end(), bitlen_offsets.begin());
 
         for (std::uint16_t i = 0; i < code_bitlens.size(); i++) {
-            code_bitlens_and_used_symbols[i] = std::make_pair(code_bitlens[i], used_symbols[i]);
+            code_bitlens_and_used_symbols[bitlen_offsets[code_bitlens[i]]++] = std::make_pair(code_bitlens[i], used_symbols[i]);
         }
 
-        std::sort(code_bitlens_and_used_symbols.begin(), code_bitlens_and_used_symbols.end());
+        assign_codes(code_bitlens_and_used_symbols);
+    }
+}
+
 
-        codes.resize(BYTE_VALUE_COUNT + 1);
-        codes[code_bitlens_and_used_symbols.front().second] = std::make_pair(code_bitlens_and_used_symbols.front().first, FIRST_CODE);
+void HuffmanEncoder::assign_codes(const std::vector<std::pair<uint8_t, uint16_t>> &code_bitlens_and_symbols) {
+    // The symbols without a code keep the zero code length
+    codes.assign(BYTE_VALUE_COUNT + 1, std::make_pair(0, 0));
+    codes[code_bitlens_and_symbols.front().second] = std::make_pair(code_bitlens_and_symbols.front().first, FIRST_CODE);
 
-        std::uint64_t prev_code = FIRST_CODE;
-        std::uint64_t prev_bitlen = code_bitlens_and_used_symbols.front().first;
+    std::uint64_t prev_code = FIRST_CODE;
+    std::uint64_t prev_bitlen = code_bitlens_and_symbols.front().first;
 
-        for (auto it = code_bitlens_and_used_symbols.begin() + 1, end = code_bitlens_and_used_symbols.end(); it != end; it++) {
-            std::uint64_t code = (prev_code + 1) << (it->first - prev_bitlen);
-            prev_code = code;
-            prev_bitlen = it->first;
-            codes[it->second] = std::make_pair(prev_bitlen, code);
+    for (auto it = code_bitlens_and_symbols.begin() + 1, end = code_bitlens_and_symbols.end(); it != end; it++) {
+        std::uint64_t code = (prev_code + 1) << (it->first - prev_bitlen);
+        prev_code = code;
+        prev_bitlen = it->first;
+        codes[it->second] = std::make_pair(prev_bitlen, code);
+    }
+
+    code_bitlen_to_symbols.clear();
+    code_bitlen_to_symbols.resize(code_bitlens_and_symbols.back().first);
+
+    // Collect symbols according to their lengths but exclude the special end-of-block symbol symbol if present
+    for (auto it = code_bitlens_and_symbols.begin(), end = is_added_end_of_block ? code_bitlens_and_symbols.end() - 1 : code_bitlens_and_symbols.end(); it != end; it++) {
+        code_bitlen_to_symbols[it->first - 1].push_back(it->second);
+    }
+}
+
+
+std::uint64_t HuffmanEncoder::get_listed_codebook_size() const {
+    // All 256 symbols with the code bit length equal to 8 bits are stored by 2 bytes
+    if (code_bitlen_to_symbols.size() == BYTE_BIT_LENGTH && code_bitlen_to_symbols[BYTE_BIT_LENGTH - 1].size() == BYTE_VALUE_COUNT) {
+        return 2;
+    }
+
+    std::uint64_t codebook_size = 1 + code_bitlen_to_symbols.size();
+
+    for (const auto &symbols: code_bitlen_to_symbols) {
+        codebook_size += symbols.size();
+    }
+
+    return codebook_size;
+}
+
+
+std::uint64_t HuffmanEncoder::get_compact_codebook_size() const {
+    if (code_bitlen_to_symbols.size() > MAX_COMPACT_CODE_BITLEN) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    std::uint64_t bit_count = COMPACT_CODEBOOK_SYMBOL_COUNT_BIT_LENGTH;
+    std::uint16_t next_position = 0;
+    std::uint8_t prev_code_bitlen = 0;
+
+    for (std::uint16_t position = 0; position < BYTE_VALUE_COUNT; position++) {
+        const std::uint8_t code_bitlen = codes[get_compact_codebook_symbol(position)].first;
+
+        if (code_bitlen > 0) {
+            bit_count += get_exp_golomb_bitlen(position - next_position) + get_exp_golomb_bitlen(get_zigzag_value(code_bitlen - prev_code_bitlen));
+            next_position = position + 1;
+            prev_code_bitlen = code_bitlen;
         }
+    }
+
+    return 1 + (bit_count + BYTE_BIT_LENGTH - 1) / BYTE_BIT_LENGTH;
+}
+
 
-        code_bitlen_to_symbols.clear();
-        code_bitlen_to_symbols.resize(code_bitlens_and_used_symbols.back().first);
+void HuffmanEncoder::store_compact_codebook(std::vector<std::uint8_t> &encoded_data) const {
+    std::uint16_t symbol_count = 0;
 
-        // Collect symbols according to their lengths but exclude the special end-of-block symbol symbol if present
-        for (auto it = code_bitlens_and_used_symbols.begin(), end = is_added_end_of_block ? code_bitlens_and_used_symbols.end() - 1 : code_bitlens_and_used_symbols.end(); it != end; it++) {
-            code_bitlen_to_symbols[it->first - 1].push_back(it->second);
+    for (const auto &symbols: code_bitlen_to_symbols) {
+        symbol_count += symbols.size();
+    }
+
+    encoded_data.push_back(COMPACT_CODEBOOK_FLAG | code_bitlen_to_symbols.size());
+    encoded_data.push_back(symbol_count - 1);
+
+    std::uint64_t bit_buffer = 0;
+    std::uint8_t bit_buffer_length = 0;
+    std::uint16_t next_position = 0;
+    std::uint8_t prev_code_bitlen = 0;
+
+    for (std::uint16_t position = 0; position < BYTE_VALUE_COUNT; position++) {
+        const std::uint8_t code_bitlen = codes[get_compact_codebook_symbol(position)].first;
+
+        if (code_bitlen > 0) {
+            append_exp_golomb(position - next_position, bit_buffer, bit_buffer_length, encoded_data);
+            append_exp_golomb(get_zigzag_value(code_bitlen - prev_code_bitlen), bit_buffer, bit_buffer_length, encoded_data);
+            next_position = position + 1;
+            prev_code_bitlen = code_bitlen;
         }
     }
+
+    if (bit_buffer_length > 0) {
+        encoded_data.push_back(bit_buffer << (BYTE_BIT_LENGTH - bit_buffer_length));
+    }
 }
 
 
@@ -137,11 +582,62 @@ void HuffmanEncoder::clear_buffer() {
 }
 
 
-void HuffmanEncoder::initialize_encoding(const std::vector<std::uint64_t> &freqs, std::vector<std::uint8_t> &encoded_data, bool add_end_of_block) {
+std::uint64_t HuffmanEncoder::get_encoded_size(const std::vector<std::uint64_t> &freqs, bool add_end_of_block) {
     is_added_end_of_block = add_end_of_block;
     compute_codes(freqs);
+    code_freqs = freqs;
+
+    const std::uint64_t table_size = std::min(get_listed_codebook_size(), get_compact_codebook_size());
+    std::uint64_t bit_count = is_added_end_of_block ? codes[END_OF_BLOCK].first : 0;
 
-    if (code_bitlen_to_symbols.size() != BYTE_BIT_LENGTH || code_bitlen_to_symbols[BYTE_BIT_LENGTH - 1].size() < BYTE_VALUE_COUNT) {
+    for (std::uint16_t i = 0; i < freqs.size(); i++) {
+        if (freqs[i] > 0) {
+            bit_count += freqs[i] * codes[i].first;
+        }
+    }
+
+    return table_size + (bit_count + BYTE_BIT_LENGTH - 1) / BYTE_BIT_LENGTH;
+}
+
+
+std::uint64_t HuffmanEncoder::get_reused_encoded_size(const std::vector<std::uint64_t> &freqs) const {
+    if (codes.empty() || (is_added_end_of_block && codes[END_OF_BLOCK].first == 0)) {
+        return 0;
+    }
+
+    std::uint64_t bit_count = is_added_end_of_block ? codes[END_OF_BLOCK].first : 0;
+
+    for (std::uint16_t i = 0; i < freqs.size(); i++) {
+        if (freqs[i] > 0) {
+            if (codes[i].first == 0) {
+                return 0;
+            }
+
+            bit_count += freqs[i] * codes[i].first;
+        }
+    }
+
+    return (bit_count + BYTE_BIT_LENGTH - 1) / BYTE_BIT_LENGTH;
+}
+
+
+void HuffmanEncoder::reuse_encoding() {
+    clear_buffer();
+}
+
+
+void HuffmanEncoder::initialize_encoding(const std::vector<std::uint64_t> &freqs, std::vector<std::uint8_t> &encoded_data, bool add_end_of_block) {
+    if (freqs != code_freqs || add_end_of_block != is_added_end_of_block) {
+        is_added_end_of_block = add_end_of_block;
+        compute_codes(freqs);
+    }
+
+    code_freqs.clear();
+
+    if (get_compact_codebook_size() < get_listed_codebook_size()) {
+        store_compact_codebook(encoded_data);
+    }
+    else if (code_bitlen_to_symbols.size() != BYTE_BIT_LENGTH || code_bitlen_to_symbols[BYTE_BIT_LENGTH - 1].size() < BYTE_VALUE_COUNT) {
         encoded_data.push_back(code_bitlen_to_symbols.size() - 1);
 
         for (const auto &symbols: code_bitlen_to_symbols) {
@@ -161,6 +657,87 @@ void HuffmanEncoder::initialize_encoding(const std::vector<std::uint64_t> &freqs
 }
 
 
+std::uint64_t HuffmanEncoder::load_codebook(std::span<const std::uint8_t> codebook) {
+    if (!codebook.empty() && codebook[0] & COMPACT_CODEBOOK_FLAG) {
+        return load_compact_codebook(codebook);
+    }
+
+    if (codebook.empty() || codebook[0] + 1 > MAX_LOADED_CODE_BITLEN || codebook.size() < 1 + codebook[0] + 1u) {
+        return 0;
+    }
+
+    const std::uint8_t code_bitlen_count = codebook[0] + 1;
+    std::vector<std::pair<uint8_t, uint16_t>> code_bitlens_and_symbols;
+    std::vector<bool> is_used_symbol(BYTE_VALUE_COUNT);
+    std::uint64_t symbol_offset = 1 + code_bitlen_count;
+    // The number of the unused codes of the longest bit length left by the codes of the symbols (according to Kraft's inequality)
+    std::uint64_t unused_code_count = static_cast<std::uint64_t>(1) << code_bitlen_count;
+
+    for (std::uint8_t i = 0; i < code_bitlen_count; i++) {
+        const std::uint8_t symbol_count = codebook[1 + i];
+
+        if (symbol_offset + symbol_count > codebook.size()) {
+            return 0;
+        }
+
+        for (std::uint16_t j = 0; j < symbol_count; j++) {
+            const std::uint8_t symbol = codebook[symbol_offset + j];
+            const std::uint64_t used_code_count = static_cast<std::uint64_t>(1) << (code_bitlen_count - i - 1);
+
+            if (is_used_symbol[symbol] || used_code_count > unused_code_count) {
+                return 0;
+            }
+
+            is_used_symbol[symbol] = true;
+            unused_code_count -= used_code_count;
+            code_bitlens_and_symbols.push_back(std::make_pair(i + 1, symbol));
+        }
+
+        symbol_offset += symbol_count;
+    }
+
+    // The end-of-block symbol takes the last code of the longest bit length, so the codebook is complete
+    if (unused_code_count != 1) {
+        return 0;
+    }
+
+    code_bitlens_and_symbols.push_back(std::make_pair(code_bitlen_count, END_OF_BLOCK));
+    is_added_end_of_block = true;
+    assign_codes(code_bitlens_and_symbols);
+    code_freqs.clear();
+    clear_buffer();
+    return symbol_offset;
+}
+
+
+std::uint64_t HuffmanEncoder::load_compact_codebook(std::span<const std::uint8_t> codebook) {
+    CompactCodebook compact_codebook;
+    const std::uint64_t codebook_size = read_compact_codebook(codebook, true, compact_codebook);
+
+    // The end-of-block symbol takes the last code of the longest bit length, so the codebook is complete
+    if (codebook_size == 0 || compact_codebook.unused_code_count != 0) {
+        return 0;
+    }
+
+    std::vector<std::pair<uint8_t, uint16_t>> code_bitlens_and_symbols;
+
+    for (std::uint16_t i = 0; i < compact_codebook.symbol_count; i++) {
+        code_bitlens_and_symbols.push_back(std::make_pair(compact_codebook.code_bitlens[i], compact_codebook.symbols[i]));
+    }
+
+    // The symbols are ascending, so the stable sort orders them by the code bit lengths and the symbols
+    std::stable_sort(code_bitlens_and_symbols.begin(), code_bitlens_and_symbols.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+    code_bitlens_and_symbols.push_back(std::make_pair(compact_codebook.max_code_bitlen, END_OF_BLOCK));
+    is_added_end_of_block = true;
+    assign_codes(code_bitlens_and_symbols);
+    code_freqs.clear();
+    clear_buffer();
+    return codebook_size;
+}
+
+
 void HuffmanEncoder::encode_symbol(const std::uint16_t symbol, std::vector<std::uint8_t> &encoded_data) {
     auto code = codes[symbol];
     auto remaining_code_bit_count = code.first;
@@ -186,9 +763,9 @@ void HuffmanEncoder::encode_symbol(const std::uint16_t symbol, std::vector<std::
 }
 
 
-void HuffmanEncoder::encode_data(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last, std::vector<std::uint8_t> &encoded_data) {
-    while (first < last) {
-        encode_symbol(*first++, encoded_data);
+void HuffmanEncoder::encode_data(std::span<const std::uint8_t> data, std::vector<std::uint8_t> &encoded_data) {
+    for (const auto &val: data) {
+        encode_symbol(val, encoded_data);
     }
 }
 
@@ -205,17 +782,42 @@ void HuffmanEncoder::finalize_encoding(std::vector<std::uint8_t> &encoded_data)
 }
 
 
-void HuffmanDecoder::set_source(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last) {
-    current_source_it = first;
-    source_end_it = last;
+void HuffmanDecoder::set_source(std::span<const std::uint8_t> source) {
+    current_source_it = source.data();
+    source_end_it = source.data() + source.size();
+    has_codebook = false;
+}
+
+
+bool HuffmanDecoder::set_source_keeping_codebook(std::span<const std::uint8_t> source) {
+    if (!has_codebook) {
+        report_error("Missing codebook to be kept");
+        return false;
+    }
+
+    current_source_it = source.data();
+    source_end_it = source.data() + source.size();
+    remaining_buffer_bit_count = 0;
+    return true;
 }
 
 
 bool HuffmanDecoder::initialize_decoding(bool add_end_of_block) {
+    has_codebook = false;
+
+    if (current_source_it == source_end_it) {
+        report_error("Missing number of symbol counts");
+        return false;
+    }
+
+    if (*current_source_it & COMPACT_CODEBOOK_FLAG) {
+        return initialize_compact_decoding(add_end_of_block);
+    }
+
     std::uint16_t code_count_number = *current_source_it++ + 1;
 
-    if (current_source_it + code_count_number > source_end_it) {
-        std::cerr << "Invalid number of symbol counts" << std::endl;
+    if (code_count_number > source_end_it - current_source_it) {
+        report_error("Invalid number of symbol counts");
         return false;
     }
 
@@ -229,6 +831,7 @@ bool HuffmanDecoder::initialize_decoding(bool add_end_of_block) {
         alphabet.resize(BYTE_VALUE_COUNT);
         std::iota(alphabet.begin(), alphabet.end(), 0);
         current_source_it++;
+        has_codebook = true;
         // No need to handle end-of-block symbol as this case cannot happen when end-of-block symbol is added 
         return true;
     }
@@ -246,8 +849,8 @@ bool HuffmanDecoder::initialize_decoding(bool add_end_of_block) {
         symbol += *current_source_it++;
     }
 
-    if (current_source_it + symbol > source_end_it) {
-        std::cerr << "Invalid symbol alphabet" << std::endl;
+    if (symbol > source_end_it - current_source_it) {
+        report_error("Invalid symbol alphabet");
         return false;
     }
 
@@ -263,6 +866,68 @@ bool HuffmanDecoder::initialize_decoding(bool add_end_of_block) {
         first_code[code_count_number] += 2;
     }
 
+    remaining_buffer_bit_count = 0;
+    has_codebook = true;
+    return true;
+}
+
+
+bool HuffmanDecoder::initialize_compact_decoding(bool add_end_of_block) {
+    CompactCodebook compact_codebook;
+    const std::uint64_t codebook_size = read_compact_codebook(get_remaining_source(), add_end_of_block, compact_codebook);
+
+    if (codebook_size == 0) {
+        report_error("Invalid compact codebook");
+        return false;
+    }
+
+    current_source_it += codebook_size;
+
+    const std::uint8_t max_code_bitlen = compact_codebook.max_code_bitlen;
+    // The offsets of the symbols of the individual code bit lengths in the alphabet
+    std::array<std::uint16_t, MAX_COMPACT_CODE_BITLEN + 1> symbol_offsets;
+    std::uint64_t code_value = 0;
+    std::uint16_t symbol = 0;
+
+    first_code.resize(max_code_bitlen + 1);
+    first_symbol.resize(max_code_bitlen);
+
+    for (std::uint8_t i = 0; i < max_code_bitlen; i++) {
+        first_code[i] = code_value;
+        first_symbol[i] = symbol;
+        symbol_offsets[i + 1] = symbol;
+        code_value = (code_value + compact_codebook.symbol_counts[i + 1]) << 1;
+        symbol += compact_codebook.symbol_counts[i + 1];
+    }
+
+    // The ascending symbols are distributed to their code bit lengths, so they are ordered by the code bit lengths and the symbols like by the encoder
+    alphabet.resize(symbol);
+
+    for (std::uint16_t i = 0; i < compact_codebook.symbol_count; i++) {
+        alphabet[symbol_offsets[compact_codebook.code_bitlens[i]]++] = compact_codebook.symbols[i];
+    }
+
+    first_code[max_code_bitlen] = code_value;
+
+    if (add_end_of_block) {
+        // Add the special end-of-block symbol to alphabet
+        alphabet.push_back(END_OF_BLOCK);
+        // Adapt the anchor code to the special end-of-block symbol
+        first_code[max_code_bitlen] += 2;
+    }
+
+    remaining_buffer_bit_count = 0;
+    has_codebook = true;
+    return true;
+}
+
+
+bool HuffmanDecoder::reuse_decoding() {
+    if (!has_codebook) {
+        report_error("Missing codebook to be reused");
+        return false;
+    }
+
     remaining_buffer_bit_count = 0;
     return true;
 }
@@ -275,7 +940,7 @@ bool HuffmanDecoder::decode_symbol(std::uint16_t &symbol) {
     do {
         if (remaining_buffer_bit_count == 0) {
             if (current_source_it == source_end_it) {
-                std::cerr << "Cannot decode symbol" << std::endl;
+                report_error("Cannot decode symbol");
                 return false;
             }
 
@@ -283,7 +948,12 @@ bool HuffmanDecoder::decode_symbol(std::uint16_t &symbol) {
             remaining_buffer_bit_count = BYTE_BIT_LENGTH;
         }
 
-        code_len++;
+        // The codes of a corrupted (incomplete) codebook can be longer than its longest code
+        if (++code_len >= first_code.size()) {
+            report_error("Invalid code of symbol");
+            return false;
+        }
+
         code_value = (code_value << 1) + (encoded_buffer >> --remaining_buffer_bit_count & 1);
     } while (code_value << 1 >= first_code[code_len]);
 
@@ -333,7 +1003,7 @@ bool HuffmanDecoder::is_source_proccessed() {
 
 
 void HuffmanDecoder::advance_source(std::uint64_t num) {
-    if (current_source_it + num < source_end_it) {
+    if (num < static_cast<std::uint64_t>(source_end_it - current_source_it)) {
         current_source_it += num;
     }
     else {
@@ -342,10 +1012,6 @@ void HuffmanDecoder::advance_source(std::uint64_t num) {
 }
 
 
-std::vector<std::uint8_t>::const_iterator HuffmanDecoder::get_current_source_it() {
-    return current_source_it;
-}
-
-std::vector<std::uint8_t>::const_iterator HuffmanDecoder::get_source_end_it() {
-    return source_end_it;
+std::span<const std::uint8_t> HuffmanDecoder::get_remaining_source() {
+    return std::span<const std::uint8_t>(current_source_it, source_end_it);
 }
@@ -13,6 +13,7 @@
 
 
 #include <vector>
+#include <span>
 #include <cstdint>
 
 
@@ -22,15 +23,17 @@
 /**
  * @brief Get the frequency of occurrences of each symbol in the data specified by parameters.
  * 
- * @param first Iterator pointing to the first element of the given data
- * @param last Iterator pointing to the end of the range (one past the last element of the given data)
+ * @param data The given data
  *  
  * @return Frequencies of occurrences of all symbols.
  */
-std::vector<std::uint64_t> get_freqs(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last);
+std::vector<std::uint64_t> get_freqs(std::span<const std::uint8_t> data);
 
 /**
  * @class Canonical Huffman code encoder
+ * 
+ * @note The encoder keeps the state of the current encoding, so one instance must not be used by more threads at the same time.
+ * Different instances share no state and can be used concurrently. An instance can be reused for any number of subsequent encodings.
  */
 class HuffmanEncoder {
     private:
@@ -39,38 +42,123 @@ class HuffmanEncoder {
         std::uint8_t remaining_buffer_bit_count;                    // The number of remaining available bits in encoded buffer
         std::vector<std::vector<uint8_t>> code_bitlen_to_symbols;   // Symbols sorted by the lengths of their markers
         bool is_added_end_of_block;                                 // Indicates whether a code for the special end-of-block symbol is added
+        std::vector<std::uint64_t> code_freqs;                      // Frequencies of occurences of symbols the current codes are computed for
+
+        /**
+         * @brief Compute the canonical Huffman codes of individual symbols.
+         * 
+         * @param freqs Frequencies of occurences of symbols
+         */
+        void compute_codes(const std::vector<std::uint64_t> &freqs);
+
+        /**
+         * @brief Assign the canonical Huffman codes to the symbols in the order of the codebook.
+         * 
+         * @param code_bitlens_and_symbols Code bit lengths and symbols ordered by the code bit lengths (the end-of-block symbol, if added, is the last one)
+         */
+        void assign_codes(const std::vector<std::pair<uint8_t, uint16_t>> &code_bitlens_and_symbols);
+
+        /**
+         * @brief Get the size of the current codebook stored as the list of the symbols ordered by the code bit lengths.
+         * 
+         * @return The size of the listed codebook (in bytes).
+         */
+        std::uint64_t get_listed_codebook_size() const;
+
+        /**
+         * @brief Get the size of the current codebook stored as the Exp-Golomb coded code bit lengths of the used symbols.
+         * 
+         * @return The size of the compact codebook (in bytes), the maximum value if its code bit lengths are too long for it.
+         */
+        std::uint64_t get_compact_codebook_size() const;
 
+        /**
+         * @brief Store the current codebook in the compact format.
+         * 
+         * @param encoded_data Buffer for storing encoded data
+         */
+        void store_compact_codebook(std::vector<std::uint8_t> &encoded_data) const;
+
+        /**
+         * @brief Load the compact canonical Huffman codebook (with the end-of-block symbol) to encode the data by it without storing it.
+         * 
+         * @param codebook The stored codebook
+         * 
+         * @return The size of the codebook (in bytes) if it is valid and complete, 0 otherwise.
+         */
+        std::uint64_t load_compact_codebook(std::span<const std::uint8_t> codebook);
+
+        /**
+         * @brief Clear the buffer storing the last 8 encoded bits data and reset its number of remaining available bits.
+         */
+        void clear_buffer();
+
+    public:
         /**
          * @brief Compute the bit lengths of the canonical Huffman codes according to frequencies of occurences of symbols.
          * 
+         * @note The symbols are sorted by their frequencies and merged in place by the two-queue (Moffat-Katajainen) algorithm without any heap.
+         * The ties prefer the leaves, so the longest code is as short as possible among the codes of the minimal size.
+         * 
          * @param freqs Frequencies of occurences of symbols
          *  
          * @return Bit lengths of Huffman codes for individual symbols.
          */
-        std::vector<std::uint8_t> compute_code_bitlens(const std::vector<std::uint64_t> &freqs);
+        static std::vector<std::uint8_t> compute_code_bitlens(const std::vector<std::uint64_t> &freqs);
 
         /**
-         * @brief Compute the canonical Huffman codes of individual symbols.
+         * @brief Compute the canonical Huffman codes according to frequencies of occurences of symbols and get the exact size of the encoded data.
+         * 
+         * @note The codes are kept, so that the subsequent initialize_encoding with the same frequencies does not compute them again.
          * 
          * @param freqs Frequencies of occurences of symbols
+         * @param add_end_of_block Indicates whether a code for the special end-of-block symbol should be added (true by default)
+         * 
+         * @return The size of the codebook and the encoded symbols (in bytes).
          */
-        void compute_codes(const std::vector<std::uint64_t> &freqs);
+        std::uint64_t get_encoded_size(const std::vector<std::uint64_t> &freqs, bool add_end_of_block = true);
 
         /**
-         * @brief Clear the buffer storing the last 8 encoded bits data and reset its number of remaining available bits.
+         * @brief Get the size of the data encoded by the current codebook (without storing the codebook again).
+         * 
+         * @param freqs Frequencies of occurences of symbols
+         * 
+         * @return The size of the encoded symbols (in bytes), 0 if some of the symbols (or the end-of-block symbol) has no code in the current codebook.
          */
-        void clear_buffer();
+        std::uint64_t get_reused_encoded_size(const std::vector<std::uint64_t> &freqs) const;
+
+        /**
+         * @brief Prepare the encoding of the next data by the current codebook without storing it again.
+         */
+        void reuse_encoding();
 
-    public:
         /**
          * @brief Compute the canonical Huffman codebook according to frequencies of occurences of individual symbols and store it to the encoded data.
          * 
+         * @note The codes are not computed again if they have been computed for the same frequencies by the preceding get_encoded_size.
+         * The codebook is stored in the smaller of two formats distinguished by its first byte. The listed codebook consists of the number of the code bit lengths
+         * decremented by one (below 128), the number of the symbols of each code bit length and the symbols ordered by the code bit lengths.
+         * The compact codebook consists of the longest code bit length with the highest bit set and the bit stream of the number of the used symbols
+         * decremented by one (8 bits) followed by the Exp-Golomb coded gap to each used symbol and the zigzag difference of its code bit length from the previous one.
+         * The symbols are visited in the order 0, 255, 1, 254, ..., so the few small residuals of the model take the first positions.
+         * 
          * @param freqs Frequencies of occurences of symbols
          * @param encoded_data Buffer for storing encoded data
          * @param add_end_of_block Indicates whether a code for the special end-of-block symbol should be added (true by default)
          */
         void initialize_encoding(const std::vector<std::uint64_t> &freqs, std::vector<std::uint8_t> &encoded_data, bool add_end_of_block = true);
 
+        /**
+         * @brief Load the canonical Huffman codebook (with the end-of-block symbol) stored by initialize_encoding to encode the data by it without storing it.
+         * 
+         * @note The codebook is used by reuse_encoding and get_reused_encoded_size, e.g. for the code tables of a dictionary.
+         * 
+         * @param codebook The stored codebook
+         * 
+         * @return The size of the codebook (in bytes) if it is valid and complete, 0 otherwise.
+         */
+        std::uint64_t load_codebook(std::span<const std::uint8_t> codebook);
+
         /**
          * @brief Encode the symbol using canonical Huffman encoding.
          * 
@@ -82,11 +170,10 @@ class HuffmanEncoder {
         /**
          * @brief Encode data using canonical Huffman encoding.
          * 
-         * @param first Iterator pointing to the first element to be encoded
-         * @param last Iterator pointing to the end of the range (one past the last element to be encoded)
+         * @param data The data to be encoded
          * @param encoded_data Buffer for storing encoded data
          */
-        void encode_data(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last, std::vector<std::uint8_t> &encoded_data);
+        void encode_data(std::span<const std::uint8_t> data, std::vector<std::uint8_t> &encoded_data);
 
         /**
          * @brief Encode the end-of-block symbol if is added and add the buffer storing the last 8 encoded bits to the end of the encoded data if the buffer is not empty.
@@ -98,25 +185,48 @@ class HuffmanEncoder {
 
 /**
  * @class Canonical Huffman code decoder
+ * 
+ * @note The decoder keeps the state of the current decoding, so one instance must not be used by more threads at the same time.
+ * Different instances share no state and can be used concurrently. An instance can be reused for any number of subsequent decodings.
  */
 class HuffmanDecoder {
     private:
-        std::vector<std::uint8_t>::const_iterator current_source_it;    // Iterator pointing to the current symbol to be decoded
-        std::vector<std::uint8_t>::const_iterator source_end_it;        // Iterator one past the last element to be decoded
+        const std::uint8_t *current_source_it;                          // Pointer to the current symbol to be decoded
+        const std::uint8_t *source_end_it;                              // Pointer one past the last element to be decoded
         std::vector<std::uint64_t> first_code;                          // Values of the first codes of individual bit lengths specified by first_code_index + 1
         std::vector<std::uint8_t> first_symbol;                         // Indexes of the first symbols in symbol alphabet with code bit lengths first_symbol_index + 1
         std::vector<std::uint16_t> alphabet;                            // Symbol alphabet
         std::uint8_t encoded_buffer;                                    // The buffer storing current 8 bits for decoding
         std::uint8_t remaining_buffer_bit_count;                        // The number of remaining bits for decoding in encoded buffer
+        bool has_codebook = false;                                      // Indicates whether a codebook of the current source is loaded
+
+        /**
+         * @brief Prepare the first codes and the first symbols according to the compact codebook in encoded data.
+         * 
+         * @param add_end_of_block Indicates whether a code for the special end-of-block symbol should be added
+         * 
+         * @return True in case of successful initialization, false otherwise.
+         */
+        bool initialize_compact_decoding(bool add_end_of_block);
 
     public:
         /**
          * @brief Set the source encoded data to decode.
          * 
-         * @param first Iterator pointing to the first element to be decoded
-         * @param last Iterator pointing to the end of the range (one past the last element to be decoded)
+         * @note The loaded codebook is discarded, the codebooks can be reused only within one source.
+         * 
+         * @param source The encoded data to be decoded
          */
-        void set_source(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last);
+        void set_source(std::span<const std::uint8_t> source);
+
+        /**
+         * @brief Set the source encoded data to decode by the codebook loaded before from another source (e.g. from a dictionary).
+         * 
+         * @param source The encoded data (without their codebook) to be decoded
+         * 
+         * @return True if a codebook is loaded, false otherwise.
+         */
+        bool set_source_keeping_codebook(std::span<const std::uint8_t> source);
 
         /**
          * @brief Prepare the first codes and the first symbols  according to codebook in encoded data.
@@ -127,6 +237,13 @@ class HuffmanDecoder {
          */
         bool initialize_decoding(bool add_end_of_block = true);
 
+        /**
+         * @brief Prepare the decoding of the next data by the codebook loaded from the current source before.
+         * 
+         * @return True if a codebook of the current source is loaded, false otherwise.
+         */
+        bool reuse_decoding();
+
         /**
          * @brief Decode the current source encoded symbol using canonical Huffman encoding.
          * 
@@ -177,18 +294,11 @@ class HuffmanDecoder {
         void advance_source(std::uint64_t num = 1);
 
         /**
-         * @brief Get the current source iterator.
-         * 
-         * @return The current source iterator.
-         */
-        std::vector<std::uint8_t>::const_iterator get_current_source_it();
-
-        /**
-         * @brief Get the source end iterator.
+         * @brief Get the part of the source that has not been processed yet.
          * 
-         * @return The source end iterator.
+         * @return The remaining source encoded data.
          */
-        std::vector<std::uint8_t>::const_iterator get_source_end_it();
+        std::span<const std::uint8_t> get_remaining_source();
 };
 
 
@@ -11,6 +11,9 @@
 #include <iostream>
 #include <cstdio>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "io.h"
 
@@ -44,7 +47,7 @@ bool read_bin_file(const std::string &filename, std::vector<std::uint8_t> &buffe
 }
 
 
-bool write_bin_file(const std::string &filename, std::vector<std::uint8_t> &buffer) {
+bool write_bin_file(const std::string &filename, std::span<const std::uint8_t> buffer) {
     std::FILE *fd = std::fopen(filename.c_str(), "wb");
 
     if (fd == NULL) {
@@ -61,3 +64,85 @@ bool write_bin_file(const std::string &filename, std::vector<std::uint8_t> &buff
     std::fclose(fd);
     return true;
 }
+
+
+MappedFile::~MappedFile() {
+    if (mapped_data != nullptr) {
+        munmap(mapped_data, mapped_size);
+    }
+}
+
+
+bool MappedFile::map_for_reading(const std::string &filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+
+    if (fd == -1) {
+        std::cerr << "Cannot open the input file '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    struct stat stats;
+
+    // Use the file statistics to get its size
+    if (fstat(fd, &stats) == -1) {
+        std::cerr << "Cannot obtain the size of the input file '" << filename << "' (using stats)" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    // Empty files cannot be mapped, they are represented by empty contents
+    if (stats.st_size > 0) {
+        void *data = mmap(nullptr, stats.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED) {
+            std::cerr << "Cannot map the input file '" << filename << "' to the memory" << std::endl;
+            close(fd);
+            return false;
+        }
+
+        // The file is processed from its beginning to its end, so aggressive read-ahead pays off
+        madvise(data, stats.st_size, MADV_SEQUENTIAL);
+        mapped_data = static_cast<std::uint8_t *>(data);
+        mapped_size = stats.st_size;
+    }
+
+    close(fd);
+    return true;
+}
+
+
+bool MappedFile::map_for_writing(const std::string &filename, std::uint64_t size) {
+    int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+
+    if (fd == -1) {
+        std::cerr << "Cannot open the output file '" << filename << "'" << std::endl;
+        return false;
+    }
+
+    if (ftruncate(fd, size) == -1) {
+        std::cerr << "Cannot resize the output file '" << filename << "'" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    if (size > 0) {
+        void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (data == MAP_FAILED) {
+            std::cerr << "Cannot map the output file '" << filename << "' to the memory" << std::endl;
+            close(fd);
+            return false;
+        }
+
+        mapped_data = static_cast<std::uint8_t *>(data);
+        mapped_size = size;
+    }
+
+    close(fd);
+    return true;
+}
+
+
+std::span<std::uint8_t> MappedFile::get_data() {
+    return std::span<std::uint8_t>(mapped_data, mapped_size);
+}
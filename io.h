@@ -13,6 +13,7 @@
 
 
 #include <vector>
+#include <span>
 #include <string>
 #include <cstdint>
 
@@ -35,7 +36,52 @@ bool read_bin_file(const std::string &filename, std::vector<std::uint8_t> &buffe
  * 
  * @return True in case of successful writing of data to the file, false otherwise.
  */
-bool write_bin_file(const std::string &filename, std::vector<std::uint8_t> &buffer);
+bool write_bin_file(const std::string &filename, std::span<const std::uint8_t> buffer);
+
+/**
+ * @class Memory mapping of the whole file contents
+ */
+class MappedFile {
+    private:
+        std::uint8_t *mapped_data = nullptr;    // The beginning of the mapped file contents
+        std::uint64_t mapped_size = 0;          // The size of the mapped file contents
+
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /**
+         * @brief Unmap the file contents (if mapped).
+         */
+        ~MappedFile();
+
+        /**
+         * @brief Map the contents of the file for sequential reading.
+         * 
+         * @param filename The name of the file to be mapped
+         * 
+         * @return True if the file is successfully mapped, false otherwise.
+         */
+        bool map_for_reading(const std::string &filename);
+
+        /**
+         * @brief Create (or truncate) the file, resize it to the specified size and map its contents for writing.
+         * 
+         * @param filename The name of the file to be mapped
+         * @param size The resulting size of the file
+         * 
+         * @return True if the file is successfully created and mapped, false otherwise.
+         */
+        bool map_for_writing(const std::string &filename, std::uint64_t size);
+
+        /**
+         * @brief Get the mapped file contents.
+         * 
+         * @return The mapped file contents (empty if the file is empty or not mapped).
+         */
+        std::span<std::uint8_t> get_data();
+};
 
 
 #endif
@@ -9,17 +9,142 @@
 
 
 #include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <vector>
 
 #include "args.h"
 #include "io.h"
-#include "compress.h"
-
-#ifdef STATS
-#include <chrono>
+#include "huffcodec.h"
 #include "huffman.h"
-#include <cmath>
-#include <iostream>
-#endif
+#include "dictionary.h"
+#include "error.h"
+#include "pipeline.h"
+#include "batch.h"
+#include "stats.h"
+
+
+/**
+ * @brief Compute the entropy of the data.
+ * 
+ * @param data The data
+ * 
+ * @return The entropy of the data (in bits per symbol).
+ */
+double compute_entropy(std::span<const std::uint8_t> data) {
+    double entropy = 0;
+
+    for (const auto &val: get_freqs(data)) {
+        if (val != 0) {
+            entropy += (static_cast<double>(val) / data.size()) * std::log2(static_cast<double>(data.size()) / val);
+        }
+    }
+
+    return entropy;
+}
+
+
+/**
+ * @brief Add the sizes of the data, the compression ratio and the total time to the statistics.
+ * 
+ * @param stats The statistics
+ * @param compress Indicates whether the data have been compressed or decompressed
+ * @param input_size The size of the input data
+ * @param output_size The size of the output data
+ * @param total_time The total time of the compression or decompression (in seconds)
+ */
+void add_size_stats(CodecStats &stats, const bool compress, const std::uint64_t input_size, const std::uint64_t output_size, const double total_time) {
+    const std::uint64_t original_size = compress ? input_size : output_size;
+    const std::uint64_t compressed_size = compress ? output_size : input_size;
+
+    stats.values.emplace_back("input_size", input_size);
+    stats.values.emplace_back("output_size", output_size);
+    stats.values.emplace_back("bits_per_symbol", original_size > 0 ? compressed_size * 8.0 / original_size : 0);
+    stats.values.emplace_back("total_time", total_time);
+}
+
+
+/**
+ * @brief Train the dictionary of the code tables on the training files and write it to the output file.
+ * 
+ * @param arg_parser The parsed command line arguments
+ * @param mode The mode flags of the compression the dictionary is trained for
+ * 
+ * @return True in case of successful training, false otherwise.
+ */
+bool train_dictionary(const ArgParser &arg_parser, const unsigned mode) {
+    std::vector<std::vector<std::uint8_t>> training_data(arg_parser.training_files.size());
+    std::vector<const std::uint8_t *> srcs;
+    std::vector<std::size_t> src_sizes;
+
+    for (std::uint64_t i = 0; i < training_data.size(); i++) {
+        if (!read_bin_file(arg_parser.training_files[i], training_data[i])) {
+            return false;
+        }
+
+        srcs.push_back(training_data[i].data());
+        src_sizes.push_back(training_data[i].size());
+    }
+
+    std::unique_ptr<hc_context, decltype(&hc_context_destroy)> context(hc_context_create(), hc_context_destroy);
+    std::size_t dictionary_size;
+
+    if (!context) {
+        std::cerr << "Cannot create the compression context" << std::endl;
+        return false;
+    }
+
+    if (hc_train_dictionary(
+        context.get(), srcs.data(), src_sizes.data(), srcs.size(), NULL, 0, &dictionary_size, mode, arg_parser.width_value, arg_parser.table_count
+    ) != HC_OK) {
+        std::cerr << hc_context_error(context.get()) << std::endl;
+        return false;
+    }
+
+    return write_bin_file(arg_parser.output_file, std::span<const std::uint8_t>(hc_context_output(context.get(), NULL), dictionary_size));
+}
+
+
+/**
+ * @brief Update the region of the compressed input file by the region file and write the result to the output file.
+ * 
+ * @param arg_parser The parsed command line arguments
+ * @param mode The mode flags of the update (the effort level)
+ * @param dictionary_data The content of the dictionary file (empty if there is none)
+ * 
+ * @return True in case of successful update, false otherwise.
+ */
+bool update_file(const ArgParser &arg_parser, const unsigned mode, std::span<const std::uint8_t> dictionary_data) {
+    std::vector<std::uint8_t> compressed_data;
+    std::vector<std::uint8_t> region;
+
+    // The input file is read to the memory, so that it can be overwritten by the result
+    if (!read_bin_file(arg_parser.input_file, compressed_data) || !read_bin_file(arg_parser.region_file, region)) {
+        return false;
+    }
+
+    std::unique_ptr<hc_context, decltype(&hc_context_destroy)> context(hc_context_create(), hc_context_destroy);
+    std::size_t updated_data_size;
+
+    if (!context) {
+        std::cerr << "Cannot create the compression context" << std::endl;
+        return false;
+    }
+
+    if ((!dictionary_data.empty() && hc_context_load_dictionary(context.get(), dictionary_data.data(), dictionary_data.size()) != HC_OK) 
+        || hc_update(
+            context.get(), compressed_data.data(), compressed_data.size(), region.data(), region.size(), arg_parser.region_x, arg_parser.region_y, 
+            arg_parser.region_width, arg_parser.region_height, NULL, 0, &updated_data_size, mode
+        ) != HC_OK) {
+        std::cerr << hc_context_error(context.get()) << std::endl;
+        return false;
+    }
+
+    return write_bin_file(arg_parser.output_file, std::span<const std::uint8_t>(hc_context_output(context.get(), NULL), updated_data_size));
+}
 
 
 /**
@@ -42,84 +167,208 @@ int main(int argc, char *argv[]) {
         return EXIT_SUCCESS;
     }
 
-    std::vector<std::uint8_t> input_data;
+    const unsigned mode = (arg_parser.use_model ? HC_MODE_MODEL | HC_MODE_RLE : 0) | (arg_parser.adapt_scan ? HC_MODE_ADAPTIVE : 0)
+        | (arg_parser.use_checksum ? HC_MODE_CHECKSUM : 0) | (arg_parser.sample_bits > MAX_BYTE_SAMPLE_BITS ? HC_MODE_SAMPLES_16 : 0)
+        | HC_MODE_LEVEL(arg_parser.effort_level) | HC_MODE_CHANNELS(arg_parser.channel_count) | (arg_parser.is_planar ? HC_MODE_PLANAR : 0)
+        | (arg_parser.color_transform == COLOR_TRANSFORM_SUBTRACT_GREEN ? HC_MODE_SUBTRACT_GREEN : 0) 
+        | (arg_parser.color_transform == COLOR_TRANSFORM_YCOCG_R ? HC_MODE_YCOCG_R : 0) 
+        | (arg_parser.thumbnail_cell_side == THUMBNAIL_BLOCK_CELL_SIDE ? HC_MODE_THUMBNAIL : 0) 
+        | (arg_parser.thumbnail_cell_side == THUMBNAIL_MOSAIC_CELL_SIDE ? HC_MODE_MOSAIC : 0) 
+        | (arg_parser.use_static_chunks ? HC_MODE_STATIC_CHUNKS : 0) | HC_MODE_MAX_ERROR(arg_parser.max_error);
 
-    if (!read_bin_file(arg_parser.input_file, input_data)) {
-        return EXIT_FAILURE;
+    if (arg_parser.train) {
+        return train_dictionary(arg_parser, mode) ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-    std::vector<std::uint8_t> output_data;
+    // The dictionary is checked once here, all the modes then use valid dictionary data
+    std::vector<std::uint8_t> dictionary_data;
+    HuffmanDictionary dictionary;
+
+    if (arg_parser.dictionary_file != NULL) {
+        if (!read_bin_file(arg_parser.dictionary_file, dictionary_data)) {
+            return EXIT_FAILURE;
+        }
+
+        if (!dictionary.load(dictionary_data)) {
+            std::cerr << get_last_error() << " ('" << arg_parser.dictionary_file << "')" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (arg_parser.update) {
+        return update_file(arg_parser, mode, dictionary_data) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (arg_parser.batch_file != NULL) {
+        BatchStats batch_stats;
+        const bool is_successful = process_batch(
+            arg_parser.batch_file, arg_parser.thread_count, arg_parser.compress, arg_parser.verify, mode, arg_parser.width_value, 
+            arg_parser.frame_height, dictionary_data, batch_stats
+        );
+
+        if (batch_stats.file_count > 0) {
+            std::cout << "Processed files: " << batch_stats.file_count - batch_stats.failed_file_count << " of " << batch_stats.file_count 
+                << " (" << arg_parser.thread_count << " threads)" << std::endl;
+            std::cout << "Input size (B): " << batch_stats.input_size << std::endl;
+            std::cout << "Output size (B): " << batch_stats.output_size << std::endl;
+            std::cout << "Time (s): " << batch_stats.time << std::endl;
+            std::cout << "Throughput (files/s): " << batch_stats.file_count / batch_stats.time << std::endl;
+            std::cout << "Throughput (MB/s): " << batch_stats.input_size / batch_stats.time / 1e6 << std::endl;
+        }
+
+        return is_successful ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
-#ifdef STATS
-    const auto start = std::chrono::high_resolution_clock::now();
+    CodecStats stats;
+
+    if (arg_parser.print_stats) {
+#ifndef DISABLE_STATS
+        active_stats = &stats;
+#else
+        std::cerr << "Warning: the statistics are disabled at compile time (DISABLE_STATS), only the sizes and the total time are printed" << std::endl;
 #endif
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (arg_parser.pipelined && !arg_parser.verify && !arg_parser.preview) {
+        PipelineStats pipeline_stats;
+        bool is_successful;
 
-    if (!input_data.empty()) {
-        bool use_rle = arg_parser.use_model;
-        
         if (arg_parser.compress) {
-            if (arg_parser.adapt_scan) {
-                compress_adaptively(input_data, output_data, arg_parser.width_value, arg_parser.use_model, use_rle);
-            }
-            else {
-                compress_statically(input_data, output_data, arg_parser.use_model, use_rle);
-            }
+            CompressOptions options;
+            options.width_value = arg_parser.width_value;
+            options.sample_bits = arg_parser.sample_bits;
+            options.channel_count = arg_parser.channel_count;
+            options.color_transform = arg_parser.color_transform;
+            options.adapt_scan = arg_parser.adapt_scan;
+            // The model is always used together with the RLE (as by the mode flags)
+            options.use_model = arg_parser.use_model;
+            options.use_rle = arg_parser.use_model;
+            options.use_checksum = arg_parser.use_checksum;
+            options.effort_level = arg_parser.effort_level;
+            options.thumbnail_cell_side = arg_parser.thumbnail_cell_side;
+            options.max_error = arg_parser.max_error;
+            is_successful = compress_pipelined(
+                arg_parser.input_file, arg_parser.output_file, options, arg_parser.dictionary_file != NULL ? &dictionary : NULL, pipeline_stats
+            );
         }
         else {
-            if (arg_parser.adapt_scan) {
-                if (!decompress_adaptively(input_data.begin(), input_data.end(), output_data, arg_parser.use_model, use_rle)) {
-                    return EXIT_FAILURE;
-                }
-            }
-            else {
-                if (!decompress_statically(input_data.begin(), input_data.end(), output_data, arg_parser.use_model, use_rle)) {
-                    return EXIT_FAILURE;
-                }
-            }
+            is_successful = decompress_pipelined(
+                arg_parser.input_file, arg_parser.output_file, arg_parser.thread_count, arg_parser.dictionary_file != NULL ? &dictionary : NULL, 
+                pipeline_stats
+            );
+        }
+
+        if (is_successful && arg_parser.print_stats) {
+            std::error_code error_code;
+            const std::uint64_t input_size = std::filesystem::file_size(arg_parser.input_file, error_code);
+            const std::uint64_t output_size = std::filesystem::file_size(arg_parser.output_file, error_code);
+            add_size_stats(stats, arg_parser.compress, input_size, output_size, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            stats.values.emplace_back("chunk_count", pipeline_stats.chunk_count);
+            stats.values.emplace_back("read_queue_max_depth", pipeline_stats.read_queue.max_depth);
+            stats.values.emplace_back("read_queue_reader_stall_time", pipeline_stats.read_queue.push_stall_time);
+            stats.values.emplace_back("read_queue_codec_stall_time", pipeline_stats.read_queue.pop_stall_time);
+            stats.values.emplace_back("write_queue_max_depth", pipeline_stats.write_queue.max_depth);
+            stats.values.emplace_back("write_queue_codec_stall_time", pipeline_stats.write_queue.push_stall_time);
+            stats.values.emplace_back("write_queue_writer_stall_time", pipeline_stats.write_queue.pop_stall_time);
+            write_stats_json(std::cout, stats);
         }
+
+        return is_successful ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-#ifdef STATS
-    const auto end = std::chrono::high_resolution_clock::now();
-#endif
+    MappedFile input_file;
 
-    if (!write_bin_file(arg_parser.output_file, output_data)) {
+    if (!STATS_MEASURE(STAGE_IO, input_file.map_for_reading(arg_parser.input_file))) {
         return EXIT_FAILURE;
     }
 
-#ifdef STATS
-    const std::chrono::duration<double> diff{end - start};
-    std::vector<std::uint64_t> freqs;
-    std::uint64_t original_data_size;
+    const std::span<const std::uint8_t> input_data = input_file.get_data();
+    std::unique_ptr<hc_context, decltype(&hc_context_destroy)> context(hc_context_create(), hc_context_destroy);
+
+    if (!context) {
+        std::cerr << "Cannot create the compression context" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!dictionary_data.empty() && hc_context_load_dictionary(context.get(), dictionary_data.data(), dictionary_data.size()) != HC_OK) {
+        std::cerr << hc_context_error(context.get()) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (arg_parser.verify) {
+        if (hc_verify(context.get(), input_data.data(), input_data.size(), arg_parser.thread_count) != HC_OK) {
+            std::cerr << hc_context_error(context.get()) << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::cout << "The compressed file '" << arg_parser.input_file << "' is valid" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    std::span<const std::uint8_t> output_data;
+    MappedFile output_file;
+    bool is_output_mapped = false;
+    std::size_t output_data_size;
+    hc_status status;
 
     if (arg_parser.compress) {
-        freqs = get_freqs(input_data.begin(), input_data.end());
-        original_data_size = input_data.size();
+        status = hc_compress_frames(
+            context.get(), input_data.data(), input_data.size(), NULL, 0, &output_data_size, mode, arg_parser.width_value, arg_parser.frame_height
+        );
     }
-    else {
-        freqs = get_freqs(output_data.begin(), output_data.end());
-        original_data_size = output_data.size();
+    else if (arg_parser.preview) {
+        std::uint64_t thumbnail_width;
+        unsigned thumbnail_scale;
+        status = hc_decompress_thumbnail(
+            context.get(), input_data.data(), input_data.size(), NULL, 0, &output_data_size, &thumbnail_width, &thumbnail_scale
+        );
+
+        if (status == HC_OK && !arg_parser.print_stats) {
+            std::cout << "Thumbnail: " << thumbnail_width << " pixels wide (1/" << thumbnail_scale << " scale)" << std::endl;
+        }
     }
+    else {
+        std::uint64_t decompressed_size;
 
-    double entrophy = 0;
+        // Decompress straight to the mapped output file, its size is known in advance from the header
+        if (arg_parser.map_output && hc_get_decompressed_size(input_data.data(), input_data.size(), &decompressed_size) == HC_OK) {
+            if (!STATS_MEASURE(STAGE_IO, output_file.map_for_writing(arg_parser.output_file, decompressed_size))) {
+                return EXIT_FAILURE;
+            }
 
-    for (const auto &val: freqs) {
-        if (val != 0) {
-            entrophy += (static_cast<double>(val) / original_data_size) * std::log2(static_cast<double>(original_data_size) / val);
+            is_output_mapped = true;
+            const auto output = output_file.get_data();
+            status = hc_decompress(context.get(), input_data.data(), input_data.size(), output.data(), output.size(), &output_data_size, arg_parser.thread_count);
+        }
+        else {
+            status = hc_decompress(context.get(), input_data.data(), input_data.size(), NULL, 0, &output_data_size, arg_parser.thread_count);
         }
     }
 
-    if (arg_parser.compress) {
-        std::cout << "Bits per symbol: " << (output_data.size() * 8.0) / original_data_size << std::endl;
-        std::cout << "Compression time (s): " << diff.count() << std::endl;
-        std::cout << "Original data entrophy: " << entrophy << std::endl;
+    if (status != HC_OK) {
+        std::cerr << hc_context_error(context.get()) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (is_output_mapped) {
+        output_data = output_file.get_data();
     }
     else {
-        std::cout << "Bits per symbol: " << (input_data.size() * 8.0) / original_data_size << std::endl;
-        std::cout << "Dempression time (s): " << diff.count() << std::endl;
-        std::cout << "Original data entrophy: " << entrophy << std::endl;
+        output_data = std::span<const std::uint8_t>(hc_context_output(context.get(), NULL), output_data_size);
+    }
+
+    if (!is_output_mapped && !STATS_MEASURE(STAGE_IO, write_bin_file(arg_parser.output_file, output_data))) {
+        return EXIT_FAILURE;
+    }
+
+    if (arg_parser.print_stats) {
+        const auto end = std::chrono::steady_clock::now();
+        add_size_stats(stats, arg_parser.compress, input_data.size(), output_data.size(), std::chrono::duration<double>(end - start).count());
+        stats.values.emplace_back("entropy", compute_entropy(arg_parser.compress ? input_data : output_data));
+        write_stats_json(std::cout, stats);
     }
-#endif
 
     return EXIT_SUCCESS;
 }
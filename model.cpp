@@ -8,13 +8,12 @@
  */
 
 
-#include <iterator>
-
 #include "model.h"
 
 
-std::vector<std::uint8_t> encode_adj_val_diff(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last) {
-    std::vector<std::uint8_t> result(std::distance(first, last));
+std::vector<std::uint8_t> encode_adj_val_diff(std::span<const std::uint8_t> data) {
+    std::vector<std::uint8_t> result(data.size());
+    auto first = data.begin();
     std::uint8_t prev = 0;
 
     for (auto &val: result) {
@@ -26,8 +25,9 @@ std::vector<std::uint8_t> encode_adj_val_diff(std::vector<std::uint8_t>::const_i
 }
 
 
-std::vector<std::uint8_t> decode_adj_val_diff(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last) {
-    std::vector<std::uint8_t> result(std::distance(first, last));
+std::vector<std::uint8_t> decode_adj_val_diff(std::span<const std::uint8_t> data) {
+    std::vector<std::uint8_t> result(data.size());
+    auto first = data.begin();
     std::uint8_t prev = 0;
 
     for (auto &val: result) {
@@ -37,3 +37,123 @@ std::vector<std::uint8_t> decode_adj_val_diff(std::vector<std::uint8_t>::const_i
 
     return result;
 }
+
+
+/**
+ * @brief Append the 16-bit value packed by the high byte escape scheme.
+ * 
+ * @param value The value to be packed
+ * @param packed_data Buffer to which the packed value is appended
+ */
+inline void pack_value(const std::uint16_t value, std::vector<std::uint8_t> &packed_data) {
+    if (value < SAMPLE_DIRECT_LIMIT) {
+        packed_data.push_back(value);
+    }
+    else if (value < SAMPLE_SHORT_LIMIT) {
+        packed_data.push_back(SAMPLE_DIRECT_LIMIT + ((value - SAMPLE_DIRECT_LIMIT) >> 8));
+        packed_data.push_back(value - SAMPLE_DIRECT_LIMIT);
+    }
+    else {
+        packed_data.push_back(SAMPLE_LONG_ESCAPE);
+        packed_data.push_back(value >> 8);
+        packed_data.push_back(value);
+    }
+}
+
+
+/**
+ * @brief Unpack the 16-bit value packed by the high byte escape scheme.
+ * 
+ * @param first Iterator to the first byte of the packed value, moved past the packed value
+ * @param last Iterator past the last byte of the packed data
+ * @param value The resulting unpacked value
+ * 
+ * @return True if the packed value is complete, false otherwise.
+ */
+inline bool unpack_value(std::span<const std::uint8_t>::iterator &first, const std::span<const std::uint8_t>::iterator last, std::uint16_t &value) {
+    const std::uint8_t escape = *first++;
+
+    if (escape < SAMPLE_DIRECT_LIMIT) {
+        value = escape;
+    }
+    else if (escape < SAMPLE_LONG_ESCAPE) {
+        if (first == last) {
+            return false;
+        }
+
+        value = SAMPLE_DIRECT_LIMIT + ((escape - SAMPLE_DIRECT_LIMIT) << 8) + *first++;
+    }
+    else {
+        if (last - first < 2) {
+            return false;
+        }
+
+        value = *first++ << 8;
+        value |= *first++;
+    }
+
+    return true;
+}
+
+
+std::vector<std::uint8_t> encode_adj_val_diff(std::span<const std::uint16_t> samples) {
+    std::vector<std::uint8_t> result;
+    result.reserve(samples.size() * 2);
+    std::uint16_t prev = 0;
+
+    for (const std::uint16_t sample: samples) {
+        const std::uint16_t diff = sample - prev;
+        // Zigzag mapping of the difference taken as a signed 16-bit number
+        pack_value(diff << 1 ^ (diff & 0x8000 ? 0xffff : 0), result);
+        prev = sample;
+    }
+
+    return result;
+}
+
+
+bool decode_adj_val_diff(std::span<const std::uint8_t> data, std::vector<std::uint16_t> &samples) {
+    auto first = data.begin();
+    std::uint16_t prev = 0;
+    samples.clear();
+
+    while (first != data.end()) {
+        std::uint16_t value;
+
+        if (!unpack_value(first, data.end(), value)) {
+            return false;
+        }
+
+        prev += value >> 1 ^ (value & 1 ? 0xffff : 0);
+        samples.push_back(prev);
+    }
+
+    return true;
+}
+
+
+std::vector<std::uint8_t> pack_samples(std::span<const std::uint16_t> samples) {
+    std::vector<std::uint8_t> result(samples.size() * 2);
+
+    for (std::uint64_t i = 0; i < samples.size(); i++) {
+        result[2 * i] = samples[i];
+        result[2 * i + 1] = samples[i] >> 8;
+    }
+
+    return result;
+}
+
+
+bool unpack_samples(std::span<const std::uint8_t> data, std::vector<std::uint16_t> &samples) {
+    if (data.size() % 2 != 0) {
+        return false;
+    }
+
+    samples.resize(data.size() / 2);
+
+    for (std::uint64_t i = 0; i < samples.size(); i++) {
+        samples[i] = data[2 * i] | data[2 * i + 1] << 8;
+    }
+
+    return true;
+}
@@ -13,28 +13,124 @@
 
 
 #include <vector>
+#include <span>
 #include <cstdint>
 
 
+// The residuals of the 16-bit samples are packed into bytes by the high byte escape scheme, i.e. the values lower than SAMPLE_DIRECT_LIMIT take one byte,
+// the values lower than SAMPLE_SHORT_LIMIT take the escape byte carrying their high bits and their low byte, the other values take
+// SAMPLE_LONG_ESCAPE and both their bytes
+#define SAMPLE_DIRECT_LIMIT 240
+#define SAMPLE_LONG_ESCAPE 255
+#define SAMPLE_SHORT_LIMIT (SAMPLE_DIRECT_LIMIT + ((SAMPLE_LONG_ESCAPE - SAMPLE_DIRECT_LIMIT) << 8))
+#define MAX_PACKED_SAMPLE_SIZE 3
+
+
+/**
+ * @brief Adjacent value difference transformation of the single values, so that it can be fused with the following stage (e.g. the RLE).
+ */
+struct AdjValDiffEncoder {
+    std::uint8_t prev = 0;
+
+    std::uint8_t operator()(const std::uint8_t val) {
+        const std::uint8_t diff = val - prev;
+        prev = val;
+        return diff;
+    }
+};
+
+
+/**
+ * @brief Inverse adjacent value difference transformation of the single differences, so that it can be fused with the preceding stage (e.g. the RLE).
+ */
+struct AdjValDiffDecoder {
+    std::uint8_t prev = 0;
+
+    std::uint8_t operator()(const std::uint8_t diff) {
+        prev += diff;
+        return prev;
+    }
+
+    /**
+     * @brief Append the values decoded from the run of the same differences.
+     * 
+     * @param result Buffer to which the decoded values are appended
+     * @param count The length of the run
+     * @param diff The repeated difference
+     */
+    void append_run(std::vector<std::uint8_t> &result, const std::uint64_t count, const std::uint8_t diff) {
+        // The run of zero differences (the most common one) repeats the previous value
+        if (diff == 0) {
+            result.insert(result.end(), count, prev);
+            return;
+        }
+
+        for (std::uint64_t i = 0; i < count; i++) {
+            result.push_back(prev += diff);
+        }
+    }
+};
+
+
 /**
  * @brief Encode data by adjacent value difference transformation.
  * 
- * @param first Iterator pointing to the first element to be encoded
- * @param first Iterator pointing to the end of the range (one past the last element to be encoded)
+ * @param data The data to be encoded
  * 
  * @return Encoded data.
  */
-std::vector<std::uint8_t> encode_adj_val_diff(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last);
+std::vector<std::uint8_t> encode_adj_val_diff(std::span<const std::uint8_t> data);
 
 /**
  * @brief Decode data encoded by adjacent value difference transformation.
  * 
- * @param first Iterator pointing to the first element to be decoded
- * @param first Iterator pointing to the end of the range (one past the last element to be decoded)
+ * @param data The data to be decoded
  * 
  * @return Decoded data.
  */
-std::vector<std::uint8_t> decode_adj_val_diff(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last);
+std::vector<std::uint8_t> decode_adj_val_diff(std::span<const std::uint8_t> data);
+
+/**
+ * @brief Encode 16-bit samples by adjacent value difference transformation and pack the differences into bytes.
+ * 
+ * @note The differences are mapped to the unsigned values by the zigzag mapping (small differences of both signs give small values).
+ * 
+ * @param samples The samples to be encoded
+ * 
+ * @return Encoded data (packed by the high byte escape scheme).
+ */
+std::vector<std::uint8_t> encode_adj_val_diff(std::span<const std::uint16_t> samples);
+
+/**
+ * @brief Decode 16-bit samples encoded by adjacent value difference transformation and packed into bytes.
+ * 
+ * @param data The data to be decoded
+ * @param samples The resulting decoded samples
+ * 
+ * @return True if the data consist of complete packed values, false otherwise.
+ */
+bool decode_adj_val_diff(std::span<const std::uint8_t> data, std::vector<std::uint16_t> &samples);
+
+/**
+ * @brief Pack 16-bit samples into bytes (without any transformation), each of them as its low byte followed by its high byte.
+ * 
+ * @note The raw samples are not packed by the high byte escape scheme, since most of them would take three bytes without the model.
+ * 
+ * @param samples The samples to be packed
+ * 
+ * @return Packed samples.
+ */
+std::vector<std::uint8_t> pack_samples(std::span<const std::uint16_t> samples);
+
+/**
+ * @brief Unpack 16-bit samples packed into bytes as the pairs of their low and high bytes.
+ * 
+ * @param data The packed samples
+ * @param samples The resulting unpacked samples
+ * 
+ * @return True if the data consist of complete pairs of bytes, false otherwise.
+ */
+bool unpack_samples(std::span<const std::uint8_t> data, std::vector<std::uint16_t> &samples);
 
 
 #endif
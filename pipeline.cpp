@@ -0,0 +1,446 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Pipelined (chunked) compression and decompression with overlapped input and output module
+ */
+
+
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#include "pipeline.h"
+#include "compress.h"
+#include "header.h"
+#include "error.h"
+
+
+
+
+/**
+ * @class Bounded queue of data chunks passed between the pipeline stages
+ */
+class ChunkQueue {
+    private:
+        std::deque<std::vector<std::uint8_t>> chunks;
+        std::mutex mutex;
+        std::condition_variable not_full;
+        std::condition_variable not_empty;
+        bool is_closed = false;
+        PipelineQueueStats &stats;
+
+    public:
+        /**
+         * @param stats The statistics to be updated by the queue operations
+         */
+        explicit ChunkQueue(PipelineQueueStats &stats) : stats(stats) {}
+
+        /**
+         * @brief Append the chunk to the queue, wait for a free place if the queue is full.
+         *
+         * @param chunk The chunk to be appended
+         *
+         * @return True if the chunk is appended, false if the queue is closed.
+         */
+        bool push(std::vector<std::uint8_t> &&chunk) {
+            std::unique_lock lock(mutex);
+            const auto start = std::chrono::steady_clock::now();
+            not_full.wait(lock, [this] { return is_closed || chunks.size() < PIPELINE_QUEUE_CAPACITY; });
+            stats.push_stall_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (is_closed) {
+                return false;
+            }
+
+            chunks.push_back(std::move(chunk));
+            stats.max_depth = std::max(stats.max_depth, static_cast<std::uint64_t>(chunks.size()));
+            not_empty.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Remove the first chunk from the queue, wait for a chunk if the queue is empty.
+         *
+         * @param chunk The removed chunk
+         *
+         * @return True if the chunk is removed, false if the queue is closed and empty.
+         */
+        bool pop(std::vector<std::uint8_t> &chunk) {
+            std::unique_lock lock(mutex);
+            const auto start = std::chrono::steady_clock::now();
+            not_empty.wait(lock, [this] { return is_closed || !chunks.empty(); });
+            stats.pop_stall_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (chunks.empty()) {
+                return false;
+            }
+
+            chunk = std::move(chunks.front());
+            chunks.pop_front();
+            not_full.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Close the queue, i.e. no more chunks can be appended and the waiting stages are woken up.
+         */
+        void close() {
+            std::lock_guard lock(mutex);
+            is_closed = true;
+            not_full.notify_all();
+            not_empty.notify_all();
+        }
+};
+
+
+/**
+ * @brief Read the uncompressed input file chunk by chunk and pass the chunks to the queue.
+ *
+ * @param fd The input file
+ * @param chunk_size The number of bytes of each chunk (except the last one)
+ * @param queue The queue for the read chunks
+ * @param failed Set to true in case of a reading error
+ */
+void read_raw_chunks(std::FILE *fd, const std::uint64_t chunk_size, ChunkQueue &queue, std::atomic<bool> &failed) {
+    while (true) {
+        std::vector<std::uint8_t> chunk(chunk_size);
+        chunk.resize(std::fread(chunk.data(), 1, chunk.size(), fd));
+
+        if (chunk.empty() || !queue.push(std::move(chunk))) {
+            break;
+        }
+    }
+
+    if (std::ferror(fd)) {
+        std::cerr << "Cannot read the input file correctly" << std::endl;
+        failed = true;
+    }
+
+    queue.close();
+}
+
+
+/**
+ * @brief Read the header and then the compressed chunks (according to their stored sizes) of the compressed input file and pass the chunks to the queue.
+ *
+ * @param fd The input file
+ * @param header The resulting header of the compressed input file
+ * @param queue The queue for the read chunks
+ * @param failed Set to true in case of a reading error, invalid header or invalid chunk size
+ */
+void read_compressed_chunks(std::FILE *fd, StreamHeader &header, ChunkQueue &queue, std::atomic<bool> &failed) {
+    struct stat input_stats;
+
+    if (fstat(fileno(fd), &input_stats) == -1) {
+        std::cerr << "Cannot obtain the size of the input file (using stats)" << std::endl;
+        failed = true;
+        queue.close();
+        return;
+    }
+
+    std::vector<std::uint8_t> header_data(HEADER_SIZE);
+    header_data.resize(std::fread(header_data.data(), 1, header_data.size(), fd));
+
+    if (!read_header(header_data, header) || !(header.flags & FLAG_CHUNKED)) {
+        std::cerr << (get_last_error().empty() ? "Invalid compressed data - the data are not chunked" : get_last_error()) << std::endl;
+        failed = true;
+        queue.close();
+        return;
+    }
+
+    // The stored chunk sizes are checked against the rest of the regular file before allocating the chunks (the size of other files is unknown)
+    const bool is_size_known = S_ISREG(input_stats.st_mode);
+    std::uint64_t remaining_size = is_size_known ? input_stats.st_size - header_data.size() : 0;
+
+    while (true) {
+        std::uint8_t chunk_size_bytes[CHUNK_SIZE_BYTE_COUNT];
+        const auto read_count = std::fread(chunk_size_bytes, 1, CHUNK_SIZE_BYTE_COUNT, fd);
+
+        if (read_count == 0) {
+            break;
+        }
+
+        if (read_count != CHUNK_SIZE_BYTE_COUNT) {
+            std::cerr << "Invalid compressed data - incomplete size of the compressed chunk" << std::endl;
+            failed = true;
+            break;
+        }
+
+        const std::uint64_t chunk_size = load_number(chunk_size_bytes, CHUNK_SIZE_BYTE_COUNT);
+
+        if (is_size_known) {
+            remaining_size -= std::min(remaining_size, static_cast<std::uint64_t>(CHUNK_SIZE_BYTE_COUNT));
+
+            if (chunk_size > remaining_size) {
+                std::cerr << "Invalid compressed data - the size of the compressed chunk exceeds the rest of the compressed data" << std::endl;
+                failed = true;
+                break;
+            }
+
+            remaining_size -= chunk_size;
+        }
+
+        std::vector<std::uint8_t> chunk(chunk_size);
+
+        if (std::fread(chunk.data(), 1, chunk.size(), fd) != chunk.size()) {
+            std::cerr << "Invalid compressed data - unexpected end of the compressed chunk" << std::endl;
+            failed = true;
+            break;
+        }
+
+        if (!queue.push(std::move(chunk))) {
+            break;
+        }
+    }
+
+    queue.close();
+}
+
+
+/**
+ * @brief Write the chunks from the queue to the output file.
+ *
+ * @param fd The output file
+ * @param queue The queue of the chunks to be written
+ * @param failed Set to true in case of a writing error
+ */
+void write_chunks(std::FILE *fd, ChunkQueue &queue, std::atomic<bool> &failed) {
+    std::vector<std::uint8_t> chunk;
+
+    while (queue.pop(chunk)) {
+        if (std::fwrite(chunk.data(), 1, chunk.size(), fd) != chunk.size()) {
+            std::cerr << "Cannot write to the output file correctly" << std::endl;
+            failed = true;
+            queue.close();
+            break;
+        }
+    }
+}
+
+
+/**
+ * @brief Run the reader and the writer in the background threads and the codec in the current one.
+ *
+ * @param input_filename The name of the input file
+ * @param output_filename The name of the output file
+ * @param reader The reading stage
+ * @param codec The stage transforming a chunk read by the reader to a chunk for the writer
+ * @param prologue The data written to the output file before the chunks (may be empty)
+ * @param stats The resulting statistics of the pipeline
+ *
+ * @return True if all the stages succeed, false otherwise.
+ */
+template<typename Reader, typename Codec>
+bool run_pipeline(
+    const std::string &input_filename, 
+    const std::string &output_filename, 
+    Reader reader, 
+    Codec codec, 
+    std::vector<std::uint8_t> &&prologue, 
+    PipelineStats &stats
+) {
+    std::FILE *input_fd = std::fopen(input_filename.c_str(), "rb");
+
+    if (input_fd == NULL) {
+        std::cerr << "Cannot open the input file '" << input_filename << "'" << std::endl;
+        return false;
+    }
+
+    std::FILE *output_fd = std::fopen(output_filename.c_str(), "wb");
+
+    if (output_fd == NULL) {
+        std::cerr << "Cannot open the output file '" << output_filename << "'" << std::endl;
+        std::fclose(input_fd);
+        return false;
+    }
+
+    ChunkQueue read_queue(stats.read_queue);
+    ChunkQueue write_queue(stats.write_queue);
+    std::atomic<bool> failed = false;
+
+    // The allocation failure cannot leave the reader thread, so it is passed to the codec as the failure of the reading (the queue is closed)
+    std::thread reader_thread([&]() {
+        try {
+            reader(input_fd, read_queue, failed);
+        }
+        catch (const std::bad_alloc &) {
+            std::cerr << "Cannot allocate the memory for the input chunk" << std::endl;
+            failed = true;
+            read_queue.close();
+        }
+    });
+    std::thread writer_thread(write_chunks, output_fd, std::ref(write_queue), std::ref(failed));
+
+    if (!prologue.empty()) {
+        write_queue.push(std::move(prologue));
+    }
+
+    std::vector<std::uint8_t> input_chunk;
+
+    while (read_queue.pop(input_chunk)) {
+        std::vector<std::uint8_t> output_chunk;
+        bool is_chunk_processed;
+
+        try {
+            is_chunk_processed = codec(input_chunk, output_chunk);
+        }
+        catch (const std::bad_alloc &) {
+            report_error("Cannot allocate the memory for the chunk");
+            is_chunk_processed = false;
+        }
+        catch (const std::length_error &) {
+            report_error("Cannot allocate the memory for the chunk");
+            is_chunk_processed = false;
+        }
+
+        if (!is_chunk_processed) {
+            std::cerr << get_last_error() << std::endl;
+            failed = true;
+            break;
+        }
+
+        if (!write_queue.push(std::move(output_chunk))) {
+            failed = true;
+            break;
+        }
+
+        stats.chunk_count++;
+    }
+
+    // Unblock the reader if the codec stopped early and let the writer finish the remaining chunks
+    read_queue.close();
+    write_queue.close();
+    reader_thread.join();
+    writer_thread.join();
+
+    std::fclose(input_fd);
+
+    if (std::fclose(output_fd) != 0) {
+        std::cerr << "Cannot write to the output file correctly '" << output_filename << "'" << std::endl;
+        return false;
+    }
+
+    return !failed;
+}
+
+
+bool compress_pipelined(
+    const std::string &input_filename,
+    const std::string &output_filename,
+    const CompressOptions &options,
+    const HuffmanDictionary *dictionary,
+    PipelineStats &stats
+) {
+    struct stat input_stats;
+
+    // The size of the whole input is stored in the header written before the first chunk
+    if (stat(input_filename.c_str(), &input_stats) == -1) {
+        std::cerr << "Cannot obtain the size of the input file '" << input_filename << "' (using stats)" << std::endl;
+        return false;
+    }
+
+    const std::uint64_t sample_size = options.sample_bits > MAX_BYTE_SAMPLE_BITS ? 2 : 1;
+    const std::uint64_t pixel_size = options.channel_count * sample_size;
+
+    if (input_stats.st_size % pixel_size != 0) {
+        std::cerr << "The size of the input file '" << input_filename << "' is not a multiple of the size of one pixel (" << pixel_size << " B)" << std::endl;
+        return false;
+    }
+
+    StreamHeader header;
+    header.flags = FLAG_CHUNKED | FLAG_RANS | (options.use_model ? FLAG_MODEL : 0) | (options.use_rle ? FLAG_RLE : 0) 
+        | (options.adapt_scan ? FLAG_ADAPTIVE : 0) | (options.use_checksum ? FLAG_CHECKSUM : 0) | (sample_size > 1 ? FLAG_SAMPLES_16 : 0)
+        | (options.thumbnail_cell_side != 0 && options.adapt_scan && input_stats.st_size > 0 ? FLAG_THUMBNAIL : 0);
+    header.original_size = input_stats.st_size;
+    header.width = options.adapt_scan ? options.width_value : 0;
+    std::vector<std::uint8_t> header_data;
+    write_header(header, header_data);
+
+    std::uint64_t chunk_size = PIPELINE_CHUNK_SIZE / pixel_size * pixel_size;
+
+    if (options.adapt_scan) {
+        // Use strips of whole block rows so that the blocks (and the cells of the thumbnails) of the chunks are the same as the ones of the whole image
+        const std::uint64_t strip_height = std::max(
+            static_cast<std::uint64_t>(BLOCK_SIDE_SIZE), PIPELINE_CHUNK_SIZE / (options.width_value * pixel_size) / BLOCK_SIDE_SIZE * BLOCK_SIDE_SIZE
+        );
+        chunk_size = strip_height * options.width_value * pixel_size;
+    }
+
+    auto reader = [chunk_size](std::FILE *fd, ChunkQueue &queue, std::atomic<bool> &failed) {
+        read_raw_chunks(fd, chunk_size, queue, failed);
+    };
+
+    // The chunks of the pipeline are not larger than the static chunks, and they are decompressed by more threads at the same time anyway
+    // (the chunks are independent, so they are never the sequences of frames predicted from each other either)
+    CompressOptions chunk_options = options;
+    chunk_options.is_planar = false;
+    chunk_options.use_static_chunks = false;
+    chunk_options.frame_height = 0;
+
+    auto codec = [&](const std::vector<std::uint8_t> &chunk, std::vector<std::uint8_t> &compressed_chunk) {
+        compressed_chunk.resize(CHUNK_SIZE_BYTE_COUNT);
+
+        if (options.channel_count > 1) {
+            compress_channels(chunk, compressed_chunk, chunk_options, dictionary);
+        }
+        else {
+            compress_data(chunk, compressed_chunk, chunk_options, dictionary);
+        }
+
+        // Store the size of the compressed chunk before it
+        store_number(compressed_chunk.data(), compressed_chunk.size() - CHUNK_SIZE_BYTE_COUNT, CHUNK_SIZE_BYTE_COUNT);
+
+        return true;
+    };
+
+    return run_pipeline(input_filename, output_filename, reader, codec, std::move(header_data), stats);
+}
+
+
+bool decompress_pipelined(
+    const std::string &input_filename,
+    const std::string &output_filename,
+    const unsigned thread_count,
+    const HuffmanDictionary *dictionary,
+    PipelineStats &stats
+) {
+    StreamHeader header;
+    std::uint64_t decompressed_size = 0;
+
+    auto reader = [&header](std::FILE *fd, ChunkQueue &queue, std::atomic<bool> &failed) {
+        read_compressed_chunks(fd, header, queue, failed);
+    };
+
+    auto codec = [&](const std::vector<std::uint8_t> &chunk, std::vector<std::uint8_t> &decompressed_chunk) {
+        if (!decompress_data(chunk, decompressed_chunk, thread_count, dictionary)) {
+            return false;
+        }
+
+        decompressed_size += decompressed_chunk.size();
+        return true;
+    };
+
+    if (!run_pipeline(input_filename, output_filename, reader, codec, std::vector<std::uint8_t>(), stats)) {
+        return false;
+    }
+
+    if (decompressed_size != header.original_size) {
+        std::cerr << "Invalid compressed data - the size of the decompressed chunks differs from the size specified in the compressed data header" << std::endl;
+        return false;
+    }
+
+    return true;
+}
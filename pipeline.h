@@ -0,0 +1,88 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Pipelined (chunked) compression and decompression with overlapped input and output interface
+ */
+
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+
+#include <string>
+#include <cstdint>
+
+#include "dictionary.h"
+#include "compress.h"
+
+
+#define PIPELINE_CHUNK_SIZE (1 << 20)
+#define PIPELINE_QUEUE_CAPACITY 4
+
+
+/**
+ * @brief Statistics of one bounded queue of the pipeline.
+ */
+struct PipelineQueueStats {
+    std::uint64_t max_depth = 0;    // The maximum number of chunks waiting in the queue
+    double push_stall_time = 0;     // The time (in seconds) the producer spent waiting for a free place in the queue
+    double pop_stall_time = 0;      // The time (in seconds) the consumer spent waiting for a chunk in the queue
+};
+
+/**
+ * @brief Statistics of the whole pipeline.
+ */
+struct PipelineStats {
+    std::uint64_t chunk_count = 0;  // The number of processed chunks
+    PipelineQueueStats read_queue;  // The queue between the reader and the codec
+    PipelineQueueStats write_queue; // The queue between the codec and the writer
+};
+
+/**
+ * @brief Compress the input file to the output file chunk by chunk with the reading and the writing overlapped with the compression.
+ *
+ * @note The header of the whole data is followed by the chunks each of which is compressed independently (with its own header) and stored after its compressed size.
+ * With the checksums, each chunk carries the checksums of its blocks and of its original data.
+ * With the adaptive scanning, a chunk is a strip of whole image rows. With more channels, each chunk consists of whole pixels
+ * and it is compressed as the multi-channel data.
+ *
+ * @param input_filename The name of the file to be compressed
+ * @param output_filename The name of the file for the resulting compressed data
+ * @param options The options of the compression of the chunks (the channels are stored pixel by pixel, the static chunks and the frames are not used)
+ * @param dictionary The dictionary of the code tables the blocks of the chunks may be encoded by (NULL if there is none)
+ * @param stats The resulting statistics of the pipeline
+ *
+ * @return True in case of successful compression, false otherwise.
+ */
+bool compress_pipelined(
+    const std::string &input_filename,
+    const std::string &output_filename,
+    const CompressOptions &options,
+    const HuffmanDictionary *dictionary,
+    PipelineStats &stats
+);
+
+/**
+ * @brief Decompress the input file compressed by the pipelined compression to the output file with the reading and the writing overlapped with the decompression.
+ *
+ * @param input_filename The name of the file to be decompressed
+ * @param output_filename The name of the file for the resulting decompressed data
+ * @param thread_count The maximum number of threads decompressing each chunk
+ * @param dictionary The dictionary of the code tables the data were compressed with (NULL if there is none)
+ * @param stats The resulting statistics of the pipeline
+ *
+ * @return True in case of successful decompression, false otherwise.
+ */
+bool decompress_pipelined(
+    const std::string &input_filename,
+    const std::string &output_filename,
+    const unsigned thread_count,
+    const HuffmanDictionary *dictionary,
+    PipelineStats &stats
+);
+
+
+#endif
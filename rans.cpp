@@ -0,0 +1,415 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Interleaved rANS (range asymmetric numeral systems) encoding and decoding module
+ */
+
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include "rans.h"
+#include "header.h"
+#include "error.h"
+
+
+#define BYTE_VALUE_COUNT 256
+
+// The used symbols are stored as a bitmap if there are at least as many of them as the bitmap has bytes, otherwise as a list
+#define SYMBOL_BITMAP_SIZE (BYTE_VALUE_COUNT / 8)
+
+// The numbers of variable length are split into 7-bit groups (the least significant first) with the highest bit set in all the groups except the last one
+#define NUMBER_GROUP_BIT_LENGTH 7
+#define NUMBER_GROUP_MASK 0x7f
+#define NUMBER_CONTINUATION 0x80
+#define MAX_NUMBER_SIZE 10
+
+
+/**
+ * @brief Get the number of bytes of the number stored with variable length.
+ *
+ * @param value The number
+ *
+ * @return The number of bytes.
+ */
+std::uint8_t get_variable_number_size(std::uint64_t value) {
+    std::uint8_t size = 1;
+
+    while (value > NUMBER_GROUP_MASK) {
+        value >>= NUMBER_GROUP_BIT_LENGTH;
+        size++;
+    }
+
+    return size;
+}
+
+
+/**
+ * @brief Store the number with variable length to the already allocated place.
+ *
+ * @param data The beginning of the place for the number
+ * @param value The number to be stored
+ *
+ * @return The number of bytes of the stored number.
+ */
+std::uint8_t store_variable_number(std::uint8_t *data, std::uint64_t value) {
+    std::uint8_t size = 0;
+
+    while (value > NUMBER_GROUP_MASK) {
+        data[size++] = (value & NUMBER_GROUP_MASK) | NUMBER_CONTINUATION;
+        value >>= NUMBER_GROUP_BIT_LENGTH;
+    }
+
+    data[size++] = value;
+    return size;
+}
+
+
+/**
+ * @brief Append the number with variable length to the data.
+ *
+ * @param data Buffer to which the number is appended
+ * @param value The number to be appended
+ */
+void append_variable_number(std::vector<std::uint8_t> &data, const std::uint64_t value) {
+    std::uint8_t number[MAX_NUMBER_SIZE];
+    data.insert(data.end(), number, number + store_variable_number(number, value));
+}
+
+
+/**
+ * @brief Load the number stored with variable length and move the pointer past it.
+ *
+ * @param data_it Pointer to the beginning of the stored number
+ * @param data_end_it Pointer one past the last byte of the data
+ * @param value The loaded number
+ *
+ * @return True if a complete number is stored, false otherwise.
+ */
+bool load_variable_number(const std::uint8_t *&data_it, const std::uint8_t *data_end_it, std::uint64_t &value) {
+    value = 0;
+
+    for (std::uint8_t i = 0; i < MAX_NUMBER_SIZE && data_it < data_end_it; i++) {
+        const std::uint8_t group = *data_it++;
+        value |= static_cast<std::uint64_t>(group & NUMBER_GROUP_MASK) << (i * NUMBER_GROUP_BIT_LENGTH);
+
+        if (!(group & NUMBER_CONTINUATION)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void RansEncoder::initialize_encoding(const std::vector<std::uint64_t> &freqs) {
+    symbol_count = std::accumulate(freqs.begin(), freqs.end(), static_cast<std::uint64_t>(0));
+    used_symbol_count = 0;
+    std::uint32_t quantized_sum = 0;
+    std::uint16_t most_frequent_symbol = 0;
+
+    for (std::uint16_t i = 0; i < BYTE_VALUE_COUNT; i++) {
+        quantized_freqs[i] = 0;
+
+        if (freqs[i] == 0) {
+            continue;
+        }
+
+        const double scaled_freq = std::floor(static_cast<double>(freqs[i]) * RANS_SCALE / symbol_count);
+        quantized_freqs[i] = std::clamp(scaled_freq, 1.0, static_cast<double>(RANS_SCALE));
+        quantized_sum += quantized_freqs[i];
+        used_symbol_count++;
+
+        if (freqs[i] > freqs[most_frequent_symbol]) {
+            most_frequent_symbol = i;
+        }
+    }
+
+    // The rounding error is compensated by the most frequent symbol, where it costs the least
+    if (quantized_sum < RANS_SCALE) {
+        quantized_freqs[most_frequent_symbol] += RANS_SCALE - quantized_sum;
+    }
+    else if (quantized_sum > RANS_SCALE) {
+        // The rare symbols raised to the frequency 1 are paid for by the most frequent ones (each of them keeps at least the frequency 1)
+        std::vector<std::uint8_t> symbols_by_freq;
+
+        for (std::uint16_t i = 0; i < BYTE_VALUE_COUNT; i++) {
+            if (quantized_freqs[i] > 1) {
+                symbols_by_freq.push_back(i);
+            }
+        }
+
+        std::sort(symbols_by_freq.begin(), symbols_by_freq.end(), [this](std::uint8_t a, std::uint8_t b) {
+            return quantized_freqs[a] > quantized_freqs[b];
+        });
+
+        std::uint32_t excess = quantized_sum - RANS_SCALE;
+
+        for (const auto &symbol: symbols_by_freq) {
+            const std::uint32_t reduction = std::min(excess, quantized_freqs[symbol] - 1u);
+            quantized_freqs[symbol] -= reduction;
+            excess -= reduction;
+        }
+    }
+
+    // The frequency of the last used symbol is not stored, it is the remainder to RANS_SCALE
+    table_size = 1 + (used_symbol_count >= SYMBOL_BITMAP_SIZE ? SYMBOL_BITMAP_SIZE : used_symbol_count);
+    std::uint16_t cumulative_freq = 0;
+    std::uint16_t stored_freq_count = 0;
+
+    for (std::uint16_t i = 0; i < BYTE_VALUE_COUNT; i++) {
+        cumulative_freqs[i] = cumulative_freq;
+        cumulative_freq += quantized_freqs[i];
+
+        if (quantized_freqs[i] > 0 && ++stored_freq_count < used_symbol_count) {
+            table_size += get_variable_number_size(quantized_freqs[i] - 1);
+        }
+    }
+}
+
+
+std::uint64_t RansEncoder::estimate_encoded_size(const std::vector<std::uint64_t> &freqs) const {
+    double bit_count = 0;
+
+    for (std::uint16_t i = 0; i < BYTE_VALUE_COUNT; i++) {
+        if (freqs[i] > 0) {
+            bit_count += freqs[i] * (RANS_SCALE_BITS - std::log2(quantized_freqs[i]));
+        }
+    }
+
+    const std::uint64_t payload_size = std::ceil(bit_count / 8) + RANS_STATE_COUNT * RANS_STATE_BYTE_COUNT;
+    return table_size + get_variable_number_size(symbol_count) + get_variable_number_size(payload_size) + payload_size;
+}
+
+
+void RansEncoder::encode_data(std::span<const std::uint8_t> data, std::vector<std::uint8_t> &encoded_data) const {
+    // The frequency table
+    encoded_data.push_back(used_symbol_count - 1);
+
+    if (used_symbol_count >= SYMBOL_BITMAP_SIZE) {
+        const std::uint64_t bitmap_offset = encoded_data.size();
+        encoded_data.resize(bitmap_offset + SYMBOL_BITMAP_SIZE);
+
+        for (std::uint16_t i = 0; i < BYTE_VALUE_COUNT; i++) {
+            if (quantized_freqs[i] > 0) {
+                encoded_data[bitmap_offset + i / 8] |= 1 << (i % 8);
+            }
+        }
+    }
+    else {
+        for (std::uint16_t i = 0; i < BYTE_VALUE_COUNT; i++) {
+            if (quantized_freqs[i] > 0) {
+                encoded_data.push_back(i);
+            }
+        }
+    }
+
+    std::uint16_t stored_freq_count = 0;
+
+    for (std::uint16_t i = 0; i < BYTE_VALUE_COUNT; i++) {
+        if (quantized_freqs[i] > 0 && ++stored_freq_count < used_symbol_count) {
+            append_variable_number(encoded_data, quantized_freqs[i] - 1);
+        }
+    }
+
+    append_variable_number(encoded_data, data.size());
+
+    // The payload is written backwards to the end of the reserved place (each symbol takes at most 2 bytes) and then moved right after its size
+    const std::uint64_t payload_size_offset = encoded_data.size();
+    encoded_data.resize(payload_size_offset + MAX_NUMBER_SIZE + data.size() * 2 + RANS_STATE_COUNT * RANS_STATE_BYTE_COUNT);
+    std::uint8_t *const payload_end_it = encoded_data.data() + encoded_data.size();
+    std::uint8_t *payload_it = payload_end_it;
+    std::uint32_t states[RANS_STATE_COUNT];
+    std::fill_n(states, RANS_STATE_COUNT, RANS_LOWER_BOUND);
+
+    // The symbols are encoded in the reverse order, so that they are decoded in the original order
+    for (std::uint64_t i = data.size(); i-- > 0;) {
+        std::uint32_t &state = states[i % RANS_STATE_COUNT];
+        const std::uint32_t freq = quantized_freqs[data[i]];
+        const std::uint32_t max_state = ((RANS_LOWER_BOUND >> RANS_SCALE_BITS) << 8) * freq;
+
+        while (state >= max_state) {
+            *--payload_it = state;
+            state >>= 8;
+        }
+
+        state = ((state / freq) << RANS_SCALE_BITS) + state % freq + cumulative_freqs[data[i]];
+    }
+
+    for (std::uint8_t i = RANS_STATE_COUNT; i-- > 0;) {
+        payload_it -= RANS_STATE_BYTE_COUNT;
+        store_number(payload_it, states[i], RANS_STATE_BYTE_COUNT);
+    }
+
+    const std::uint64_t payload_size = payload_end_it - payload_it;
+    const std::uint8_t payload_size_size = get_variable_number_size(payload_size);
+    std::copy(payload_it, payload_end_it, encoded_data.begin() + payload_size_offset + payload_size_size);
+    store_variable_number(encoded_data.data() + payload_size_offset, payload_size);
+    encoded_data.resize(payload_size_offset + payload_size_size + payload_size);
+}
+
+
+void RansDecoder::set_source(std::span<const std::uint8_t> source) {
+    current_source_it = source.data();
+    source_end_it = source.data() + source.size();
+}
+
+
+bool RansDecoder::initialize_decoding() {
+    if (current_source_it >= source_end_it) {
+        report_error("Invalid compressed data - unexpected end of the rANS frequency table");
+        return false;
+    }
+
+    const std::uint16_t used_symbol_count = *current_source_it++ + 1;
+    std::array<std::uint8_t, BYTE_VALUE_COUNT> used_symbols;
+
+    if (used_symbol_count >= SYMBOL_BITMAP_SIZE) {
+        if (source_end_it - current_source_it < SYMBOL_BITMAP_SIZE) {
+            report_error("Invalid compressed data - unexpected end of the rANS frequency table");
+            return false;
+        }
+
+        std::uint16_t symbol_count = 0;
+
+        for (std::uint16_t i = 0; i < BYTE_VALUE_COUNT; i++) {
+            if (current_source_it[i / 8] & (1 << (i % 8))) {
+                used_symbols[symbol_count++] = i;
+            }
+        }
+
+        current_source_it += SYMBOL_BITMAP_SIZE;
+
+        if (symbol_count != used_symbol_count) {
+            report_error("Invalid compressed data - the rANS symbol bitmap does not match the number of the used symbols");
+            return false;
+        }
+    }
+    else {
+        if (source_end_it - current_source_it < used_symbol_count) {
+            report_error("Invalid compressed data - unexpected end of the rANS frequency table");
+            return false;
+        }
+
+        for (std::uint16_t i = 0; i < used_symbol_count; i++) {
+            used_symbols[i] = current_source_it[i];
+
+            if (i > 0 && used_symbols[i] <= used_symbols[i - 1]) {
+                report_error("Invalid compressed data - the rANS symbols are not in ascending order");
+                return false;
+            }
+        }
+
+        current_source_it += used_symbol_count;
+    }
+
+    quantized_freqs.fill(0);
+    std::uint32_t cumulative_freq = 0;
+
+    for (std::uint16_t i = 0; i < used_symbol_count; i++) {
+        std::uint64_t freq = RANS_SCALE - cumulative_freq;
+
+        if (i + 1 < used_symbol_count) {
+            if (!load_variable_number(current_source_it, source_end_it, freq)) {
+                report_error("Invalid compressed data - unexpected end of the rANS frequency table");
+                return false;
+            }
+
+            // Each of the remaining symbols needs a nonzero frequency
+            if (++freq > RANS_SCALE - cumulative_freq - (used_symbol_count - i - 1)) {
+                report_error("Invalid compressed data - the rANS frequencies exceed the scale");
+                return false;
+            }
+        }
+
+        const std::uint8_t symbol = used_symbols[i];
+        quantized_freqs[symbol] = freq;
+        cumulative_freqs[symbol] = cumulative_freq;
+        std::fill_n(slot_symbols.begin() + cumulative_freq, freq, symbol);
+        cumulative_freq += freq;
+    }
+
+    return true;
+}
+
+
+inline std::uint8_t RansDecoder::decode_symbol(std::uint32_t &state, const std::uint8_t *&source_it, const std::uint8_t *payload_end_it) const {
+    const std::uint32_t slot = state & (RANS_SCALE - 1);
+    const std::uint8_t symbol = slot_symbols[slot];
+    state = quantized_freqs[symbol] * (state >> RANS_SCALE_BITS) + slot - cumulative_freqs[symbol];
+
+    while (state < RANS_LOWER_BOUND && source_it < payload_end_it) {
+        state = (state << 8) | *source_it++;
+    }
+
+    return symbol;
+}
+
+
+bool RansDecoder::decode_data(std::vector<std::uint8_t> &decoded_data, const std::uint64_t max_symbol_count) {
+    std::uint64_t symbol_count;
+    std::uint64_t payload_size;
+
+    if (!load_variable_number(current_source_it, source_end_it, symbol_count) || !load_variable_number(current_source_it, source_end_it, payload_size)) {
+        report_error("Invalid compressed data - unexpected end of the rANS encoded data");
+        return false;
+    }
+
+    if (symbol_count > max_symbol_count) {
+        report_error("Invalid compressed data - the number of the rANS encoded symbols exceeds the size of the data block");
+        return false;
+    }
+
+    if (payload_size < RANS_STATE_COUNT * RANS_STATE_BYTE_COUNT || payload_size > static_cast<std::uint64_t>(source_end_it - current_source_it)) {
+        report_error("Invalid compressed data - invalid size of the rANS encoded data");
+        return false;
+    }
+
+    const std::uint8_t *const payload_end_it = current_source_it + payload_size;
+    std::uint32_t states[RANS_STATE_COUNT];
+
+    for (auto &state: states) {
+        state = load_number(current_source_it, RANS_STATE_BYTE_COUNT);
+        current_source_it += RANS_STATE_BYTE_COUNT;
+
+        if (state < RANS_LOWER_BOUND || state >= RANS_LOWER_BOUND << 8) {
+            report_error("Invalid compressed data - invalid rANS state");
+            return false;
+        }
+    }
+
+    decoded_data.resize(symbol_count);
+    std::uint8_t *const decoded_it = decoded_data.data();
+    std::uint64_t i = 0;
+
+    // The states are independent, so the decoding of the symbols of one group overlaps
+    for (; i + RANS_STATE_COUNT <= symbol_count; i += RANS_STATE_COUNT) {
+        for (std::uint8_t j = 0; j < RANS_STATE_COUNT; j++) {
+            decoded_it[i + j] = decode_symbol(states[j], current_source_it, payload_end_it);
+        }
+    }
+
+    for (; i < symbol_count; i++) {
+        decoded_it[i] = decode_symbol(states[i % RANS_STATE_COUNT], current_source_it, payload_end_it);
+    }
+
+    // Valid encoded data are consumed completely and return the states to their initial values
+    const bool is_consumed = current_source_it == payload_end_it;
+    current_source_it = payload_end_it;
+
+    if (!is_consumed || std::any_of(states, states + RANS_STATE_COUNT, [](std::uint32_t state) { return state != RANS_LOWER_BOUND; })) {
+        report_error("Invalid compressed data - the rANS encoded data are corrupted");
+        return false;
+    }
+
+    return true;
+}
+
+
+std::span<const std::uint8_t> RansDecoder::get_remaining_source() {
+    return std::span<const std::uint8_t>(current_source_it, source_end_it);
+}
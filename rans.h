@@ -0,0 +1,135 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Interleaved rANS (range asymmetric numeral systems) encoding and decoding interface
+ */
+
+
+#ifndef RANS_H
+#define RANS_H
+
+
+#include <vector>
+#include <array>
+#include <span>
+#include <cstdint>
+
+
+// The quantized frequencies of the symbols sum up to 2^RANS_SCALE_BITS
+#define RANS_SCALE_BITS 12
+#define RANS_SCALE (1u << RANS_SCALE_BITS)
+
+// The symbols are encoded alternately by the independent states, so that the decoding of the neighbouring symbols can overlap
+#define RANS_STATE_COUNT 4
+#define RANS_STATE_BYTE_COUNT 4
+
+// The states are kept in [RANS_LOWER_BOUND, RANS_LOWER_BOUND << 8) by the byte-wise renormalization
+#define RANS_LOWER_BOUND (1u << 23)
+
+
+/**
+ * @class Interleaved rANS encoder with the quantized frequency table
+ *
+ * @note The encoded data consist of the frequency table, the number of the encoded symbols, the size of the encoded payload
+ * and the payload starting with the final values of the states.
+ * The encoder keeps the quantized frequencies of the current encoding, so one instance must not be used by more threads at the same time.
+ */
+class RansEncoder {
+    private:
+        std::array<std::uint16_t, 256> quantized_freqs;     // Frequencies of the symbols scaled to RANS_SCALE (0 for unused symbols)
+        std::array<std::uint16_t, 256> cumulative_freqs;    // Sums of the quantized frequencies of all the preceding symbols
+        std::uint16_t used_symbol_count;                    // The number of symbols with nonzero frequency
+        std::uint64_t symbol_count;                         // The number of symbols to be encoded
+        std::uint64_t table_size;                           // The size of the stored frequency table (in bytes)
+
+    public:
+        /**
+         * @brief Quantize the frequencies of occurences of symbols so that they sum up to RANS_SCALE.
+         *
+         * @note Each used symbol keeps a nonzero frequency.
+         *
+         * @param freqs Frequencies of occurences of symbols (at least one of them must be nonzero)
+         */
+        void initialize_encoding(const std::vector<std::uint64_t> &freqs);
+
+        /**
+         * @brief Estimate the size of the encoded data from the quantized frequencies without encoding them.
+         *
+         * @param freqs Frequencies of occurences of symbols the encoding has been initialized with
+         *
+         * @return The estimated size of the encoded data including the frequency table (in bytes).
+         */
+        std::uint64_t estimate_encoded_size(const std::vector<std::uint64_t> &freqs) const;
+
+        /**
+         * @brief Encode the data with the frequency table using interleaved rANS.
+         *
+         * @param data The data to be encoded (with the frequencies the encoding has been initialized with)
+         * @param encoded_data Buffer to which the encoded data are appended
+         */
+        void encode_data(std::span<const std::uint8_t> data, std::vector<std::uint8_t> &encoded_data) const;
+};
+
+/**
+ * @class Interleaved rANS decoder
+ *
+ * @note The decoder keeps the state of the current decoding, so one instance must not be used by more threads at the same time.
+ * An instance can be reused for any number of subsequent decodings.
+ */
+class RansDecoder {
+    private:
+        const std::uint8_t *current_source_it;              // Pointer to the first byte that has not been decoded yet
+        const std::uint8_t *source_end_it;                  // Pointer one past the last byte of the source
+        std::array<std::uint8_t, RANS_SCALE> slot_symbols;  // The symbol of each slot of the state
+        std::array<std::uint16_t, 256> quantized_freqs;     // Quantized frequencies of the symbols
+        std::array<std::uint16_t, 256> cumulative_freqs;    // Sums of the quantized frequencies of all the preceding symbols
+
+        /**
+         * @brief Decode one symbol by the state and renormalize the state from the source.
+         *
+         * @param state The state by which the symbol is decoded
+         * @param source_it Pointer to the next byte of the payload
+         * @param payload_end_it Pointer one past the last byte of the payload
+         *
+         * @return The decoded symbol.
+         */
+        std::uint8_t decode_symbol(std::uint32_t &state, const std::uint8_t *&source_it, const std::uint8_t *payload_end_it) const;
+
+    public:
+        /**
+         * @brief Set the source encoded data to decode.
+         *
+         * @param source The encoded data to be decoded
+         */
+        void set_source(std::span<const std::uint8_t> source);
+
+        /**
+         * @brief Load the frequency table from the source and prepare the decoding tables.
+         *
+         * @return True in case of successful initialization, false otherwise.
+         */
+        bool initialize_decoding();
+
+        /**
+         * @brief Decode all the symbols of the source encoded data.
+         *
+         * @param decoded_data Buffer for storing decoded data
+         * @param max_symbol_count The maximum number of symbols that can be stored in valid encoded data
+         *
+         * @return True in case of successful decoding, false otherwise.
+         */
+        bool decode_data(std::vector<std::uint8_t> &decoded_data, std::uint64_t max_symbol_count);
+
+        /**
+         * @brief Get the part of the source that has not been processed yet.
+         *
+         * @return The remaining source encoded data.
+         */
+        std::span<const std::uint8_t> get_remaining_source();
+};
+
+
+#endif
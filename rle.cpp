@@ -9,23 +9,35 @@
 
 
 #include <algorithm>
+#include <bit>
+#include <limits>
 
 #include "rle.h"
+#include "model.h"
 
 
 #define BYTE_VALUE_COUNT 256
 #define RLE_TRESHOLD 3
 
+// Counts lower than the escape are stored in a single byte, the larger ones are stored as the escape followed by the rest of the count in 7-bit groups
+#define COUNT_ESCAPE UINT8_MAX
+#define COUNT_GROUP_BIT_LENGTH 7
+#define COUNT_GROUP_MASK 0x7f
+#define COUNT_CONTINUATION 0x80
+
 #define MARKER 0
 #define COUNT 1
-#define SYMBOL 2
+#define COUNT_EXTENSION 2
+#define SYMBOL 3
 
 
-std::uint8_t get_optimal_marker(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last) {
-    if (first == last) {
+std::uint8_t get_optimal_marker(std::span<const std::uint8_t> data) {
+    if (data.empty()) {
         return DEFAULT_MARKER;
     }
 
+    auto first = data.begin();
+    const auto last = data.end();
     std::vector<std::uint64_t> val_seqs_of_len_one(BYTE_VALUE_COUNT);
     std::uint8_t prev = *first;
     bool len_one_seq = true;
@@ -48,6 +60,33 @@ std::uint8_t get_optimal_marker(std::vector<std::uint8_t>::const_iterator first,
 }
 
 
+/**
+ * @brief Append the repetition count to the specified code sequence.
+ * 
+ * @note Counts lower than the escape take one byte. The larger ones take the escape byte followed by the remainder of the count split into 7-bit groups
+ * (the least significant first) with the highest bit set in all the groups except the last one, so even very long runs take only a few bytes.
+ * 
+ * @param result The sequence to which the count is to be appended
+ * @param count The repetition count to be appended
+ */
+void append_count(std::vector<std::uint8_t> &result, std::uint64_t count) {
+    if (count < COUNT_ESCAPE) {
+        result.push_back(count);
+        return;
+    }
+
+    result.push_back(COUNT_ESCAPE);
+    count -= COUNT_ESCAPE;
+
+    while (count > COUNT_GROUP_MASK) {
+        result.push_back((count & COUNT_GROUP_MASK) | COUNT_CONTINUATION);
+        count >>= COUNT_GROUP_BIT_LENGTH;
+    }
+
+    result.push_back(count);
+}
+
+
 /**
  * @brief Encode the symbol using RLE and append it to the specified code sequence.
  * 
@@ -56,7 +95,7 @@ std::uint8_t get_optimal_marker(std::vector<std::uint8_t>::const_iterator first,
  * @param symbol Symbol to be encoded
  * @param marker RLE marker
  */
-void encode_and_append_symbol(std::vector<std::uint8_t> &result, uint8_t count, uint8_t symbol, uint8_t marker) {
+void encode_and_append_symbol(std::vector<std::uint8_t> &result, std::uint64_t count, std::uint8_t symbol, std::uint8_t marker) {
     if (count < RLE_TRESHOLD) {
         if (symbol != marker) {
             // The count is reduced by one, i.e. 0 represent 1, etc.
@@ -64,33 +103,45 @@ void encode_and_append_symbol(std::vector<std::uint8_t> &result, uint8_t count,
         }
         else {
             // 2 bytes are enough to represent 1, 2 or 3 marker symbols
-            result.insert(result.end(), {marker, count});
+            result.insert(result.end(), {marker, static_cast<std::uint8_t>(count)});
         }
     }
     else {
-        result.insert(result.end(), {marker, count, symbol});
+        result.push_back(marker);
+        append_count(result, count);
+        result.push_back(symbol);
     }
 }
 
 
-std::vector<std::uint8_t> encode_rle(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last, std::uint8_t marker) {
+std::vector<std::uint8_t> encode_rle(std::span<const std::uint8_t> data, std::uint8_t marker) {
+    return encode_rle(data, marker, IdentityTransform());
+}
+
+
+template<typename Transform>
+std::vector<std::uint8_t> encode_rle(std::span<const std::uint8_t> data, std::uint8_t marker, Transform transform) {
     std::vector<std::uint8_t> result;
 
-    if (first == last) {
+    if (data.empty()) {
         return result;
     }
 
-    std::uint8_t count = 0;
-    std::uint8_t prev = *first;
+    auto first = data.begin();
+    const auto last = data.end();
+    std::uint64_t count = 0;
+    std::uint8_t prev = transform(*first);
 
     while (++first < last) {
-        if (*first == prev && count < UINT8_MAX) {
+        const std::uint8_t symbol = transform(*first);
+
+        if (symbol == prev) {
             count++;
             continue;
         }
 
         encode_and_append_symbol(result, count, prev, marker);
-        prev = *first;
+        prev = symbol;
         count = 0;
     }
 
@@ -99,9 +150,21 @@ std::vector<std::uint8_t> encode_rle(std::vector<std::uint8_t>::const_iterator f
 }
 
 
-std::vector<std::uint8_t> decode_rle(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last, std::uint8_t marker) {
-    std::uint8_t count, state = MARKER;
-    std::vector<std::uint8_t> result;
+bool decode_rle(std::span<const std::uint8_t> data, std::uint8_t marker, std::uint64_t decoded_size, std::vector<std::uint8_t> &result) {
+    return decode_rle(data, marker, decoded_size, result, IdentityTransform());
+}
+
+
+template<typename Transform>
+bool decode_rle(std::span<const std::uint8_t> data, std::uint8_t marker, std::uint64_t decoded_size, std::vector<std::uint8_t> &result, Transform transform) {
+    auto first = data.begin();
+    const auto last = data.end();
+    std::uint64_t count = 0;
+    std::uint8_t count_shift = 0;
+    std::uint8_t state = MARKER;
+    result.clear();
+    // The maximum size is not trusted to allocate (the runs of corrupted data are rejected only when decoded), the result grows with the runs
+    result.reserve(std::min<std::uint64_t>(decoded_size, data.size()));
 
     while (first < last) {
         if (state == MARKER) {
@@ -109,26 +172,75 @@ std::vector<std::uint8_t> decode_rle(std::vector<std::uint8_t>::const_iterator f
                 state = COUNT;
             }
             else {
-                result.push_back(*first);
+                if (result.size() == decoded_size) {
+                    return false;
+                }
+
+                result.push_back(transform(*first));
             }
         }
         else if (state == COUNT) {
             if (*first < RLE_TRESHOLD) {
-                result.insert(result.end(), *first + 1, marker);
+                if (*first >= decoded_size - result.size()) {
+                    return false;
+                }
+
+                transform.append_run(result, *first + 1, marker);
                 state = MARKER;
             }
+            else if (*first == COUNT_ESCAPE) {
+                count = COUNT_ESCAPE;
+                count_shift = 0;
+                state = COUNT_EXTENSION;
+            }
             else {
                 count = *first;
                 state = SYMBOL;
             }
         }
+        else if (state == COUNT_EXTENSION) {
+            const std::uint8_t group = *first & COUNT_GROUP_MASK;
+
+            // The groups that do not fit into the count cannot be produced by the encoder
+            if (count_shift >= std::numeric_limits<std::uint64_t>::digits || count_shift + std::bit_width(group) > std::numeric_limits<std::uint64_t>::digits) {
+                return false;
+            }
+
+            count += static_cast<std::uint64_t>(group) << count_shift;
+            count_shift += COUNT_GROUP_BIT_LENGTH;
+
+            // The run cannot be longer than the rest of the decoded data
+            if (count >= decoded_size - result.size()) {
+                return false;
+            }
+
+            if (!(*first & COUNT_CONTINUATION)) {
+                state = SYMBOL;
+            }
+        }
         else {  // symbol
-            result.insert(result.end(), count + 1, *first);
+            if (count >= decoded_size - result.size()) {
+                return false;
+            }
+
+            // The whole run is expanded by a single fill
+            transform.append_run(result, count + 1, *first);
             state = MARKER;
         }
 
         first++;
     }
 
-    return result;
+    return true;
 }
+
+
+// The RLE is provided fused with the transformations of the model as well
+template std::vector<std::uint8_t> encode_rle<IdentityTransform>(std::span<const std::uint8_t> data, std::uint8_t marker, IdentityTransform transform);
+template std::vector<std::uint8_t> encode_rle<AdjValDiffEncoder>(std::span<const std::uint8_t> data, std::uint8_t marker, AdjValDiffEncoder transform);
+template bool decode_rle<IdentityTransform>(
+    std::span<const std::uint8_t> data, std::uint8_t marker, std::uint64_t decoded_size, std::vector<std::uint8_t> &result, IdentityTransform transform
+);
+template bool decode_rle<AdjValDiffDecoder>(
+    std::span<const std::uint8_t> data, std::uint8_t marker, std::uint64_t decoded_size, std::vector<std::uint8_t> &result, AdjValDiffDecoder transform
+);
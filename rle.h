@@ -13,43 +13,89 @@
 
 
 #include <vector>
+#include <span>
 #include <cstdint>
 
 
 #define DEFAULT_MARKER 128
 
 
+/**
+ * @brief Transformation of the symbols fused with the RLE keeping them unchanged (see the transformations of the model in model.h).
+ */
+struct IdentityTransform {
+    std::uint8_t operator()(const std::uint8_t symbol) {
+        return symbol;
+    }
+
+    void append_run(std::vector<std::uint8_t> &result, const std::uint64_t count, const std::uint8_t symbol) {
+        result.insert(result.end(), count, symbol);
+    }
+};
+
+
 /**
  * @brief Find optimal marker for the data specified by parameters.
  * 
- * @param first Iterator pointing to the first element of the given data
- * @param last Iterator pointing to the end of the range (one past the last element of the given data)
+ * @param data The given data
  * 
  * @return Optimal marker for given data.
  */
-std::uint8_t get_optimal_marker(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last);
+std::uint8_t get_optimal_marker(std::span<const std::uint8_t> data);
 
 /**
  * @brief Encode data using RLE.
  * 
- * @param first Iterator pointing to the first element to be encoded
- * @param last Iterator pointing to the end of the range (one past the last element to be encoded)
+ * @note Runs of any length are encoded as a single marker sequence, the repetition count is stored in one byte or, for very long runs, in a few escape-extended bytes.
+ * 
+ * @param data The data to be encoded
  * @param marker RLE marker
  * 
  * @return Encoded data.
  */
-std::vector<std::uint8_t> encode_rle(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last, std::uint8_t marker = DEFAULT_MARKER);
+std::vector<std::uint8_t> encode_rle(std::span<const std::uint8_t> data, std::uint8_t marker = DEFAULT_MARKER);
+
+/**
+ * @brief Encode the data transformed symbol by symbol (e.g. by the model) using RLE in a single pass without the buffer of the transformed data.
+ * 
+ * @note It is instantiated for IdentityTransform and AdjValDiffEncoder only.
+ * 
+ * @param data The data to be transformed and encoded
+ * @param marker RLE marker
+ * @param transform The transformation applied to each symbol of the data in order
+ * 
+ * @return Encoded transformed data.
+ */
+template<typename Transform>
+std::vector<std::uint8_t> encode_rle(std::span<const std::uint8_t> data, std::uint8_t marker, Transform transform);
 
 /**
  * @brief Decode data encoded using RLE.
  * 
- * @param first Iterator pointing to the first element to be decoded
- * @param last Iterator pointing to the end of the range (one past the last element to be decoded)
+ * @param data The data to be decoded
+ * @param marker RLE marker
+ * @param decoded_size The maximum size of the decoded data
+ * @param result The resulting decoded data
+ * 
+ * @return True if the decoded data fit into the maximum size (and the counts of the runs into 64 bits), false otherwise.
+ */
+bool decode_rle(std::span<const std::uint8_t> data, std::uint8_t marker, std::uint64_t decoded_size, std::vector<std::uint8_t> &result);
+
+/**
+ * @brief Decode data encoded using RLE and transform the decoded symbols (e.g. by the inverse model) in a single pass.
+ * 
+ * @note It is instantiated for IdentityTransform and AdjValDiffDecoder only.
+ * 
+ * @param data The data to be decoded
  * @param marker RLE marker
+ * @param decoded_size The maximum size of the decoded data
+ * @param result The resulting decoded transformed data
+ * @param transform The transformation applied to each decoded symbol in order (and to the runs by its append_run)
  * 
- * @return Decoded data.
+ * @return True if the decoded data fit into the maximum size (and the counts of the runs into 64 bits), false otherwise.
  */
-std::vector<std::uint8_t> decode_rle(std::vector<std::uint8_t>::const_iterator first, std::vector<std::uint8_t>::const_iterator last, std::uint8_t marker = DEFAULT_MARKER);
+template<typename Transform>
+bool decode_rle(std::span<const std::uint8_t> data, std::uint8_t marker, std::uint64_t decoded_size, std::vector<std::uint8_t> &result, Transform transform);
 
 
 #endif
@@ -0,0 +1,86 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Runtime statistics of the codec (per-stage timings and per-block statistics) module
+ */
+
+
+#include <iomanip>
+
+#include "stats.h"
+
+
+#ifndef DISABLE_STATS
+thread_local CodecStats *active_stats = NULL;
+#endif
+
+
+void write_stats_json(std::ostream &output, const CodecStats &stats) {
+    const char *stage_names[STAGE_COUNT] = {
+        "io", "model", "rle", "model_rle", "histogram", "tree", "bit_encoding", "bit_decoding", "block_serialization", "channel_transform"
+    };
+    BlockStats total_block_stats;
+    std::uint64_t vertical_block_count = 0;
+    std::uint64_t uncompressed_block_count = 0;
+    std::uint64_t solid_block_count = 0;
+    std::uint64_t rans_block_count = 0;
+    std::uint64_t reused_table_block_count = 0;
+    std::uint64_t dictionary_table_block_count = 0;
+
+    for (const auto &block: stats.blocks) {
+        total_block_stats.table_size += block.table_size;
+        total_block_stats.payload_size += block.payload_size;
+        vertical_block_count += block.is_vertical;
+        uncompressed_block_count += block.is_uncompressed;
+        solid_block_count += block.is_solid;
+        rans_block_count += block.is_rans;
+        reused_table_block_count += block.is_reused_table;
+        dictionary_table_block_count += block.is_dictionary_table;
+    }
+
+    output << std::setprecision(9) << "{" << std::endl;
+
+    for (const auto &[name, value]: stats.values) {
+        output << "  \"" << name << "\": " << value << "," << std::endl;
+    }
+
+    output << "  \"stage_times\": {";
+
+    for (std::uint8_t i = 0; i < STAGE_COUNT; i++) {
+        output << (i > 0 ? ", " : "") << "\"" << stage_names[i] << "\": " << stats.stage_times[i];
+    }
+
+    output << "}," << std::endl;
+    output << "  \"block_summary\": {\"count\": " << stats.blocks.size() << ", \"vertical\": " << vertical_block_count
+        << ", \"uncompressed\": " << uncompressed_block_count << ", \"solid\": " << solid_block_count << ", \"rans\": " << rans_block_count
+        << ", \"reused_table\": " << reused_table_block_count
+        << ", \"dictionary_table\": " << dictionary_table_block_count
+        << ", \"table_bytes\": " << total_block_stats.table_size
+        << ", \"payload_bytes\": " << total_block_stats.payload_size << "}," << std::endl;
+    output << "  \"blocks\": [";
+
+    for (std::uint64_t i = 0; i < stats.blocks.size(); i++) {
+        const auto &block = stats.blocks[i];
+        output << (i > 0 ? "," : "") << std::endl << "    {\"scan\": \"" << (block.is_vertical ? "vertical" : "horizontal")
+            << "\", \"uncompressed\": " << (block.is_uncompressed ? "true" : "false") << ", \"solid\": " << (block.is_solid ? "true" : "false")
+            << ", \"rans\": " << (block.is_rans ? "true" : "false")
+            << ", \"reused_table\": " << (block.is_reused_table ? "true" : "false")
+            << ", \"dictionary_table\": " << (block.is_dictionary_table ? "true" : "false")
+            << ", \"table_bytes\": " << block.table_size
+            << ", \"payload_bytes\": " << block.payload_size << "}";
+    }
+
+    output << (stats.blocks.empty() ? "" : "\n  ") << "]" << std::endl << "}" << std::endl;
+}
+
+
+void merge_stats(CodecStats &stats, const CodecStats &other_stats) {
+    for (std::uint8_t i = 0; i < STAGE_COUNT; i++) {
+        stats.stage_times[i] += other_stats.stage_times[i];
+    }
+
+    stats.blocks.insert(stats.blocks.end(), other_stats.blocks.begin(), other_stats.blocks.end());
+}
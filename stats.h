@@ -0,0 +1,168 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Runtime statistics of the codec (per-stage timings and per-block statistics) interface
+ *
+ * @note The statistics are collected only by the thread whose active statistics are set and only when the program is compiled
+ * without DISABLE_STATS. With DISABLE_STATS defined, all the hooks expand to nothing (or to the measured expression itself).
+ */
+
+
+#ifndef STATS_H
+#define STATS_H
+
+
+#include <vector>
+#include <string>
+#include <span>
+#include <utility>
+#include <ostream>
+#include <chrono>
+#include <cstdint>
+
+
+/**
+ * @brief Stages of the codec whose time is measured.
+ */
+enum CodecStage {
+    STAGE_IO = 0,               // Reading the input and writing the output
+    STAGE_MODEL,                // Adjacent value difference model
+    STAGE_RLE,                  // RLE
+    STAGE_MODEL_RLE,            // Adjacent value difference model fused with the RLE (8-bit samples), not counted in the model and the RLE
+    STAGE_HISTOGRAM,            // Frequencies of the symbols
+    STAGE_TREE,                 // Building (or loading) the Huffman code table
+    STAGE_BIT_ENCODING,         // Huffman encoding of the symbols
+    STAGE_BIT_DECODING,         // Huffman decoding of the symbols
+    STAGE_BLOCK_SERIALIZATION,  // Extraction, transposition and (de)serialization of the blocks
+    STAGE_CHANNEL_TRANSFORM,    // Splitting, merging and color transforms of the channels of the multi-channel data
+    STAGE_COUNT
+};
+
+/**
+ * @brief Statistics of one compressed block.
+ */
+struct BlockStats {
+    bool is_vertical = false;           // The block is scanned vertically
+    bool is_uncompressed = false;       // The block is kept uncompressed
+    bool is_solid = false;              // The block consists of a single repeated sample
+    bool is_rans = false;               // The block is encoded by rANS instead of Huffman encoding
+    bool is_reused_table = false;       // The block is Huffman encoded by the code table of a preceding block
+    bool is_dictionary_table = false;   // The block is Huffman encoded by a code table of the dictionary
+    std::uint64_t table_size = 0;       // The size of the Huffman code table of the block (in bytes)
+    std::uint64_t payload_size = 0;     // The size of the encoded (or uncompressed) values of the block (in bytes)
+};
+
+/**
+ * @brief Statistics of one compression or decompression.
+ */
+struct CodecStats {
+    double stage_times[STAGE_COUNT] = {};                   // The time (in seconds) spent in the individual stages
+    std::vector<BlockStats> blocks;                         // The statistics of the blocks (one block in the static scanning)
+    std::vector<std::pair<std::string, double>> values;     // Additional named values (sizes, total time, pipeline statistics, ...)
+};
+
+
+/**
+ * @brief Write the statistics as a JSON object.
+ *
+ * @param output The output stream
+ * @param stats The statistics
+ */
+void write_stats_json(std::ostream &output, const CodecStats &stats);
+
+/**
+ * @brief Add the stage times and the block statistics of other statistics (e.g. collected by another thread) to the statistics.
+ *
+ * @param stats The statistics to be extended
+ * @param other_stats The added statistics
+ */
+void merge_stats(CodecStats &stats, const CodecStats &other_stats);
+
+
+#ifndef DISABLE_STATS
+
+// The statistics collected by the current thread (NULL if the statistics are not collected)
+extern thread_local CodecStats *active_stats;
+
+
+/**
+ * @brief Measurement of the time spent in the stage from its construction to its destruction.
+ */
+class StageTimer {
+    private:
+        CodecStats *stats;
+        CodecStage stage;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit StageTimer(const CodecStage stage) : stats(active_stats), stage(stage) {
+            if (stats != NULL) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~StageTimer() {
+            if (stats != NULL) {
+                stats->stage_times[stage] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+
+        StageTimer(const StageTimer &) = delete;
+        StageTimer &operator=(const StageTimer &) = delete;
+};
+
+
+/**
+ * @brief Collection of the statistics of the current thread to the given statistics from its construction to its destruction.
+ */
+class StatsRedirection {
+    private:
+        CodecStats *previous_stats;
+
+    public:
+        explicit StatsRedirection(CodecStats *stats) : previous_stats(active_stats) {
+            active_stats = stats;
+        }
+
+        ~StatsRedirection() {
+            active_stats = previous_stats;
+        }
+
+        StatsRedirection(const StatsRedirection &) = delete;
+        StatsRedirection &operator=(const StatsRedirection &) = delete;
+};
+
+
+#define STATS_CONCAT_IMPL(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_IMPL(a, b)
+
+// Measure the time until the end of the current scope
+#define STATS_SCOPE(stage) StageTimer STATS_CONCAT(stage_timer_, __LINE__)(stage)
+
+// Measure the time of the evaluation of the expression and return its value
+#define STATS_MEASURE(stage, ...) [&]() { StageTimer stage_timer(stage); return __VA_ARGS__; }()
+
+// Execute the statement only if the statistics are collected by the current thread
+#define STATS_IF_ACTIVE(...) do { if (active_stats != NULL) { __VA_ARGS__; } } while (false)
+
+// The statistics collected by the current thread (NULL if they are not collected)
+#define STATS_ACTIVE active_stats
+
+// Collect the statistics of the current thread to the given statistics (NULL to stop collecting them) until the end of the current scope
+#define STATS_REDIRECT(stats) StatsRedirection STATS_CONCAT(stats_redirection_, __LINE__)(stats)
+
+#else
+
+#define STATS_SCOPE(stage)
+#define STATS_MEASURE(stage, ...) (__VA_ARGS__)
+#define STATS_IF_ACTIVE(...) do {} while (false)
+#define STATS_ACTIVE static_cast<CodecStats *>(NULL)
+#define STATS_REDIRECT(stats)
+
+#endif
+
+
+#endif
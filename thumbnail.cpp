@@ -0,0 +1,116 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Thumbnails of the images summarizing their square cells by the mean samples module
+ */
+
+
+#include <algorithm>
+
+#include "thumbnail.h"
+#include "channels.h"
+#include "compress.h"
+#include "header.h"
+
+
+/**
+ * @brief Compute the thumbnail of the plane of one channel.
+ *
+ * @param plane The samples of the plane (the 16-bit samples are stored in little endian)
+ * @param width The width of the plane (in samples)
+ * @param sample_size The size of one sample (in bytes)
+ * @param cell_side The side of the cells of the plane summarized by one sample of the thumbnail
+ * @param thumbnail Buffer to which the resulting samples of the thumbnail are appended
+ */
+void compute_plane_thumbnail(
+    std::span<const std::uint8_t> plane,
+    const std::uint64_t width,
+    const std::uint64_t sample_size,
+    const unsigned cell_side,
+    std::vector<std::uint8_t> &thumbnail
+) {
+    const std::uint64_t sample_count = plane.size() / sample_size;
+    const std::uint64_t thumbnail_width = get_thumbnail_width(width, cell_side);
+    std::vector<std::uint64_t> cell_sums(thumbnail_width);
+    std::vector<std::uint64_t> cell_counts(thumbnail_width);
+
+    for (std::uint64_t row_offset = 0, row_index = 0; row_offset < sample_count; row_offset += width, row_index++) {
+        const std::uint64_t row_width = std::min(width, sample_count - row_offset);
+
+        for (std::uint64_t i = 0; i * cell_side < row_width; i++) {
+            const std::uint64_t cell_end = std::min((i + 1) * cell_side, row_width);
+
+            for (std::uint64_t j = i * cell_side; j < cell_end; j++) {
+                const std::uint64_t offset = (row_offset + j) * sample_size;
+                cell_sums[i] += sample_size > 1 ? load_number(plane.data() + offset, 2) : plane[offset];
+            }
+
+            cell_counts[i] += cell_end - i * cell_side;
+        }
+
+        // The row of the cells is complete at its last row or at the end of the plane
+        if ((row_index + 1) % cell_side != 0 && row_offset + width < sample_count) {
+            continue;
+        }
+
+        // Only the cells at the end of the incomplete last row of the plane can be empty
+        for (std::uint64_t i = 0; i < thumbnail_width && cell_counts[i] > 0; i++) {
+            append_number(thumbnail, get_cell_mean(cell_sums[i], cell_counts[i]), sample_size);
+        }
+
+        std::fill(cell_sums.begin(), cell_sums.end(), 0);
+        std::fill(cell_counts.begin(), cell_counts.end(), 0);
+    }
+}
+
+
+std::uint64_t get_thumbnail_width(const std::uint64_t width, const unsigned cell_side) {
+    return width / cell_side + (width % cell_side != 0 ? 1 : 0);
+}
+
+
+std::uint64_t get_thumbnail_pixel_count(const std::uint64_t pixel_count, const std::uint64_t width, const unsigned cell_side) {
+    const std::uint64_t height = pixel_count / width + (pixel_count % width != 0 ? 1 : 0);
+    const std::uint64_t thumbnail_height = height / cell_side + (height % cell_side != 0 ? 1 : 0);
+
+    // The last row of the cells is complete unless it consists only of the incomplete last row of the image
+    if (pixel_count % width == 0 || (height - 1) % cell_side != 0) {
+        return thumbnail_height * get_thumbnail_width(width, cell_side);
+    }
+
+    return (thumbnail_height - 1) * get_thumbnail_width(width, cell_side) + get_thumbnail_width(pixel_count % width, cell_side);
+}
+
+
+void compute_thumbnail(
+    std::span<const std::uint8_t> data,
+    const std::uint64_t width,
+    const unsigned sample_bits,
+    const unsigned channel_count,
+    const bool is_planar,
+    const unsigned cell_side,
+    std::vector<std::uint8_t> &thumbnail
+) {
+    const std::uint64_t sample_size = sample_bits > MAX_BYTE_SAMPLE_BITS ? 2 : 1;
+
+    if (channel_count <= 1) {
+        compute_plane_thumbnail(data, width, sample_size, cell_side, thumbnail);
+        return;
+    }
+
+    // The channels are averaged separately and merged back to the layout of the image
+    std::vector<std::vector<std::uint8_t>> planes;
+    std::vector<std::vector<std::uint8_t>> thumbnail_planes(channel_count);
+    split_channels(data, sample_bits, channel_count, is_planar, COLOR_TRANSFORM_NONE, planes);
+
+    for (unsigned i = 0; i < channel_count; i++) {
+        compute_plane_thumbnail(planes[i], width, sample_size, cell_side, thumbnail_planes[i]);
+    }
+
+    const std::uint64_t thumbnail_offset = thumbnail.size();
+    thumbnail.resize(thumbnail_offset + thumbnail_planes.front().size() * channel_count);
+    merge_channels(thumbnail_planes, sample_bits, is_planar, COLOR_TRANSFORM_NONE, std::span<std::uint8_t>(thumbnail).subspan(thumbnail_offset));
+}
@@ -0,0 +1,86 @@
+/**
+ * VUT FIT KKO - Project - Image data compression using Huffman encoding
+ *
+ * @author Dominik Nejedlý (xnejed09)
+ * @date 18. 10. 2026
+ *
+ * @brief Thumbnails of the images summarizing their square cells by the mean samples interface
+ */
+
+
+#ifndef THUMBNAIL_H
+#define THUMBNAIL_H
+
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+
+// The sides of the cells summarized by one pixel of the thumbnail, i.e. the mean of each block (1/32 scale)
+// or the 4x4 mosaic of the means of each block (1/8 scale)
+#define THUMBNAIL_BLOCK_CELL_SIDE 32
+#define THUMBNAIL_MOSAIC_CELL_SIDE 8
+
+
+/**
+ * @brief Get the mean sample of the cell rounded to the nearest integer.
+ *
+ * @param sum The sum of the samples of the cell
+ * @param count The number of the samples of the cell (at least one)
+ *
+ * @return The mean sample.
+ */
+inline std::uint64_t get_cell_mean(const std::uint64_t sum, const std::uint64_t count) {
+    return (sum + count / 2) / count;
+}
+
+
+/**
+ * @brief Get the width of the thumbnail of the image.
+ *
+ * @param width The width of the image
+ * @param cell_side The side of the cells of the image summarized by one pixel of the thumbnail
+ *
+ * @return The width of the thumbnail.
+ */
+std::uint64_t get_thumbnail_width(const std::uint64_t width, const unsigned cell_side);
+
+/**
+ * @brief Get the number of the pixels of the thumbnail of the image.
+ *
+ * @param pixel_count The number of the pixels of the image
+ * @param width The width of the image (at least one pixel)
+ * @param cell_side The side of the cells of the image summarized by one pixel of the thumbnail
+ *
+ * @return The number of the pixels of the thumbnail.
+ */
+std::uint64_t get_thumbnail_pixel_count(const std::uint64_t pixel_count, const std::uint64_t width, const unsigned cell_side);
+
+/**
+ * @brief Compute the thumbnail of the image, each pixel of which is the mean of the pixels of one cell of the image.
+ *
+ * @note The cells at the right and the bottom edge of the image (including its incomplete last row) are averaged over the pixels
+ * they contain and the cells containing no pixel are omitted, so the thumbnail also ends by an incomplete row if the image does.
+ * The channels are averaged without the color transform and the thumbnail has the same layout of the channels as the image.
+ *
+ * @param data The image (its size has to be a multiple of the size of one pixel)
+ * @param width The width of the image (in pixels)
+ * @param sample_bits The width of the samples (in bits)
+ * @param channel_count The number of channels
+ * @param is_planar Indicates whether the channels are stored one after another (planar layout) instead of pixel by pixel (interleaved layout)
+ * @param cell_side The side of the cells of the image summarized by one pixel of the thumbnail
+ * @param thumbnail The resulting thumbnail
+ */
+void compute_thumbnail(
+    std::span<const std::uint8_t> data,
+    const std::uint64_t width,
+    const unsigned sample_bits,
+    const unsigned channel_count,
+    const bool is_planar,
+    const unsigned cell_side,
+    std::vector<std::uint8_t> &thumbnail
+);
+
+
+#endif